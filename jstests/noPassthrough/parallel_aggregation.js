@@ -0,0 +1,55 @@
+// Tests that an aggregation whose collection scan and $group are split across several threads
+// returns the same results as one run on a single thread.
+// @tags: [requires_wiredtiger]
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {internalQueryParallelAggWorkers: 4, internalQueryParallelAggMinRecords: 0}
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.parallel_aggregation;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; ++i) {
+        bulk.insert({a: i % 17, b: i, c: [i % 3, i % 5]});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipelines = [
+        [{$group: {_id: null, count: {$sum: 1}}}],
+        [{$group: {_id: "$a", total: {$sum: "$b"}, avg: {$avg: "$b"}, max: {$max: "$b"}}}],
+        [
+          {$match: {b: {$gte: 1000}}},
+          {$unwind: "$c"},
+          {$addFields: {d: {$mod: ["$b", 7]}}},
+          {$group: {_id: {a: "$a", c: "$c"}, ds: {$addToSet: "$d"}, n: {$sum: 1}}},
+          {$sort: {_id: 1}}
+        ],
+    ];
+
+    function runAll() {
+        return pipelines.map(pipeline => {
+            const results = coll.aggregate(pipeline).toArray();
+            return results.sort((x, y) => bsonWoCompare(x, y)).map(doc => {
+                if (doc.ds) {
+                    doc.ds.sort();
+                }
+                return doc;
+            });
+        });
+    }
+
+    const parallelResults = runAll();
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryParallelAggWorkers: 1}));
+    const serialResults = runAll();
+
+    assert.eq(serialResults, parallelResults);
+    assert.eq(10000, parallelResults[0][0].count);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,62 @@
+/**
+ * Tests that a node started with initialSyncMethod "fileCopy" copies its sync source's data files
+ * at startup, and then joins the set as a secondary without a logical initial sync.
+ *
+ * @tags: [requires_persistence, requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/check_log.js");
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB("test").initial_sync_file_copy;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, x: i % 10});
+    }
+    assert.writeOK(bulk.execute({w: "majority"}));
+    assert.commandWorked(coll.createIndex({x: 1}));
+
+    // Take a checkpoint for the backup to copy, then write past it so that the new node has to
+    // replay the copied oplog from the checkpoint timestamp.
+    assert.commandWorked(primary.adminCommand({fsync: 1}));
+    assert.writeOK(coll.insert({_id: "afterCheckpoint"}, {writeConcern: {w: "majority"}}));
+
+    const secondary = rst.add({
+        rsConfig: {priority: 0},
+        setParameter: {
+            initialSyncMethod: "fileCopy",
+            initialSyncFileCopySource: primary.host,
+            numInitialSyncAttempts: 1
+        }
+    });
+    checkLog.contains(secondary, "Finished file copy initial sync from " + primary.host);
+    checkLog.contains(secondary, "Replaced the sync source's local documents");
+
+    rst.reInitiate();
+    rst.awaitSecondaryNodes();
+    assert.writeOK(coll.insert({_id: "afterJoin"}, {writeConcern: {w: 2}}));
+
+    const secondaryColl = secondary.getDB("test").initial_sync_file_copy;
+    secondary.setSlaveOk();
+    assert.eq(1002, secondaryColl.find().itcount());
+    assert.eq(100, secondaryColl.find({x: 3}).hint({x: 1}).itcount());
+
+    // The sync source's vote in the election that made it primary was not kept.
+    assert.eq(null, secondary.getDB("local").replset.election.findOne());
+
+    // The data arrived through the copied files rather than a logical initial sync.
+    const metrics = assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics;
+    assert.eq(0, metrics.repl.initialSync.completed, tojson(metrics.repl.initialSync));
+
+    // The sync source closed the backup once the copy was done, so a new one can be opened.
+    const res = assert.commandWorked(primary.adminCommand({_beginFileCopyBackup: 1}));
+    assert.commandWorked(primary.adminCommand({_endFileCopyBackup: res.backupId}));
+
+    rst.stopSet();
+})();
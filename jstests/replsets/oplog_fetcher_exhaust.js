@@ -0,0 +1,98 @@
+/**
+ * Tests that a secondary which reads its sync source's oplog over an exhaust cursor keeps up with
+ * the primary and keeps learning about the advancing commit point, that the sync source streams
+ * batches without being asked for each one, and that a full oplog buffer stops the stream.
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({
+        nodes: [{}, {rsConfig: {priority: 0}}],
+        // The oplog must hold everything the secondary falls behind by while its buffer is full.
+        oplogSize: 1024,
+        nodeOptions: {setParameter: {oplogFetcherUsesExhaust: true}}
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    const coll = primary.getDB("test").oplog_fetcher_exhaust;
+
+    function getNetworkMetrics() {
+        return assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics.repl.network;
+    }
+
+    // Majority writes only succeed if the secondary keeps reporting its progress while the
+    // sync source streams batches to it.
+    const before = getNetworkMetrics();
+    for (let i = 0; i < 10; i++) {
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let j = 0; j < 100; j++) {
+            bulk.insert({_id: i * 100 + j});
+        }
+        assert.writeOK(bulk.execute({w: "majority"}));
+    }
+    rst.awaitReplication();
+    assert.eq(1000, secondary.getDB("test").oplog_fetcher_exhaust.find().itcount());
+
+    // The secondary learns about the commit point from the streamed replies.
+    const primaryStatus = assert.commandWorked(primary.adminCommand({replSetGetStatus: 1}));
+    const primaryCommitPoint = primaryStatus.optimes.lastCommittedOpTime;
+    assert.soon(() => {
+        const status = assert.commandWorked(secondary.adminCommand({replSetGetStatus: 1}));
+        return rs.compareOpTimes(status.optimes.lastCommittedOpTime, primaryCommitPoint) >= 0;
+    });
+
+    // Each majority write reached the secondary in its own batch, but the secondary asked for at
+    // most the first ones. The rest were streamed by the sync source.
+    const after = getNetworkMetrics();
+    assert.gte(after.ops - before.ops, 1000, tojson(after));
+    assert.lte(after.exhaust.requests - before.exhaust.requests, 2, tojson({before, after}));
+    assert.gte(after.exhaust.streamedBatches - before.exhaust.streamedBatches,
+               10,
+               tojson({before, after}));
+
+    // Stop the secondary from applying, so that nothing takes operations out of its oplog buffer,
+    // and write more than the buffer holds.
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: "rsSyncApplyStop", mode: "alwaysOn"}));
+
+    const bufferMaxSizeBytes = assert.commandWorked(secondary.adminCommand({serverStatus: 1}))
+                                   .metrics.repl.buffer.maxSizeBytes;
+    const docSizeBytes = 4 * 1024 * 1024;
+    const bigString = "x".repeat(docSizeBytes);
+    const numBigDocs = Math.ceil(bufferMaxSizeBytes / docSizeBytes) + 8;
+    for (let i = 0; i < numBigDocs; i++) {
+        assert.writeOK(coll.insert({_id: "big" + i, big: bigString}));
+    }
+
+    assert.soon(() => {
+        const buffer =
+            assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics.repl.buffer;
+        return buffer.sizeBytes + docSizeBytes > buffer.maxSizeBytes;
+    }, "secondary did not fill its oplog buffer");
+
+    // With the buffer full the secondary stops reading the stream, which holds back the sync
+    // source. No more operations arrive and the secondary does not ask for them either.
+    sleep(1000);
+    const full = getNetworkMetrics();
+    sleep(3000);
+    const stalled = getNetworkMetrics();
+    assert.eq(stalled.ops, full.ops, tojson({full, stalled}));
+    assert.lt(stalled.ops - after.ops, numBigDocs, tojson({after, stalled}));
+    assert.eq(stalled.exhaust.requests, full.exhaust.requests, tojson({full, stalled}));
+
+    // Once the secondary applies again, the same stream delivers the rest of the operations.
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: "rsSyncApplyStop", mode: "off"}));
+    rst.awaitReplication();
+    assert.eq(numBigDocs, secondary.getDB("test").oplog_fetcher_exhaust.find({
+        _id: {$regex: /^big/}
+    }).itcount());
+    assert.eq(getNetworkMetrics().exhaust.requests,
+              full.exhaust.requests,
+              "the oplog exhaust stream was restarted");
+
+    rst.stopSet();
+})();
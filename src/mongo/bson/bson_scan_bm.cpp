@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/text.h"
+
+namespace mongo {
+namespace {
+
+// A document with 'numFields' small fields whose names are typical of real schemas.
+BSONObj makeWideDocument(int64_t numFields) {
+    BSONObjBuilder builder;
+    for (int64_t i = 0; i < numFields; i++) {
+        builder.append("someFieldName" + std::to_string(i), static_cast<int>(i));
+    }
+    return builder.obj();
+}
+
+// A document with a few string fields of 'stringLength' bytes each.
+BSONObj makeStringDocument(int64_t stringLength, char fill) {
+    const std::string value(stringLength, fill);
+    BSONObjBuilder builder;
+    for (int i = 0; i < 4; i++) {
+        builder.append("field" + std::to_string(i), value);
+    }
+    return builder.obj();
+}
+
+void BM_validateWideDocument(benchmark::State& state) {
+    const BSONObj obj = makeWideDocument(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+void BM_validateStringDocument(benchmark::State& state) {
+    const BSONObj obj = makeStringDocument(state.range(0), 'a');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+void BM_iterateWideDocument(benchmark::State& state) {
+    const BSONObj obj = makeWideDocument(state.range(0));
+    for (auto _ : state) {
+        size_t total = 0;
+        for (BSONObjIterator it(obj); it.more();) {
+            total += it.next().fieldNameSize();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_getLastField(benchmark::State& state) {
+    const BSONObj obj = makeWideDocument(state.range(0));
+    const std::string lastField = "someFieldName" + std::to_string(state.range(0) - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(obj.getField(lastField));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_isValidUTF8Ascii(benchmark::State& state) {
+    const std::string str(state.range(0), 'a');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(isValidUTF8(str));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+void BM_isValidUTF8Mixed(benchmark::State& state) {
+    // Mostly ASCII with a two byte sequence every 32 bytes, like accented text.
+    std::string str;
+    while (static_cast<int64_t>(str.size()) < state.range(0)) {
+        str += std::string(30, 'a') + "\xC3\xA9";
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(isValidUTF8(str));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+BENCHMARK(BM_validateWideDocument)->Ranges({{{1}, {1'000}}});
+BENCHMARK(BM_validateStringDocument)->Ranges({{{16}, {64 * 1024}}});
+BENCHMARK(BM_iterateWideDocument)->Ranges({{{1}, {1'000}}});
+BENCHMARK(BM_getLastField)->Ranges({{{1}, {1'000}}});
+BENCHMARK(BM_isValidUTF8Ascii)->Ranges({{{16}, {64 * 1024}}});
+BENCHMARK(BM_isValidUTF8Mixed)->Ranges({{{16}, {64 * 1024}}});
+
+}  // namespace
+}  // namespace mongo
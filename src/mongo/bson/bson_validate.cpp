@@ -38,6 +38,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/platform/decimal128.h"
+#include "mongo/platform/simd_scan.h"
 
 namespace mongo {
 
@@ -89,10 +90,10 @@ public:
      * reading, if it exists. Otherwise, it should be empty.
      */
     Status readCString(StringData elemName, StringData* out) {
-        const void* x = memchr(_buffer + _position, 0, _maxLength - _position);
+        const char* x = simd_scan::findNul(_buffer + _position, _buffer + _maxLength);
         if (!x)
             return makeError("no end of c-string", _idElem, elemName);
-        uint64_t len = static_cast<uint64_t>(static_cast<const char*>(x) - (_buffer + _position));
+        uint64_t len = static_cast<uint64_t>(x - (_buffer + _position));
 
         StringData data(_buffer + _position, len);
         _position += len + 1;
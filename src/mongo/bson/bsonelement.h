@@ -45,6 +45,7 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/config.h"
 #include "mongo/platform/decimal128.h"
+#include "mongo/platform/simd_scan.h"
 #include "mongo/platform/strnlen.h"
 
 namespace mongo {
@@ -675,7 +676,8 @@ public:
             fieldNameSize_ = 0;
             totalSize = 1;
         } else {
-            fieldNameSize_ = strlen(d + 1 /*skip type*/) + 1 /*include NUL byte*/;
+            fieldNameSize_ =
+                simd_scan::cstringLength(d + 1 /*skip type*/) + 1 /*include NUL byte*/;
             totalSize = computeSize();
         }
     }
@@ -693,7 +695,8 @@ public:
             this->totalSize = 1;
         } else {
             if (fieldNameSize == -1) {
-                fieldNameSize_ = strlen(d + 1 /*skip type*/) + 1 /*include NUL byte*/;
+                fieldNameSize_ =
+                    simd_scan::cstringLength(d + 1 /*skip type*/) + 1 /*include NUL byte*/;
             } else {
                 fieldNameSize_ = fieldNameSize;
             }
@@ -50,6 +50,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_access_method_gen.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_legacy.h"
 #include "mongo/db/index_names.h"
@@ -1159,6 +1160,18 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    // Batches of documents, such as the grouped inserts applied by secondaries, have the keys of
+    // all documents inserted in index order in one pass.
+    if (bsonRecords.size() > 1 && !index->isHybridBuilding() &&
+        indexGroupedInsertsInKeyOrder.load()) {
+        InsertResult result;
+        Status status = index->accessMethod()->insertRecords(opCtx, bsonRecords, options, &result);
+        if (keysInsertedOut) {
+            *keysInsertedOut += result.numInserted;
+        }
+        return status;
+    }
+
     for (auto bsonRecord : bsonRecords) {
         invariant(bsonRecord.id != RecordId());
 
@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/multi_index_block.h"
 
+#include <algorithm>
 #include <ostream>
 
 #include "mongo/base/error_codes.h"
@@ -53,10 +54,13 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logger/redaction.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/scopeguard.h"
@@ -71,6 +75,32 @@ const StringData kBuildingPhaseCompleteFieldName = "buildingPhaseComplete"_sd;
 const StringData kRunTwoPhaseIndexBuildFieldName = "runTwoPhaseIndexBuild"_sd;
 const StringData kCommitReadyMembersFieldName = "commitReadyMembers"_sd;
 
+// Smaller collections are scanned on the building thread even when maxIndexBuildScanThreads
+// allows more.
+const long long kMinRecordsForParallelScan = 10000;
+
+// How many records a parallel scan worker reads between checks for an aborted build.
+const unsigned kRecordsBetweenAbortChecks = 128;
+
+/**
+ * Returns the thread pool that runs the scan workers of every foreground index build, which
+ * bounds the number of threads they use across the server. The workers read under the lock of the
+ * build that scheduled them and never wait for anything, so a busy pool only delays them.
+ */
+ThreadPool* getIndexBuildScanPool() {
+    // Never destroyed, since workers may still be running on it at shutdown.
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "indexBuildScan";
+        options.minThreads = 0;
+        options.maxThreads = std::max(1UL, ProcessInfo::getNumAvailableCores());
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
 }  // namespace
 
 MONGO_FAIL_POINT_DEFINE(crashAfterStartingIndexBuild);
@@ -283,6 +313,7 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(OperationContext* opCtx,
             static_cast<std::size_t>(maxIndexBuildMemoryUsageMegabytes.load()) * 1024 * 1024 /
             indexSpecs.size();
     }
+    _eachIndexBuildMaxMemoryUsageBytes = eachIndexBuildMaxMemoryUsageBytes;
 
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
@@ -367,6 +398,33 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(OperationContext* opCtx,
     return indexInfoObjs;
 }
 
+/**
+ * Releases all locks and hangs while the hangAfterStartingIndexBuildUnlocked failpoint is set. A
+ * background build then fails, while a foreground build can't go on without its locks.
+ */
+Status hangAfterScanIfRequested(OperationContext* opCtx, bool isBackgroundBuilding) {
+    if (MONGO_FAIL_POINT(hangAfterStartingIndexBuildUnlocked)) {
+        // Unlock before hanging so replication recognizes we've completed.
+        Locker::LockSnapshot lockInfo;
+        invariant(opCtx->lockState()->saveLockStateAndUnlock(&lockInfo));
+
+        log() << "Hanging index build with no locks due to "
+                 "'hangAfterStartingIndexBuildUnlocked' failpoint";
+        MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangAfterStartingIndexBuildUnlocked);
+
+        if (isBackgroundBuilding) {
+            opCtx->lockState()->restoreLockState(opCtx, lockInfo);
+            opCtx->recoveryUnit()->abandonSnapshot();
+            return Status(ErrorCodes::OperationFailed,
+                          "background index build aborted due to failpoint");
+        } else {
+            invariant(
+                !"the hangAfterStartingIndexBuildUnlocked failpoint can't be turned off for foreground index builds");
+        }
+    }
+    return Status::OK();
+}
+
 void failPointHangDuringBuild(FailPoint* fp, StringData where, const BSONObj& doc) {
     MONGO_FAIL_POINT_BLOCK(*fp, data) {
         int i = doc.getIntField("i");
@@ -408,6 +466,36 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
 
     unsigned long long n = 0;
 
+    // A build which keeps writers out of the collection for the whole scan may split the scan and
+    // the key generation across threads.
+    const size_t numScanThreads = maxIndexBuildScanThreads.load();
+    if (numScanThreads > 1 && _method == IndexBuildMethod::kForeground &&
+        insertsIntoBulkBuilders() && numRecords >= kMinRecordsForParallelScan &&
+        opCtx->lockState()->isCollectionLockedForMode(collection->ns().ns(), MODE_S) &&
+        !MONGO_FAIL_POINT(hangAfterStartingIndexBuild) &&
+        !MONGO_FAIL_POINT(hangBeforeIndexBuildOf) && !MONGO_FAIL_POINT(hangAfterIndexBuildOf)) {
+        const auto boundaries =
+            collection->getRecordStore()->sampleRangeBoundaries(opCtx, numScanThreads);
+        if (!boundaries.empty()) {
+            Status status = _scanCollectionInParallel(opCtx, collection, boundaries, &progress, &n);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            status = hangAfterScanIfRequested(opCtx, isBackgroundBuilding());
+            if (!status.isOK()) {
+                return status;
+            }
+
+            progress->finished();
+
+            log() << "index build: collection scan done. scanned " << n << " total records on "
+                  << boundaries.size() + 1 << " threads in " << t.seconds() << " seconds";
+
+            return dumpInsertsFromBulk(opCtx);
+        }
+    }
+
     PlanExecutor::YieldPolicy yieldPolicy;
     if (isBackgroundBuilding()) {
         yieldPolicy = PlanExecutor::YIELD_AUTO;
@@ -504,24 +592,9 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
         return exec->getMemberObjectStatus(objToIndex.value());
     }
 
-    if (MONGO_FAIL_POINT(hangAfterStartingIndexBuildUnlocked)) {
-        // Unlock before hanging so replication recognizes we've completed.
-        Locker::LockSnapshot lockInfo;
-        invariant(opCtx->lockState()->saveLockStateAndUnlock(&lockInfo));
-
-        log() << "Hanging index build with no locks due to "
-                 "'hangAfterStartingIndexBuildUnlocked' failpoint";
-        MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangAfterStartingIndexBuildUnlocked);
-
-        if (isBackgroundBuilding()) {
-            opCtx->lockState()->restoreLockState(opCtx, lockInfo);
-            opCtx->recoveryUnit()->abandonSnapshot();
-            return Status(ErrorCodes::OperationFailed,
-                          "background index build aborted due to failpoint");
-        } else {
-            invariant(
-                !"the hangAfterStartingIndexBuildUnlocked failpoint can't be turned off for foreground index builds");
-        }
+    Status hangStatus = hangAfterScanIfRequested(opCtx, isBackgroundBuilding());
+    if (!hangStatus.isOK()) {
+        return hangStatus;
     }
 
     progress->finished();
@@ -536,6 +609,144 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status MultiIndexBlock::_scanCollectionInParallel(OperationContext* opCtx,
+                                                  Collection* collection,
+                                                  const std::vector<RecordId>& boundaries,
+                                                  ProgressMeterHolder* progress,
+                                                  unsigned long long* numScanned) {
+    const size_t numRanges = boundaries.size() + 1;
+    const bool readOnce = useReadOnceCursorsForIndexBuilds.load();
+
+    // Every range gets its own BulkBuilder for each index, so that the workers share nothing but
+    // the read-only index and collection state. They split the memory budget of the index.
+    std::vector<std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>> rangeBulks(
+        numRanges);
+    for (auto& bulks : rangeBulks) {
+        for (auto& index : _indexes) {
+            bulks.push_back(
+                index.real->initiateBulk(_eachIndexBuildMaxMemoryUsageBytes / numRanges));
+        }
+    }
+
+    stdx::mutex mutex;
+    stdx::condition_variable workerFinished;
+    size_t numActiveWorkers = 0;
+    Status workerStatus = Status::OK();
+    AtomicWord<bool> stopWorkers{false};
+    AtomicWord<unsigned long long> scanned{0};
+
+    auto scanRange = [&](OperationContext* workerOpCtx, size_t rangeIndex) {
+        auto& bulks = rangeBulks[rangeIndex];
+        auto cursor = collection->getRecordStore()->getCursor(workerOpCtx);
+        auto record =
+            rangeIndex == 0 ? cursor->next() : cursor->seekNear(boundaries[rangeIndex - 1]);
+        for (unsigned numRead = 0; record; record = cursor->next(), ++numRead) {
+            if (rangeIndex < boundaries.size() && record->id >= boundaries[rangeIndex]) {
+                break;
+            }
+            if (stopWorkers.load()) {
+                return;
+            }
+            // Like insert(), stop as soon as the build is aborted rather than after the scan.
+            if (numRead % kRecordsBetweenAbortChecks == 0 && State::kAborted == _getState()) {
+                uasserted(ErrorCodes::IndexBuildAborted,
+                          str::stream() << "Index build aborted: " << _abortReason);
+            }
+
+            const BSONObj doc = record->data.toBson();
+            for (size_t i = 0; i < _indexes.size(); i++) {
+                if (_indexes[i].filterExpression &&
+                    !_indexes[i].filterExpression->matchesBSON(doc)) {
+                    continue;
+                }
+                uassertStatusOK(
+                    bulks[i]->insert(workerOpCtx, doc, record->id, _indexes[i].options));
+            }
+            scanned.fetchAndAdd(1);
+        }
+    };
+
+    auto runWorker = [&, serviceContext = opCtx->getServiceContext() ](size_t rangeIndex) {
+        ThreadClient tc(str::stream() << "indexBuildScan-" << rangeIndex, serviceContext);
+        auto workerOpCtx = cc().makeOperationContext();
+        workerOpCtx->recoveryUnit()->setReadOnce(readOnce);
+
+        Status status = Status::OK();
+        try {
+            scanRange(workerOpCtx.get(), rangeIndex);
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (!status.isOK() && workerStatus.isOK()) {
+            workerStatus = status;
+            stopWorkers.store(true);
+        }
+        --numActiveWorkers;
+        workerFinished.notify_all();
+    };
+
+    // The workers refer to state on this stack frame, so every scheduled worker must finish
+    // before this function returns, including workers which are still queued.
+    auto waitForWorkers = [&] {
+        stopWorkers.store(true);
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        workerFinished.wait(lk, [&] { return numActiveWorkers == 0; });
+    };
+    ON_BLOCK_EXIT(waitForWorkers);
+    for (size_t rangeIndex = 0; rangeIndex < numRanges; ++rangeIndex) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ++numActiveWorkers;
+        }
+        auto status =
+            getIndexBuildScanPool()->schedule([&runWorker, rangeIndex] { runWorker(rangeIndex); });
+        if (!status.isOK()) {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            --numActiveWorkers;
+            if (workerStatus.isOK()) {
+                workerStatus = status;
+            }
+            break;
+        }
+    }
+
+    // Wait for the workers, reporting their progress and stopping them if this operation is
+    // interrupted.
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        unsigned long long reported = 0;
+        while (numActiveWorkers > 0 && workerStatus.isOK()) {
+            auto waitStatus = opCtx->waitForConditionOrInterruptNoAssertUntil(
+                workerFinished, lk, Date_t::now() + Seconds(1));
+            if (!waitStatus.isOK()) {
+                workerStatus = waitStatus.getStatus();
+                break;
+            }
+
+            const auto nowScanned = scanned.load();
+            progress->hit(static_cast<int>(nowScanned - reported));
+            reported = nowScanned;
+        }
+    }
+
+    waitForWorkers();
+
+    if (!workerStatus.isOK()) {
+        return workerStatus;
+    }
+
+    for (auto& bulks : rangeBulks) {
+        for (size_t i = 0; i < _indexes.size(); i++) {
+            _indexes[i].bulk->absorb(std::move(bulks[i]));
+        }
+    }
+
+    *numScanned = scanned.load();
+    return Status::OK();
+}
+
 Status MultiIndexBlock::insert(OperationContext* opCtx, const BSONObj& doc, const RecordId& loc) {
     if (State::kAborted == _getState()) {
         return {ErrorCodes::IndexBuildAborted,
@@ -775,6 +986,12 @@ bool MultiIndexBlock::isBackgroundBuilding() const {
     return _method == IndexBuildMethod::kBackground || _method == IndexBuildMethod::kHybrid;
 }
 
+bool MultiIndexBlock::insertsIntoBulkBuilders() const {
+    return std::all_of(_indexes.begin(), _indexes.end(), [](const IndexToBuild& index) {
+        return static_cast<bool>(index.bulk);
+    });
+}
+
 MultiIndexBlock::State MultiIndexBlock::getState_forTest() const {
     return _getState();
 }
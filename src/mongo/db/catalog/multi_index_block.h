@@ -52,6 +52,7 @@ namespace mongo {
 class Collection;
 class MatchExpression;
 class OperationContext;
+class ProgressMeterHolder;
 
 /**
  * Builds one or more indexes.
@@ -268,6 +269,13 @@ public:
      */
     bool isBackgroundBuilding() const;
 
+    /**
+     * Returns true if every index in this build block collects its keys in a bulk builder. In that
+     * case insert() only generates keys into the external sorters and does not write to storage,
+     * so it may be called from a thread other than the owning one, one thread at a time.
+     */
+    bool insertsIntoBulkBuilders() const;
+
     /**
      * State transitions:
      *
@@ -302,6 +310,19 @@ private:
     Status _dumpInsertsFromBulk(std::set<RecordId>* dupRecords,
                                 std::vector<BSONObj>* dupKeysInserted);
 
+    /**
+     * Scans 'collection' on one thread for each of the ranges of RecordIds into which 'boundaries'
+     * splits it, generating keys into a BulkBuilder per index and thread, then hands all of those
+     * keys to the BulkBuilders in '_indexes'. The workers take no locks of their own, so this may
+     * only be used by a build which holds a lock on 'collection' that keeps out writers for the
+     * whole scan. Sets '*numScanned' to the number of records scanned.
+     */
+    Status _scanCollectionInParallel(OperationContext* opCtx,
+                                     Collection* collection,
+                                     const std::vector<RecordId>& boundaries,
+                                     ProgressMeterHolder* progress,
+                                     unsigned long long* numScanned);
+
     /**
      * Returns the current state.
      */
@@ -327,6 +348,9 @@ private:
 
     std::vector<IndexToBuild> _indexes;
 
+    // The memory the BulkBuilder of each index may use before spilling to disk.
+    std::size_t _eachIndexBuildMaxMemoryUsageBytes = 0;
+
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
 
     IndexBuildMethod _method = IndexBuildMethod::kHybrid;
@@ -55,6 +55,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/speculative_majority_read_info.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
@@ -74,6 +75,21 @@ MONGO_FAIL_POINT_DEFINE(rsStopGetMoreCmd);
 // The timeout when waiting for linearizable read concern on a getMore command.
 static constexpr int kLinearizableReadConcernTimeout = 15000;
 
+// The most result bytes a getMore puts in one reply of an exhaust stream. The next reply follows
+// as soon as this one has been written to the socket, so smaller chunks reach the client sooner
+// and bound how much of a batch the server holds at once, at the cost of more replies.
+MONGO_EXPORT_SERVER_PARAMETER(streamedReplyChunkSizeBytes, int, 1024 * 1024)
+    ->withValidator([](const int& value) {
+        return (value > 0 && value <= FindCommon::kMaxBytesToReturnToClientAtOnce)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream() << "streamedReplyChunkSizeBytes must be between 1 and "
+                                   << FindCommon::kMaxBytesToReturnToClientAtOnce
+                                   << ". '"
+                                   << value
+                                   << "' is an invalid setting.");
+    });
+
 /**
  * Validates that the lsid of 'opCtx' matches that of 'cursor'. This must be called after
  * authenticating, so that it is safe to report the lsid of 'cursor'.
@@ -217,6 +233,13 @@ public:
                              std::uint64_t* numResults) {
             PlanExecutor* exec = cursor->getExecutor();
 
+            // In an exhaust stream, a large batch goes out in chunks so that the client can start
+            // on it while the rest is produced. Writing each chunk to the socket before producing
+            // the next one provides the back-pressure.
+            const int maxBatchBytes = replyIsStreamed(opCtx)
+                ? streamedReplyChunkSizeBytes.load()
+                : FindCommon::kMaxBytesToReturnToClientAtOnce;
+
             // If an awaitData getMore is killed during this process due to our max time expiring at
             // an interrupt point, we just continue as normal and return rather than reporting a
             // timeout to the user.
@@ -226,7 +249,8 @@ public:
                        PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
                     // If adding this object will cause us to exceed the message size limit, then we
                     // stash it for later.
-                    if (!FindCommon::haveSpaceForNext(obj, *numResults, nextBatch->bytesUsed())) {
+                    if (!FindCommon::haveSpaceForNext(
+                            obj, *numResults, nextBatch->bytesUsed(), maxBatchBytes)) {
                         exec->enqueue(obj);
                         break;
                     }
@@ -101,6 +101,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database_and_check_version.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
+#include "mongo/db/repl/file_copy_initial_sync.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_consistency_markers_impl.h"
@@ -325,6 +326,16 @@ ExitCode _initAndListen(int listenPort) {
     runner->startup();
     serviceContext->setPeriodicRunner(std::move(runner));
 
+    // File copy initial sync has to install its files before the storage engine opens the dbpath.
+    // Failures that leave the dbpath untouched fall back to logical initial sync; the others are
+    // fatal.
+    if (!storageGlobalParams.repair) {
+        auto status = repl::runFileCopyInitialSync(serviceContext);
+        if (!status.isOK()) {
+            warning() << status << "; falling back to logical initial sync";
+        }
+    }
+
     initializeStorageEngine(serviceContext, StorageEngineInitFlags::kNone);
 
 #ifdef MONGO_CONFIG_WIREDTIGER_ENABLED
@@ -407,6 +418,9 @@ ExitCode _initAndListen(int listenPort) {
 
     auto startupOpCtx = serviceContext->makeOperationContext(&cc());
 
+    // Replaces what the local database copied by file copy initial sync says about the sync source.
+    repl::finishFileCopyInitialSync(startupOpCtx.get());
+
     bool canCallFCVSetIfCleanStartup =
         !storageGlobalParams.readOnly && (storageGlobalParams.engine != "devnull");
     if (canCallFCVSetIfCleanStartup && !replSettings.usingReplSets()) {
@@ -39,6 +39,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
@@ -68,6 +69,12 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     _specificStats.direction = params.direction;
     _specificStats.maxTs = params.maxTs;
     invariant(!_params.shouldTrackLatestOplogTimestamp || collection->ns().isOplog());
+    invariant((!_params.minRecord && !_params.maxRecord) ||
+              _params.direction == CollectionScanParams::FORWARD);
+
+    if (_filter && internalQueryExecCompileCollScanFilter.load()) {
+        _compiledFilter = CompiledMatchExpression::compile(_filter);
+    }
 
     if (params.maxTs) {
         _endConditionBSON = BSON("$gte" << *(params.maxTs));
@@ -106,6 +113,13 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
             _cursor = collection()->getCursor(getOpCtx(), forward);
 
+            // A tailable scan spends its time waiting at the end of the collection, where there
+            // is nothing to read ahead.
+            const int prefetchDepth = internalQueryCollScanPrefetchDepth.load();
+            if (prefetchDepth > 0 && !_params.tailable) {
+                _cursor->setReadAhead(internalQueryCollScanPrefetchBatchSize.load(), prefetchDepth);
+            }
+
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
                 // Seek to where we were last time. If it no longer exists, mark us as dead since we
@@ -130,6 +144,8 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
         if (_lastSeenId.isNull() && !_params.start.isNull()) {
             record = _cursor->seekExact(_params.start);
+        } else if (_lastSeenId.isNull() && _params.minRecord) {
+            record = _cursor->seekNear(*_params.minRecord);
         } else {
             record = _cursor->next();
         }
@@ -154,6 +170,11 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_params.maxRecord && record->id >= *_params.maxRecord) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
     _lastSeenId = record->id;
     if (_params.shouldTrackLatestOplogTimestamp) {
         auto status = setLatestOplogEntryTimestamp(*record);
@@ -190,9 +211,12 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    const bool passes = _compiledFilter ? _compiledFilter->matches(member->obj.value())
+                                        : Filter::passes(member, _filter);
+    if (passes) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
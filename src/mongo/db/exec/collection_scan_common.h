@@ -45,6 +45,12 @@ struct CollectionScanParams {
     // The RecordId to which we should seek to as the first document of the scan.
     RecordId start;
 
+    // If set, a forward scan starts at the first record at or after 'minRecord', which need not
+    // exist, and stops before the first record at or after 'maxRecord'. Used to split a scan into
+    // disjoint ranges.
+    boost::optional<RecordId> minRecord;
+    boost::optional<RecordId> maxRecord;
+
     // If present, the collection scan will stop and return EOF the first time it sees a document
     // that does not pass the filter and has 'ts' greater than 'maxTs'.
     boost::optional<Timestamp> maxTs;
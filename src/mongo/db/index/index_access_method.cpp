@@ -33,9 +33,11 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -47,6 +49,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/timestamp_block.h"
@@ -199,6 +202,7 @@ Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
                                              const InsertDeleteOptions& options,
                                              InsertResult* result) {
     bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
+    auto inserter = _newInterface->makeInserter(opCtx);
 
     // Add all new data keys, and all new multikey metadata keys, into the index. When iterating
     // over the data keys, each of them should point to the doc's RecordId. When iterating over
@@ -206,33 +210,9 @@ Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
     for (const auto keySet : {&keys, &multikeyMetadataKeys}) {
         const auto& recordId = (keySet == &keys ? loc : kMultikeyMetadataKeyId);
         for (const auto& key : *keySet) {
-            Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
-            if (status.isOK()) {
-                bool unique = _descriptor->unique();
-                StatusWith<SpecialFormatInserted> ret =
-                    _newInterface->insert(opCtx, key, recordId, !unique /* dupsAllowed */);
-                status = ret.getStatus();
-
-                // When duplicates are encountered and allowed, retry with dupsAllowed. Add the
-                // key to the output vector so callers know which duplicate keys were inserted.
-                if (ErrorCodes::DuplicateKey == status.code() && options.dupsAllowed) {
-                    invariant(unique);
-                    ret = _newInterface->insert(opCtx, key, recordId, true /* dupsAllowed */);
-                    status = ret.getStatus();
-
-                    // This is speculative in that the 'dupsInserted' vector is not used by any code
-                    // today. It is currently in place to test detecting duplicate key errors during
-                    // hybrid index builds. Duplicate detection in the future will likely not take
-                    // place in this insert() method.
-                    if (status.isOK() && result) {
-                        result->dupsInserted.push_back(key);
-                    }
-                }
-
-                if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
-                    _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
-            }
-            if (isFatalError(opCtx, status, key)) {
+            Status status = insertOneKey(
+                opCtx, inserter.get(), key, recordId, checkIndexKeySize, options, result);
+            if (!status.isOK()) {
                 return status;
             }
         }
@@ -248,6 +228,153 @@ Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status AbstractIndexAccessMethod::insertRecords(OperationContext* opCtx,
+                                                const std::vector<BsonRecord>& bsonRecords,
+                                                const InsertDeleteOptions& options,
+                                                InsertResult* result) {
+    invariant(options.fromIndexBuilder || !_btreeState->isHybridBuilding());
+
+    struct KeyToInsert {
+        BSONObj key;
+        RecordId loc;
+        Timestamp ts;
+    };
+    std::vector<KeyToInsert> keysToInsert;
+
+    // The multikey metadata keys of all documents, which only need to be inserted once.
+    BSONObjSet allMultikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    MultikeyPaths allMultikeyPaths;
+    boost::optional<Timestamp> firstMultikeyTs;
+
+    for (auto&& bsonRecord : bsonRecords) {
+        invariant(bsonRecord.id != RecordId());
+
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        getKeys(*bsonRecord.docPtr,
+                options.getKeysMode,
+                &keys,
+                &multikeyMetadataKeys,
+                &multikeyPaths);
+
+        for (const auto& key : keys) {
+            keysToInsert.push_back({key, bsonRecord.id, bsonRecord.ts});
+        }
+        for (const auto& key : multikeyMetadataKeys) {
+            if (allMultikeyMetadataKeys.insert(key).second) {
+                keysToInsert.push_back({key, kMultikeyMetadataKeyId, bsonRecord.ts});
+            }
+        }
+
+        if (result) {
+            result->numInserted += keys.size() + multikeyMetadataKeys.size();
+        }
+
+        if (shouldMarkIndexAsMultikey(keys, multikeyMetadataKeys, multikeyPaths)) {
+            if (!firstMultikeyTs) {
+                firstMultikeyTs = bsonRecord.ts;
+                allMultikeyPaths = std::move(multikeyPaths);
+            } else {
+                MultikeyPathTracker::mergeMultikeyPaths(&allMultikeyPaths, multikeyPaths);
+            }
+        }
+    }
+
+    // Inserting in index order makes consecutive insertions touch the same or neighbouring pages,
+    // which the previous insertion has just brought into the cache.
+    const auto ordering = Ordering::make(_descriptor->keyPattern());
+    std::sort(keysToInsert.begin(),
+              keysToInsert.end(),
+              [&ordering](const KeyToInsert& lhs, const KeyToInsert& rhs) {
+                  const int cmp = lhs.key.woCompare(rhs.key, ordering, false);
+                  return cmp < 0 || (cmp == 0 && lhs.loc < rhs.loc);
+              });
+
+    // Each key is written at the timestamp of its document. These are never older than the first
+    // timestamp set in this unit of work, since the records themselves were written first.
+    auto setTimestamp = [opCtx, lastTs = Timestamp()](const Timestamp& ts) mutable {
+        if (ts.isNull() || ts == lastTs) {
+            return Status::OK();
+        }
+        lastTs = ts;
+        return opCtx->recoveryUnit()->setTimestamp(ts);
+    };
+
+    const bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
+    auto inserter = _newInterface->makeInserter(opCtx);
+    for (const auto& keyToInsert : keysToInsert) {
+        Status status = setTimestamp(keyToInsert.ts);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        status = insertOneKey(opCtx,
+                              inserter.get(),
+                              keyToInsert.key,
+                              keyToInsert.loc,
+                              checkIndexKeySize,
+                              options,
+                              result);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    // Marking the index multikey too early is always safe, so do it at the earliest timestamp of
+    // a document which made it multikey.
+    if (firstMultikeyTs) {
+        Status status = setTimestamp(*firstMultikeyTs);
+        if (!status.isOK()) {
+            return status;
+        }
+        _btreeState->setMultikey(opCtx, allMultikeyPaths);
+    }
+
+    // Leave the unit of work at the timestamp of the last document, as inserting the documents one
+    // at a time would.
+    return bsonRecords.empty() ? Status::OK() : setTimestamp(bsonRecords.back().ts);
+}
+
+Status AbstractIndexAccessMethod::insertOneKey(OperationContext* opCtx,
+                                               SortedDataInserter* inserter,
+                                               const BSONObj& key,
+                                               const RecordId& loc,
+                                               bool checkIndexKeySize,
+                                               const InsertDeleteOptions& options,
+                                               InsertResult* result) {
+    Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
+    if (status.isOK()) {
+        bool unique = _descriptor->unique();
+        StatusWith<SpecialFormatInserted> ret =
+            inserter->insert(key, loc, !unique /* dupsAllowed */);
+        status = ret.getStatus();
+
+        // When duplicates are encountered and allowed, retry with dupsAllowed. Add the key to the
+        // output vector so callers know which duplicate keys were inserted.
+        if (ErrorCodes::DuplicateKey == status.code() && options.dupsAllowed) {
+            invariant(unique);
+            ret = inserter->insert(key, loc, true /* dupsAllowed */);
+            status = ret.getStatus();
+
+            // This is speculative in that the 'dupsInserted' vector is not used by any code today.
+            // It is currently in place to test detecting duplicate key errors during hybrid index
+            // builds. Duplicate detection in the future will likely not take place in this
+            // insert() method.
+            if (status.isOK() && result) {
+                result->dupsInserted.push_back(key);
+            }
+        }
+
+        if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
+            _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
+    }
+    if (isFatalError(opCtx, status, key)) {
+        return status;
+    }
+    return Status::OK();
+}
+
 void AbstractIndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                              const BSONObj& key,
                                              const RecordId& loc,
@@ -542,11 +669,18 @@ public:
 
     int64_t getKeysInserted() const final;
 
+    void absorb(std::unique_ptr<BulkBuilder> other) final;
+
 private:
     std::unique_ptr<Sorter> _sorter;
     const IndexAccessMethod* _real;
+    const IndexDescriptor* _descriptor;
     int64_t _keysInserted = 0;
 
+    // BulkBuilders filled by other threads, whose sorted keys done() merges with this one's. They
+    // own the files their sorters spill to, so they must outlive the iterator done() returns.
+    std::vector<std::unique_ptr<BulkBuilderImpl>> _absorbed;
+
     // Set to true if any document added to the BulkBuilder causes the index to become multikey.
     bool _isMultiKey = false;
 
@@ -572,9 +706,11 @@ AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(const IndexAccessMet
           SortOptions()
               .TempDir(storageGlobalParams.dbpath + "/_tmp")
               .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
+              .MaxMemoryUsageBytes(maxMemoryUsageBytes)
+              .Parallelism(maxIndexBuildSortThreads.load()),
           BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+      _real(index),
+      _descriptor(descriptor) {}
 
 Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCtx,
                                                           const BSONObj& obj,
@@ -621,13 +757,54 @@ AbstractIndexAccessMethod::BulkBuilderImpl::done() {
         _sorter->add(key, kMultikeyMetadataKeyId);
         ++_keysInserted;
     }
-    return _sorter->done();
+    if (_absorbed.empty()) {
+        return _sorter->done();
+    }
+
+    std::vector<std::shared_ptr<Sorter::Iterator>> iterators;
+    iterators.emplace_back(_sorter->done());
+    for (auto&& other : _absorbed) {
+        iterators.emplace_back(other->_sorter->done());
+    }
+
+    // Each input iterator removes its own spill file, so the merge has none of its own.
+    return Sorter::Iterator::merge(
+        iterators,
+        "",
+        SortOptions(),
+        BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version()));
 }
 
 int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
     return _keysInserted;
 }
 
+void AbstractIndexAccessMethod::BulkBuilderImpl::absorb(std::unique_ptr<BulkBuilder> other) {
+    std::unique_ptr<BulkBuilderImpl> otherImpl(checked_cast<BulkBuilderImpl*>(other.release()));
+    invariant(otherImpl->_real == _real);
+    invariant(otherImpl->_absorbed.empty());
+
+    const auto& otherPaths = otherImpl->_indexMultikeyPaths;
+    if (_indexMultikeyPaths.empty()) {
+        _indexMultikeyPaths = otherPaths;
+    } else if (!otherPaths.empty()) {
+        invariant(_indexMultikeyPaths.size() == otherPaths.size());
+        for (size_t i = 0; i < otherPaths.size(); ++i) {
+            _indexMultikeyPaths[i].insert(otherPaths[i].begin(), otherPaths[i].end());
+        }
+    }
+
+    // Multikey metadata keys may repeat across builders, so they are deduplicated here and only
+    // added to a sorter by done().
+    _multikeyMetadataKeys.insert(otherImpl->_multikeyMetadataKeys.begin(),
+                                 otherImpl->_multikeyMetadataKeys.end());
+    otherImpl->_multikeyMetadataKeys.clear();
+
+    _isMultiKey = _isMultiKey || otherImpl->_isMultiKey;
+    _keysInserted += otherImpl->_keysInserted;
+    _absorbed.push_back(std::move(otherImpl));
+}
+
 Status AbstractIndexAccessMethod::commitBulk(OperationContext* opCtx,
                                              BulkBuilder* bulk,
                                              bool dupsAllowed,
@@ -49,6 +49,7 @@ namespace mongo {
 class BSONObjBuilder;
 class MatchExpression;
 class UpdateTicket;
+struct BsonRecord;
 struct InsertResult;
 struct InsertDeleteOptions;
 
@@ -100,6 +101,17 @@ public:
                               const InsertDeleteOptions& options,
                               InsertResult* result) = 0;
 
+    /**
+     * Equivalent to calling insert() for each document in 'bsonRecords', but generates the keys of
+     * all the documents first and inserts them in index order through a single
+     * SortedDataInserter. Each key is written at the timestamp of its document, if it has one.
+     * If 'result' is not null, it accumulates the results of all documents.
+     */
+    virtual Status insertRecords(OperationContext* opCtx,
+                                 const std::vector<BsonRecord>& bsonRecords,
+                                 const InsertDeleteOptions& options,
+                                 InsertResult* result) = 0;
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -251,6 +263,13 @@ public:
          * Returns number of keys inserted using this BulkBuilder.
          */
         virtual int64_t getKeysInserted() const = 0;
+
+        /**
+         * Takes over the keys and multikey state gathered by 'other', a BulkBuilder for the same
+         * index which was filled by another thread, so that done() returns the keys of both in
+         * sorted order. 'other' must have come from initiateBulk() on the same IndexAccessMethod.
+         */
+        virtual void absorb(std::unique_ptr<BulkBuilder> other) = 0;
     };
 
     /**
@@ -463,6 +482,11 @@ public:
                       const InsertDeleteOptions& options,
                       InsertResult* result) final;
 
+    Status insertRecords(OperationContext* opCtx,
+                         const std::vector<BsonRecord>& bsonRecords,
+                         const InsertDeleteOptions& options,
+                         InsertResult* result) final;
+
     Status remove(OperationContext* opCtx,
                   const BSONObj& obj,
                   const RecordId& loc,
@@ -580,6 +604,20 @@ private:
      */
     bool shouldCheckIndexKeySize(OperationContext* opCtx);
 
+    /**
+     * Inserts a single key through 'inserter', retrying with duplicates allowed if 'options'
+     * permit it. Returns a non-OK status only for fatal errors.
+     *
+     * Used by insertKeys() and insertRecords() only.
+     */
+    Status insertOneKey(OperationContext* opCtx,
+                        SortedDataInserter* inserter,
+                        const BSONObj& key,
+                        const RecordId& loc,
+                        bool checkIndexKeySize,
+                        const InsertDeleteOptions& options,
+                        InsertResult* result);
+
     /**
      * Removes a single key from the index.
      *
@@ -0,0 +1,276 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns true if 'rhs' is an operand which the comparison kernels specialize for. Operands of
+ * other types, and NaN, are left to the regular matcher because of their special comparison rules.
+ */
+bool isCompilableOperand(const BSONElement& rhs) {
+    switch (rhs.type()) {
+        case NumberInt:
+        case NumberLong:
+        case String:
+            return true;
+        case NumberDouble:
+            return !std::isnan(rhs._numberDouble());
+        default:
+            return false;
+    }
+}
+
+template <typename T>
+int compareValues(T lhs, T rhs) {
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* expr) {
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression());
+    compiled->addConjunct(expr);
+    if (compiled->_predicates.empty()) {
+        return nullptr;
+    }
+
+    // Group the predicates by path, keeping their relative order within a path.
+    std::stable_sort(compiled->_predicates.begin(),
+                     compiled->_predicates.end(),
+                     [](const Predicate& lhs, const Predicate& rhs) {
+                         return lhs.pathIndex < rhs.pathIndex;
+                     });
+    return compiled;
+}
+
+void CompiledMatchExpression::addConjunct(const MatchExpression* expr) {
+    if (expr->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            addConjunct(expr->getChild(i));
+        }
+        return;
+    }
+
+    const MatchExpression* leafExpr = expr;
+    const bool negated = expr->matchType() == MatchExpression::NOT;
+    if (negated) {
+        leafExpr = expr->getChild(0);
+    }
+
+    Kernel kernel;
+    switch (leafExpr->matchType()) {
+        case MatchExpression::EQ:
+            kernel = Kernel::kEq;
+            break;
+        case MatchExpression::LT:
+            kernel = Kernel::kLt;
+            break;
+        case MatchExpression::LTE:
+            kernel = Kernel::kLte;
+            break;
+        case MatchExpression::GT:
+            kernel = Kernel::kGt;
+            break;
+        case MatchExpression::GTE:
+            kernel = Kernel::kGte;
+            break;
+        case MatchExpression::MATCH_IN:
+            kernel = Kernel::kIn;
+            break;
+        default:
+            _residuals.push_back(expr);
+            return;
+    }
+
+    if (kernel == Kernel::kIn) {
+        // A null in the set also matches a missing path, and regexes need their own evaluation.
+        const auto in = static_cast<const InMatchExpression*>(leafExpr);
+        if (in->hasNull() || !in->getRegexes().empty()) {
+            _residuals.push_back(expr);
+            return;
+        }
+    } else if (!isCompilableOperand(
+                   static_cast<const ComparisonMatchExpression*>(leafExpr)->getData())) {
+        _residuals.push_back(expr);
+        return;
+    }
+
+    const auto leaf = static_cast<const PathMatchExpression*>(leafExpr);
+    _predicates.push_back({internPath(leaf->path()), kernel, negated, leaf, expr});
+}
+
+size_t CompiledMatchExpression::internPath(StringData path) {
+    for (size_t i = 0; i < _dottedPaths.size(); ++i) {
+        if (path == _dottedPaths[i]) {
+            return i;
+        }
+    }
+
+    std::vector<std::string> parts;
+    size_t start = 0;
+    for (size_t dot = path.find('.'); dot != std::string::npos; dot = path.find('.', start)) {
+        parts.push_back(path.substr(start, dot - start).toString());
+        start = dot + 1;
+    }
+    parts.push_back(path.substr(start).toString());
+
+    _paths.push_back(std::move(parts));
+    _dottedPaths.push_back(path.toString());
+    return _paths.size() - 1;
+}
+
+CompiledMatchExpression::PathState CompiledMatchExpression::resolvePath(const BSONObj& doc,
+                                                                        size_t pathIndex,
+                                                                        BSONElement* out) const {
+    const auto& parts = _paths[pathIndex];
+    BSONElement elem = doc.getField(parts[0]);
+    for (size_t i = 1; i < parts.size(); ++i) {
+        if (elem.type() == Object) {
+            elem = elem.embeddedObject().getField(parts[i]);
+        } else if (elem.type() == Array) {
+            return PathState::kArray;
+        } else {
+            // Descending into a scalar, or into a missing field, finds nothing.
+            elem = BSONElement();
+            break;
+        }
+    }
+
+    if (elem.type() == Array) {
+        return PathState::kArray;
+    }
+
+    *out = elem;
+    return PathState::kResolved;
+}
+
+bool CompiledMatchExpression::evaluateKernel(const Predicate& predicate,
+                                             const BSONElement& elem) const {
+    // None of the compiled operands match a missing field.
+    if (elem.eoo()) {
+        return false;
+    }
+
+    if (predicate.kernel == Kernel::kIn) {
+        const auto& equalities =
+            static_cast<const InMatchExpression*>(predicate.leaf)->getEqualities();
+        return equalities.find(elem) != equalities.end();
+    }
+
+    const auto comparison = static_cast<const ComparisonMatchExpression*>(predicate.leaf);
+    const BSONElement& rhs = comparison->getData();
+    if (elem.type() != rhs.type()) {
+        // Mixed numeric types and values of other types take the general path.
+        return comparison->matchesSingleElement(elem);
+    }
+
+    int cmp;
+    switch (elem.type()) {
+        case NumberInt:
+            cmp = compareValues(elem._numberInt(), rhs._numberInt());
+            break;
+        case NumberLong:
+            cmp = compareValues(elem._numberLong(), rhs._numberLong());
+            break;
+        case NumberDouble:
+            // NaN only matches NaN, and the operand is never NaN.
+            if (std::isnan(elem._numberDouble())) {
+                return false;
+            }
+            cmp = compareValues(elem._numberDouble(), rhs._numberDouble());
+            break;
+        case String:
+            if (comparison->getCollator()) {
+                return comparison->matchesSingleElement(elem);
+            }
+            cmp = elem.valueStringData().compare(rhs.valueStringData());
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+
+    switch (predicate.kernel) {
+        case Kernel::kEq:
+            return cmp == 0;
+        case Kernel::kLt:
+            return cmp < 0;
+        case Kernel::kLte:
+            return cmp <= 0;
+        case Kernel::kGt:
+            return cmp > 0;
+        case Kernel::kGte:
+            return cmp >= 0;
+        case Kernel::kIn:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+bool CompiledMatchExpression::matches(const BSONObj& doc) const {
+    size_t i = 0;
+    while (i < _predicates.size()) {
+        const size_t pathIndex = _predicates[i].pathIndex;
+        BSONElement elem;
+        const PathState state = resolvePath(doc, pathIndex, &elem);
+
+        for (; i < _predicates.size() && _predicates[i].pathIndex == pathIndex; ++i) {
+            const Predicate& predicate = _predicates[i];
+            const bool matched = state == PathState::kArray
+                ? predicate.original->matchesBSON(doc)
+                : evaluateKernel(predicate, elem) != predicate.negated;
+            if (!matched) {
+                return false;
+            }
+        }
+    }
+
+    for (auto&& residual : _residuals) {
+        if (!residual->matchesBSON(doc)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class MatchExpression;
+class PathMatchExpression;
+
+/**
+ * A flat, precompiled form of the conjunctive part of a MatchExpression, used to evaluate a filter
+ * against many BSON documents without walking the expression tree for each of them.
+ *
+ * Compilation flattens the top-level $and and picks out the predicates on a single path which have
+ * a specialized kernel: $eq, $lt, $lte, $gt and $gte against a number or a string, $in without
+ * regexes or null, and the negations of these ($ne, $nin, $not). Each distinct path is resolved
+ * once per document, however many predicates refer to it. Anything else is kept as a residual
+ * MatchExpression and evaluated by the regular matcher after the compiled predicates pass.
+ *
+ * A compiled predicate handles the case in which its path resolves to a single non-array value, or
+ * to nothing, without reaching an array along the way. When the path does reach an array, the
+ * predicate falls back to the original expression, which implements the full array semantics.
+ *
+ * A CompiledMatchExpression holds pointers into the expression it was compiled from, which must
+ * outlive it and must not be modified after compilation.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    /**
+     * Compiles 'expr'. Returns nullptr if no part of 'expr' can be compiled, in which case the
+     * caller should keep using 'expr' directly.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* expr);
+
+    /**
+     * Returns the same result as 'expr'->matchesBSON(doc) for the expression this was compiled
+     * from.
+     */
+    bool matches(const BSONObj& doc) const;
+
+    size_t numCompiledPredicates() const {
+        return _predicates.size();
+    }
+
+    size_t numPaths() const {
+        return _paths.size();
+    }
+
+    size_t numResidualExpressions() const {
+        return _residuals.size();
+    }
+
+private:
+    enum class Kernel {
+        kEq,
+        kLt,
+        kLte,
+        kGt,
+        kGte,
+        kIn,
+    };
+
+    /**
+     * The outcome of resolving a path against a document.
+     */
+    enum class PathState {
+        // The path resolved to a single value, which may be EOO if the path is missing.
+        kResolved,
+        // The path reached an array, so it may name several values.
+        kArray,
+    };
+
+    struct Predicate {
+        // Index into '_paths'.
+        size_t pathIndex;
+        Kernel kernel;
+        // Whether the result of the kernel is inverted, as for $ne and $nin.
+        bool negated;
+        // The leaf expression which supplies the comparison operand.
+        const PathMatchExpression* leaf;
+        // The expression this predicate was compiled from, either 'leaf' or a $not above it. Used
+        // when the path reaches an array.
+        const MatchExpression* original;
+    };
+
+    CompiledMatchExpression() = default;
+
+    /**
+     * Adds 'expr', one of the conjuncts of the filter, to the program.
+     */
+    void addConjunct(const MatchExpression* expr);
+
+    size_t internPath(StringData path);
+
+    PathState resolvePath(const BSONObj& doc, size_t pathIndex, BSONElement* out) const;
+
+    bool evaluateKernel(const Predicate& predicate, const BSONElement& elem) const;
+
+    // The components of each distinct path referenced by the compiled predicates.
+    std::vector<std::vector<std::string>> _paths;
+    std::vector<std::string> _dottedPaths;
+
+    // Ordered by path, so that each path is resolved once and then tested by all of its
+    // predicates in turn.
+    std::vector<Predicate> _predicates;
+
+    std::vector<const MatchExpression*> _residuals;
+};
+
+}  // namespace mongo
@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto statusWithExpr = MatchExpressionParser::parse(filter, expCtx);
+    ASSERT_OK(statusWithExpr.getStatus());
+    return std::move(statusWithExpr.getValue());
+}
+
+/**
+ * A set of documents covering the cases the compiled kernels need to agree with the regular
+ * matcher on: missing fields, each numeric type, NaN, strings, nested documents, arrays at the end
+ * of and in the middle of a path, and values of unrelated types.
+ */
+std::vector<BSONObj> testDocuments() {
+    return {BSONObj(),
+            BSON("a" << 1),
+            BSON("a" << 5),
+            BSON("a" << 5LL),
+            BSON("a" << 5.0),
+            BSON("a" << 5.5),
+            BSON("a" << -0.0),
+            BSON("a" << kNaN),
+            BSON("a" << Decimal128("5")),
+            BSON("a" << std::numeric_limits<long long>::max()),
+            BSON("a"
+                 << "abc"),
+            BSON("a"
+                 << "abd"),
+            BSON("a"
+                 << "ABC"),
+            BSON("a"
+                 << ""),
+            BSON("a" << BSONNULL),
+            BSON("a" << true),
+            BSON("a" << BSON("b" << 5)),
+            BSON("a" << BSON("b"
+                             << "abc")),
+            BSON("a" << BSON("b" << BSON_ARRAY(1 << 5 << 10))),
+            BSON("a" << BSON_ARRAY(BSON("b" << 5) << BSON("b" << 7))),
+            BSON("a" << BSON_ARRAY(1 << 5 << 10)),
+            BSON("a" << BSONArray()),
+            BSON("a" << BSON_ARRAY("abc"
+                                   << "xyz")),
+            BSON("a" << 5 << "c" << 5),
+            BSON("a" << 7 << "c"
+                     << "abc"),
+            BSON("a" << 7 << "c" << BSON_ARRAY(1 << 2))};
+}
+
+void assertSameResults(const MatchExpression* expr, const CompiledMatchExpression& compiled) {
+    for (auto&& doc : testDocuments()) {
+        ASSERT_EQ(compiled.matches(doc), expr->matchesBSON(doc))
+            << "filter: " << expr->toString() << " document: " << doc;
+    }
+}
+
+void assertSameResults(const BSONObj& filter) {
+    auto expr = parse(filter);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled) << filter;
+    assertSameResults(expr.get(), *compiled);
+}
+
+TEST(CompiledMatchExpressionTest, ComparisonsAgreeWithTheMatcher) {
+    for (auto&& op : {"$eq", "$lt", "$lte", "$gt", "$gte", "$ne"}) {
+        assertSameResults(BSON("a" << BSON(op << 5)));
+        assertSameResults(BSON("a" << BSON(op << 5LL)));
+        assertSameResults(BSON("a" << BSON(op << 5.0)));
+        assertSameResults(BSON("a" << BSON(op << -0.0)));
+        assertSameResults(BSON("a" << BSON(op << "abc")));
+        assertSameResults(BSON("a.b" << BSON(op << 5)));
+        assertSameResults(BSON("a.b" << BSON(op << "abc")));
+        assertSameResults(BSON("a" << BSON("$not" << BSON(op << 5))));
+    }
+}
+
+TEST(CompiledMatchExpressionTest, InAgreesWithTheMatcher) {
+    assertSameResults(fromjson("{a: {$in: [1, 5, 'abc', {b: 5}]}}"));
+    assertSameResults(fromjson("{a: {$in: []}}"));
+    assertSameResults(fromjson("{a: {$in: [[1, 5, 10], []]}}"));
+    assertSameResults(fromjson("{'a.b': {$in: [5, 7]}}"));
+    assertSameResults(fromjson("{a: {$nin: [1, 5, 'abc']}}"));
+}
+
+TEST(CompiledMatchExpressionTest, ConjunctionsAgreeWithTheMatcher) {
+    assertSameResults(fromjson("{a: {$gt: 1, $lte: 7}, c: {$ne: 5}}"));
+    assertSameResults(fromjson("{$and: [{a: {$gte: 5}}, {$and: [{a: {$lt: 6}}, {c: 5}]}]}"));
+    assertSameResults(fromjson("{a: {$in: [5, 7]}, c: {$exists: true}}"));
+    assertSameResults(fromjson("{a: 5, $or: [{c: 5}, {c: 'abc'}]}"));
+    assertSameResults(fromjson("{a: {$gte: 'a', $lt: 'b'}, c: {$type: 'array'}}"));
+}
+
+TEST(CompiledMatchExpressionTest, PredicatesOnTheSamePathShareOnePath) {
+    auto expr = parse(fromjson("{a: {$gt: 1, $lt: 10, $ne: 5}, 'b.c': {$in: [1, 2]}, d: /x/}"));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    ASSERT_EQ(compiled->numCompiledPredicates(), 4U);
+    ASSERT_EQ(compiled->numPaths(), 2U);
+    ASSERT_EQ(compiled->numResidualExpressions(), 1U);
+}
+
+TEST(CompiledMatchExpressionTest, OperandsWithSpecialComparisonRulesAreNotCompiled) {
+    for (auto&& filter : {BSON("a" << BSONNULL),
+                          BSON("a" << kNaN),
+                          BSON("a" << MINKEY),
+                          BSON("a" << Decimal128("5")),
+                          fromjson("{a: {$in: [1, null]}}"),
+                          fromjson("{a: {$in: [1, /x/]}}"),
+                          fromjson("{$or: [{a: 1}, {b: 1}]}")}) {
+        auto expr = parse(filter);
+        ASSERT_FALSE(CompiledMatchExpression::compile(expr.get())) << filter;
+    }
+}
+
+TEST(CompiledMatchExpressionTest, ComparisonsRespectTheCollator) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    for (auto&& filter : {fromjson("{a: 'abc'}"),
+                          fromjson("{a: {$gt: 'abc'}}"),
+                          fromjson("{a: {$in: ['abc', 'xyz']}}")}) {
+        auto expr = parse(filter);
+        expr->setCollator(&collator);
+        auto compiled = CompiledMatchExpression::compile(expr.get());
+        ASSERT(compiled);
+        assertSameResults(expr.get(), *compiled);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
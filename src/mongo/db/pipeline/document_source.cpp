@@ -51,6 +51,18 @@ using std::vector;
 DocumentSource::DocumentSource(const intrusive_ptr<ExpressionContext>& pCtx)
     : pSource(NULL), pExpCtx(pCtx) {}
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSource::getNextBatch(vector<Document>* batch,
+                                                                         size_t maxBatchSize) {
+    while (batch->size() < maxBatchSize) {
+        auto next = getNext();
+        if (!next.isAdvanced()) {
+            return next.getStatus();
+        }
+        batch->push_back(next.releaseDocument());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 namespace {
 // Used to keep track of which DocumentSources are registered under which name.
 static StringMap<Parser> parserMap;
@@ -249,6 +249,22 @@ public:
      */
     virtual GetNextResult getNext() = 0;
 
+    /**
+     * Batched counterpart to getNext(). Appends results to 'batch' until it holds 'maxBatchSize'
+     * documents or this stage stops producing results, and returns why the batch ended: kAdvanced
+     * if the batch is full and more results may follow, or the kEOF or kPauseExecution status
+     * which was reached after the documents appended to the batch. Callers must process the
+     * documents in the batch before acting on a kEOF or kPauseExecution status.
+     *
+     * The default implementation calls getNext() once per result. Stages which can do their work
+     * on many documents at once, or which hand them from one stage to the next without change,
+     * override this to cut the per-document overhead of getNext(). Blocking stages consume their
+     * input through this method, so a pipeline such as [$cursor, $match, $project, $group] runs
+     * everything below the $group a batch at a time.
+     */
+    virtual GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                                     size_t maxBatchSize);
+
     /**
      * Returns a struct containing information about any special constraints imposed on using this
      * stage. Input parameter Pipeline::SplitState is used by stages whose requirements change
@@ -74,6 +74,35 @@ DocumentSource::GetNextResult DocumentSourceCursor::getNext() {
     return std::move(out);
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceCursor::getNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    if (_trackOplogTS || pExpCtx->isTailableAwaitData()) {
+        // The oplog timestamp and the await data logic both need to observe each result as it is
+        // returned, so hand out one document at a time.
+        return DocumentSource::getNextBatch(batch, maxBatchSize);
+    }
+
+    pExpCtx->checkForInterrupt();
+
+    while (batch->size() < maxBatchSize) {
+        if (_currentBatch.empty()) {
+            loadBatch();
+            if (_currentBatch.empty()) {
+                return GetNextResult::ReturnStatus::kEOF;
+            }
+        }
+
+        // Move as much of the cached batch across as fits, without copying the documents.
+        const auto numToMove = std::min(_currentBatch.size(), maxBatchSize - batch->size());
+        std::move(_currentBatch.begin(),
+                  _currentBatch.begin() + numToMove,
+                  std::back_inserter(*batch));
+        _currentBatch.erase(_currentBatch.begin(), _currentBatch.begin() + numToMove);
+    }
+
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 Document DocumentSourceCursor::transformBSONObjToDocument(const BSONObj& obj) const {
     return _dependencies ? _dependencies->extractFields(obj) : Document::fromBsonWithMetaData(obj);
 }
@@ -41,6 +41,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/destructor_guard.h"
 
@@ -62,6 +63,24 @@ std::string nextFileName() {
     return "extsort-doc-group." + std::to_string(documentSourceGroupFileCounter.fetchAndAdd(1));
 }
 
+// The deepest level to which a hash-spilled partition is split again when it does not fit in
+// memory. Past this level the partition is aggregated in memory regardless of the memory limit,
+// which only happens when a handful of groups are themselves larger than the limit.
+const int kMaxSpillDepth = 4;
+
+/**
+ * The 64-bit finalizer from MurmurHash3. Value hashes are built with hash_combine, which leaves
+ * their low bits poorly distributed for use as a partition number.
+ */
+uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
 }  // namespace
 
 using boost::intrusive_ptr;
@@ -149,6 +168,8 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
 
     if (_spilled) {
         return getNextSpilled();
+    } else if (_hashSpilled) {
+        return getNextHashSpilled();
     } else if (_streaming) {
         return getNextStreaming();
     } else {
@@ -162,22 +183,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
         return GetNextResult::makeEOF();
 
     _currentId = _firstPartOfNextGroup.first;
-    const size_t numAccumulators = _accumulatedFields.size();
     while (pExpCtx->getValueComparator().evaluate(_currentId == _firstPartOfNextGroup.first)) {
         // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
         // At loop exit, it is the first value to be processed in the next group.
-        switch (numAccumulators) {  // mirrors switch in spill()
-            case 1:                 // Single accumulators serialize as a single Value.
-                _currentAccumulators[0]->process(_firstPartOfNextGroup.second, true);
-            case 0:  // No accumulators so no Values.
-                break;
-            default: {  // Multiple accumulators serialize as an array of Values.
-                const vector<Value>& accumulatorStates = _firstPartOfNextGroup.second.getArray();
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    _currentAccumulators[i]->process(accumulatorStates[i], true);
-                }
-            }
-        }
+        mergeSpilledStates(_firstPartOfNextGroup.second, _currentAccumulators);
 
         if (!_sorterIterator->more()) {
             dispose();
@@ -190,6 +199,30 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
     return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
 }
 
+DocumentSource::GetNextResult DocumentSourceGroup::getNextHashSpilled() {
+    // We aren't streaming, and we have spilled to disk by hash partition. All of the data for a
+    // group lives in a single partition, so the partitions are aggregated and returned one at a
+    // time.
+    while (groupsIterator == _groups->end()) {
+        if (_pendingPartitions.empty()) {
+            dispose();
+            return GetNextResult::makeEOF();
+        }
+
+        SpilledPartition partition = std::move(_pendingPartitions.back());
+        _pendingPartitions.pop_back();
+
+        _groups->clear();
+        _memoryUsageBytes = 0;
+        groupsIterator = loadPartition(partition) ? _groups->begin() : _groups->end();
+    }
+
+    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    ++groupsIterator;
+
+    return std::move(out);
+}
+
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     // Not spilled, and not streaming.
     if (_groups->empty())
@@ -245,6 +278,8 @@ void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _spillPartitions.clear();
+    _pendingPartitions.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -301,6 +336,21 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
     if (explain && findRelevantInputSort()) {
         return Value(DOC("$streamingGroup" << insides.freeze()));
     }
+
+    if (explain && *explain >= ExplainOptions::Verbosity::kExecStats && _hashSpilled) {
+        return Value(DOC(getSourceName()
+                         << insides.freeze()
+                         << "spillStats"
+                         << DOC("partitions" << static_cast<long long>(_numSpillPartitions)
+                                             << "spills"
+                                             << _spillStats.spills
+                                             << "partitionsProcessed"
+                                             << _spillStats.partitionsProcessed
+                                             << "repartitions"
+                                             << _spillStats.repartitions
+                                             << "maxRecursionDepth"
+                                             << _spillStats.maxRecursionDepth)));
+    }
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
@@ -365,6 +415,8 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _initialized(false),
       _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
+      _useHashSpill(internalDocumentSourceGroupUseHashSpill.load()),
+      _numSpillPartitions(internalDocumentSourceGroupSpillPartitions.load()),
       _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
     if (!pExpCtx->inMongos && (pExpCtx->allowDiskUse || kDebugBuild)) {
         // We spill to disk in debug mode, regardless of allowDiskUse, to stress the system.
@@ -588,77 +640,110 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     }
 
 
-    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    GetNextResult input = pSource->getNext();
-    for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
-        }
-
-        // We release the result document here so that it does not outlive the end of this loop
-        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
-        } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'. The input is
+    // requested a batch at a time so that the stages below us can run batched as well.
+    const size_t batchSize = internalDocumentSourceBatchSize.load();
+    vector<Document> batch;
+    batch.reserve(batchSize);
+    auto inputStatus = GetNextResult::ReturnStatus::kAdvanced;
+    while (inputStatus == GetNextResult::ReturnStatus::kAdvanced) {
+        batch.clear();
+        inputStatus = pSource->getNextBatch(&batch, batchSize);
+        for (auto&& doc : batch) {
+            if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+                uassert(16945,
+                        "Exceeded memory limit for $group, but didn't allow external sort."
+                        " Pass allowDiskUse:true to opt in.",
+                        _allowDiskUse);
+                if (_useHashSpill) {
+                    spillToPartitions(0, &_spillPartitions);
+                } else {
+                    _sortedFiles.push_back(spill());
+                }
+                _memoryUsageBytes = 0;
             }
-        }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
+            // We move the document out of the batch here so that it does not outlive the end of
+            // this loop iteration. Not releasing could lead to an array copy when this group
+            // follows an unwind.
+            auto rootDocument = std::move(doc);
+            Value id = computeId(rootDocument);
 
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
+            // Look for the _id value in the map. If it's not there, add a new entry with a blank
+            // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+            // looking it up in '_groups' multiple times.
+            const size_t oldSize = _groups->size();
+            vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
+            const bool inserted = _groups->size() != oldSize;
 
-            _memoryUsageBytes += group[i]->memUsageForSorter();
-        }
+            if (inserted) {
+                _memoryUsageBytes += id.getApproximateSize();
+
+                // Add the accumulators
+                group.reserve(numAccumulators);
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+                }
+            } else {
+                for (auto&& groupObj : group) {
+                    // subtract old mem usage. New usage added back after processing.
+                    _memoryUsageBytes -= groupObj->memUsageForSorter();
+                }
+            }
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inMongos &&        // can't spill to disk in mongos
-                !_allowDiskUse &&            // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+            /* tickle all the accumulators for the group we found */
+            dassert(numAccumulators == group.size());
 
-                _sortedFiles.push_back(spill());
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
+                                  _doingMerge);
+
+                _memoryUsageBytes += group[i]->memUsageForSorter();
+            }
+
+            if (kDebugBuild && !storageGlobalParams.readOnly) {
+                // In debug mode, spill every time we have a duplicate id to stress merge logic.
+                if (!inserted &&                 // is a dup
+                    !pExpCtx->inMongos &&        // can't spill to disk in mongos
+                    !_allowDiskUse &&            // don't change behavior when testing external sort
+                    _sortedFiles.size() < 20 &&  // don't open too many FDs
+                    _spillStats.spills < 20) {
+
+                    if (_useHashSpill) {
+                        spillToPartitions(0, &_spillPartitions);
+                    } else {
+                        _sortedFiles.push_back(spill());
+                    }
+                }
             }
         }
     }
 
-    switch (input.getStatus()) {
+    switch (inputStatus) {
         case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
             MONGO_UNREACHABLE;  // We consumed all advances above.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kPauseExecution: {
-            return input;  // Propagate pause.
+            return GetNextResult::makePauseExecution();  // Propagate pause.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
+            if (!_spillPartitions.empty()) {
+                _hashSpilled = true;
+                if (!_groups->empty()) {
+                    spillToPartitions(0, &_spillPartitions);
+                }
+
+                for (auto&& partition : _spillPartitions) {
+                    if (!partition.ranges.empty()) {
+                        _pendingPartitions.push_back(std::move(partition));
+                    }
+                }
+                _spillPartitions.clear();
+
+                // The partitions are loaded one at a time by getNextHashSpilled().
+                groupsIterator = _groups->end();
+            } else if (!_sortedFiles.empty()) {
                 _spilled = true;
                 if (!_groups->empty()) {
                     _sortedFiles.push_back(spill());
@@ -690,7 +775,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
             // This must happen last so that, unless control gets here, we will re-enter
             // initialization after getting a GetNextResult::ResultState::kPauseExecution.
             _initialized = true;
-            return input;
+            return GetNextResult::makeEOF();
         }
     }
     MONGO_UNREACHABLE;
@@ -701,7 +786,6 @@ bool DocumentSourceGroup::usedDisk() {
 }
 
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
-    _usedDisk = true;
     vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
     ptrs.reserve(_groups->size());
     for (GroupsMap::const_iterator it = _groups->begin(), end = _groups->end(); it != end; ++it) {
@@ -710,40 +794,158 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 
     stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
 
+    auto iterator = spill(ptrs);
+    _groups->clear();
+    return iterator;
+}
+
+shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill(
+    const vector<const GroupsMap::value_type*>& groups) {
+    _usedDisk = true;
     SortedFileWriter<Value, Value> writer(
         SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
+    switch (_accumulatedFields.size()) {  // same as groups[i]->second.size() for all i.
         case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
+            for (size_t i = 0; i < groups.size(); i++) {
+                writer.addAlreadySorted(groups[i]->first, Value());
             }
             break;
 
         case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
+            for (size_t i = 0; i < groups.size(); i++) {
+                writer.addAlreadySorted(groups[i]->first,
+                                        groups[i]->second[0]->getValue(/*toBeMerged=*/true));
             }
             break;
 
         default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
+            for (size_t i = 0; i < groups.size(); i++) {
                 vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
+                for (size_t j = 0; j < groups[i]->second.size(); j++) {
+                    accums.push_back(groups[i]->second[j]->getValue(/*toBeMerged=*/true));
                 }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
+                writer.addAlreadySorted(groups[i]->first, Value(std::move(accums)));
             }
             break;
     }
 
-    _groups->clear();
-
     Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
     _nextSortedFileWriterOffset = writer.getFileEndOffset();
     return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
 }
 
+void DocumentSourceGroup::mergeSpilledStates(const Value& states, const Accumulators& accums) {
+    switch (accums.size()) {  // mirrors switch in spill()
+        case 1:               // Single accumulators serialize as a single Value.
+            accums[0]->process(states, true);
+        case 0:  // No accumulators so no Values.
+            break;
+        default: {  // Multiple accumulators serialize as an array of Values.
+            const vector<Value>& accumulatorStates = states.getArray();
+            for (size_t i = 0; i < accums.size(); i++) {
+                accums[i]->process(accumulatorStates[i], true);
+            }
+        }
+    }
+}
+
+void DocumentSourceGroup::spillToPartitions(int depth, vector<SpilledPartition>* partitions) {
+    if (partitions->empty()) {
+        partitions->resize(_numSpillPartitions);
+        for (auto&& partition : *partitions) {
+            partition.depth = depth;
+        }
+    }
+
+    // Bucket the groups first so that each partition is written out as a single file range.
+    vector<vector<const GroupsMap::value_type*>> buckets(partitions->size());
+    for (auto&& group : *_groups) {
+        buckets[partitionFor(group.first, depth)].push_back(&group);
+    }
+
+    // The ranges are only ever read back in full and aggregated in a hash table, so they are
+    // written unsorted.
+    for (size_t i = 0; i < buckets.size(); i++) {
+        if (!buckets[i].empty()) {
+            (*partitions)[i].ranges.push_back(spill(buckets[i]));
+        }
+    }
+
+    _groups->clear();
+    _memoryUsageBytes = 0;
+
+    _spillStats.spills++;
+    _spillStats.maxRecursionDepth = std::max(_spillStats.maxRecursionDepth, depth);
+}
+
+size_t DocumentSourceGroup::partitionFor(const Value& id, int depth) const {
+    const uint64_t hash = pExpCtx->getValueComparator().hash(id);
+    return mixHash(hash + static_cast<uint64_t>(depth) * 0x9e3779b97f4a7c15ULL) %
+        _numSpillPartitions;
+}
+
+bool DocumentSourceGroup::loadPartition(const SpilledPartition& partition) {
+    const size_t numAccumulators = _accumulatedFields.size();
+    const int subPartitionDepth = partition.depth + 1;
+    vector<SpilledPartition> subPartitions;
+
+    _spillStats.partitionsProcessed++;
+
+    for (auto&& range : partition.ranges) {
+        pExpCtx->checkForInterrupt();
+
+        range->openSource();
+        while (range->more()) {
+            // If the partition is too large to aggregate in memory, split it by hashing at the
+            // next level down. Splitting cannot shrink a single group, so don't try.
+            if (_memoryUsageBytes > _maxMemoryUsageBytes && _allowDiskUse &&
+                _groups->size() > 1 && subPartitionDepth <= kMaxSpillDepth) {
+                if (subPartitions.empty()) {
+                    _spillStats.repartitions++;
+                }
+                spillToPartitions(subPartitionDepth, &subPartitions);
+            }
+
+            auto data = range->next();
+
+            const size_t oldSize = _groups->size();
+            Accumulators& group = (*_groups)[data.first];
+            if (_groups->size() != oldSize) {
+                _memoryUsageBytes += data.first.getApproximateSize();
+
+                group.reserve(numAccumulators);
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+                }
+            } else {
+                for (auto&& accum : group) {
+                    _memoryUsageBytes -= accum->memUsageForSorter();
+                }
+            }
+
+            mergeSpilledStates(data.second, group);
+            for (auto&& accum : group) {
+                _memoryUsageBytes += accum->memUsageForSorter();
+            }
+        }
+        range->closeSource();
+    }
+
+    if (subPartitions.empty()) {
+        return true;
+    }
+
+    if (!_groups->empty()) {
+        spillToPartitions(subPartitionDepth, &subPartitions);
+    }
+    for (auto&& subPartition : subPartitions) {
+        if (!subPartition.ranges.empty()) {
+            _pendingPartitions.push_back(std::move(subPartition));
+        }
+    }
+    return false;
+}
+
 boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
     if (true) {
         // Until streaming $group correctly handles nullish values, the streaming behavior is
@@ -156,6 +156,14 @@ public:
         return _streaming;
     }
 
+    /**
+     * Sets the memory limit past which this stage spills to disk, or fails if it may not. Only
+     * valid before the first call to getNext().
+     */
+    void setMaxMemoryUsageBytes(size_t maxMemoryUsageBytes) {
+        _maxMemoryUsageBytes = maxMemoryUsageBytes;
+    }
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -193,6 +201,7 @@ private:
      */
     GetNextResult getNextStreaming();
     GetNextResult getNextSpilled();
+    GetNextResult getNextHashSpilled();
     GetNextResult getNextStandard();
 
     /**
@@ -220,6 +229,64 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Writes 'groups' to the spill file as a single range, in the given order, and returns an
+     * iterator over that range. Used by both spill() and spillToPartitions().
+     */
+    std::shared_ptr<Sorter<Value, Value>::Iterator> spill(
+        const std::vector<const GroupsMap::value_type*>& groups);
+
+    /**
+     * Merges the accumulator states of a group, as written by spill(), into 'accums'.
+     */
+    static void mergeSpilledStates(const Value& states, const Accumulators& accums);
+
+    /**
+     * A hash partition of the groups which have been spilled to disk. Every spilled group whose
+     * key hashes to this partition at recursion level 'depth' lives in one of 'ranges', which are
+     * unsorted ranges of the spill file holding (key, accumulator states) pairs. A key may appear
+     * in several ranges, each holding partial accumulator states that need to be merged.
+     */
+    struct SpilledPartition {
+        std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> ranges;
+        int depth = 0;
+    };
+
+    /**
+     * Statistics about hash-partitioned spilling, reported by explain with executionStats.
+     */
+    struct SpillStats {
+        // Number of times the in-memory groups were written out to partitions.
+        long long spills = 0;
+        // Number of partitions read back into memory to be aggregated.
+        long long partitionsProcessed = 0;
+        // Number of partitions which did not fit in memory and had to be split again.
+        long long repartitions = 0;
+        // Deepest level of recursive repartitioning.
+        int maxRecursionDepth = 0;
+    };
+
+    /**
+     * Used in place of spill() when hash-partitioned spilling is enabled. Distributes the groups
+     * map across 'partitions' by hashing each group key at recursion level 'depth', spills one
+     * file range per non-empty partition and then clears the groups map.
+     */
+    void spillToPartitions(int depth, std::vector<SpilledPartition>* partitions);
+
+    /**
+     * Returns the index of the partition that 'id' belongs to at recursion level 'depth'. Each
+     * level mixes the depth into the hash so that a partition which is too large to aggregate in
+     * memory is split evenly when it is spilled again.
+     */
+    size_t partitionFor(const Value& id, int depth) const;
+
+    /**
+     * Reads 'partition' back from disk and merges it into the groups map. Returns false if the
+     * partition did not fit in memory and was split into sub-partitions instead, which are pushed
+     * onto '_pendingPartitions' for later processing.
+     */
+    bool loadPartition(const SpilledPartition& partition);
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -245,7 +312,7 @@ private:
     size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
     std::string _fileName;
-    unsigned int _nextSortedFileWriterOffset = 0;
+    std::streampos _nextSortedFileWriterOffset = 0;
     bool _ownsFileDeletion = true;  // unless a MergeIterator is made that takes over.
 
     std::vector<std::string> _idFieldNames;  // used when id is a document
@@ -266,7 +333,20 @@ private:
     std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _sortedFiles;
     bool _spilled;
 
-    // Only used when '_spilled' is false.
+    // Hash-partitioned spilling is used in place of the sort-based spill when
+    // internalDocumentSourceGroupUseHashSpill is set.
+    const bool _useHashSpill;
+    const size_t _numSpillPartitions;
+    std::vector<SpilledPartition> _spillPartitions;
+    // Partitions which still have to be aggregated and returned, processed last in first out so
+    // that sub-partitions are handled before their siblings. Going depth first bounds how many
+    // partitions are pending at once by the repartitioning depth times the number of partitions.
+    std::vector<SpilledPartition> _pendingPartitions;
+    bool _hashSpilled = false;
+    SpillStats _spillStats;
+
+    // Only used when '_spilled' is false. When '_hashSpilled' is true, iterates over the groups of
+    // the partition which is currently loaded.
     GroupsMap::iterator groupsIterator;
 
     // Only used when '_spilled' is true.
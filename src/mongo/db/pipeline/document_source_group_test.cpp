@@ -48,12 +48,14 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -140,6 +142,84 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+/**
+ * Runs a $group on '_id' with a count and a sum of 'x' over 'numGroups' distinct keys, each of
+ * which appears in 'docsPerGroup' interleaved documents, using hash-partitioned spilling into
+ * 'numPartitions' partitions. Checks the results and returns the explain output of the stage.
+ */
+Document runHashSpilledGroup(const intrusive_ptr<ExpressionContext>& expCtx,
+                             int numGroups,
+                             int docsPerGroup,
+                             int numPartitions) {
+    internalDocumentSourceGroupUseHashSpill.store(true);
+    ON_BLOCK_EXIT([] { internalDocumentSourceGroupUseHashSpill.store(false); });
+    const int oldNumPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    internalDocumentSourceGroupSpillPartitions.store(numPartitions);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGroupSpillPartitions.store(oldNumPartitions); });
+
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement sumStatement{"total",
+                                       ExpressionFieldPath::parse(expCtx, "$x", vps),
+                                       AccumulationStatement::getFactory("$sum")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$_id", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {countStatement, sumStatement}, maxMemoryUsageBytes);
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < docsPerGroup; ++i) {
+        for (int id = 0; id < numGroups; ++id) {
+            inputs.emplace_back(Document{{"_id", id}, {"x", i}});
+        }
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    const int expectedTotal = docsPerGroup * (docsPerGroup - 1) / 2;
+    stdx::unordered_set<int> idSet;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_TRUE(idSet.insert(doc["_id"].coerceToInt()).second);
+        ASSERT_VALUE_EQ(doc["count"], Value(docsPerGroup));
+        ASSERT_VALUE_EQ(doc["total"], Value(expectedTotal));
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_EQ(idSet.size(), static_cast<size_t>(numGroups));
+    ASSERT_TRUE(group->usedDisk());
+
+    return group->serialize(ExplainOptions::Verbosity::kExecStats).getDocument();
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldProduceCorrectResultsWhenHashSpilled) {
+    auto explain = runHashSpilledGroup(getExpCtx(), 50, 4, 16);
+
+    auto spillStats = explain["spillStats"];
+    ASSERT_EQ(spillStats.getType(), BSONType::Object);
+    ASSERT_VALUE_EQ(spillStats["partitions"], Value(16LL));
+    ASSERT_GT(spillStats["spills"].coerceToLong(), 0LL);
+    ASSERT_GT(spillStats["partitionsProcessed"].coerceToLong(), 0LL);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldRepartitionHashSpilledPartitionsThatDoNotFitInMemory) {
+    // With only two partitions, each one holds far more groups than fit in memory and must be
+    // split again, up to the maximum recursion depth.
+    auto explain = runHashSpilledGroup(getExpCtx(), 200, 2, 2);
+
+    auto spillStats = explain["spillStats"];
+    ASSERT_EQ(spillStats.getType(), BSONType::Object);
+    ASSERT_GT(spillStats["repartitions"].coerceToLong(), 0LL);
+    ASSERT_GT(spillStats["maxRecursionDepth"].coerceToInt(), 0);
+    ASSERT_GT(spillStats["partitionsProcessed"].coerceToLong(), 2LL);
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
@@ -87,14 +87,7 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
 
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-        // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
-        // only serialize the fields we need to do the match.
-        BSONObj toMatch = _dependencies.needWholeDocument
-            ? nextInput.getDocument().toBson()
-            : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
-                                                             _dependencies.fields);
-
-        if (_expression->matchesBSON(toMatch)) {
+        if (documentMatches(nextInput.getDocument())) {
             return nextInput;
         }
 
@@ -109,6 +102,39 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
     return nextInput;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceMatch::getNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    pExpCtx->checkForInterrupt();
+
+    // The user facing error should have been generated earlier.
+    massert(17309, "Should never call getNext on a $match stage with $text clause", !_isTextQuery);
+
+    // Keep requesting input until the batch is full, so that a selective filter does not hand a
+    // trickle of tiny batches to the next stage. Non-matching documents are dropped from the batch
+    // as soon as each new run of input has been filtered.
+    auto status = GetNextResult::ReturnStatus::kAdvanced;
+    while (status == GetNextResult::ReturnStatus::kAdvanced && batch->size() < maxBatchSize) {
+        const auto firstNew = batch->size();
+        status = pSource->getNextBatch(batch, maxBatchSize);
+        batch->erase(std::remove_if(batch->begin() + firstNew,
+                                    batch->end(),
+                                    [this](const Document& doc) { return !documentMatches(doc); }),
+                     batch->end());
+    }
+
+    return status;
+}
+
+bool DocumentSourceMatch::documentMatches(const Document& doc) const {
+    // MatchExpression only takes BSON documents, so we have to make one. As an optimization, only
+    // serialize the fields we need to do the match.
+    BSONObj toMatch = _dependencies.needWholeDocument
+        ? doc.toBson()
+        : document_path_support::documentToBsonWithPaths(doc, _dependencies.fields);
+
+    return _expression->matchesBSON(toMatch);
+}
+
 Pipeline::SourceContainer::iterator DocumentSourceMatch::doOptimizeAt(
     Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     invariant(*itr == this);
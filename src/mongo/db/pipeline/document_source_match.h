@@ -43,6 +43,8 @@ public:
     virtual ~DocumentSourceMatch() = default;
 
     GetNextResult getNext() override;
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                             size_t maxBatchSize) final;
     boost::intrusive_ptr<DocumentSource> optimize() final;
     BSONObjSet getOutputSorts() final {
         return pSource ? pSource->getOutputSorts()
@@ -172,6 +174,11 @@ protected:
     BSONObj _predicate;
 
 private:
+    /**
+     * Returns true if 'doc' matches '_expression'.
+     */
+    bool documentMatches(const Document& doc) const;
+
     std::unique_ptr<MatchExpression> _expression;
 
     const bool _isTextQuery;
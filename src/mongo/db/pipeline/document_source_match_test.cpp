@@ -624,6 +624,40 @@ TEST_F(DocumentSourceMatchTest, ShouldCorrectlyEvaluateJSONSchemaPredicate) {
     ASSERT_TRUE(match->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceMatchTest, ShouldFilterBatchesAndPropagatePauses) {
+    const auto match = DocumentSourceMatch::create(BSON("a" << BSON("$gte" << 2)), getExpCtx());
+
+    const auto mock =
+        DocumentSourceMock::create({Document{{"a", 1}},
+                                    Document{{"a", 2}},
+                                    Document{{"a", 3}},
+                                    DocumentSource::GetNextResult::makePauseExecution(),
+                                    Document{{"a", 0}},
+                                    Document{{"a", 4}},
+                                    Document{{"a", 5}}});
+    match->setSource(mock.get());
+
+    // Documents before the pause are filtered and returned along with the pause.
+    std::vector<Document> batch;
+    ASSERT(match->getNextBatch(&batch, 10) ==
+           DocumentSource::GetNextResult::ReturnStatus::kPauseExecution);
+    ASSERT_EQ(batch.size(), 2UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 2}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 3}}));
+
+    // The batch is filled from the input even when some of the documents are filtered out.
+    batch.clear();
+    ASSERT(match->getNextBatch(&batch, 1) ==
+           DocumentSource::GetNextResult::ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 4}}));
+
+    batch.clear();
+    ASSERT(match->getNextBatch(&batch, 10) == DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 5}}));
+}
+
 TEST_F(DocumentSourceMatchTest, ShouldShowOptimizationsInExplainOutputWhenOptimized) {
     const auto match = DocumentSourceMatch::create(fromjson("{$and: [{a: 1}]}"), getExpCtx());
 
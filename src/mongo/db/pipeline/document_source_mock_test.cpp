@@ -74,6 +74,31 @@ TEST(DocumentSourceMockTest, DequeStringJSONs) {
     ASSERT(source->getNext().isEOF());
 }
 
+TEST(DocumentSourceMockTest, GetNextBatchShouldStopAtPausesAndEOF) {
+    auto source = DocumentSourceMock::create({Document{{"a", 1}},
+                                              Document{{"a", 2}},
+                                              DocumentSource::GetNextResult::makePauseExecution(),
+                                              Document{{"a", 3}},
+                                              Document{{"a", 4}},
+                                              Document{{"a", 5}}});
+    std::vector<Document> batch;
+    ASSERT(source->getNextBatch(&batch, 10) ==
+           DocumentSource::GetNextResult::ReturnStatus::kPauseExecution);
+    ASSERT_EQ(batch.size(), 2UL);
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 2}}));
+
+    // A full batch ends with kAdvanced, and the remaining results are returned by the next call.
+    batch.clear();
+    ASSERT(source->getNextBatch(&batch, 2) ==
+           DocumentSource::GetNextResult::ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 2UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 3}}));
+
+    ASSERT(source->getNextBatch(&batch, 10) == DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 3UL);
+    ASSERT_DOCUMENT_EQ(batch[2], (Document{{"a", 5}}));
+}
+
 TEST(DocumentSourceMockTest, Empty) {
     auto source = DocumentSourceMock::create();
     ASSERT(source->getNext().isEOF());
@@ -0,0 +1,298 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_parallel_cursor.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/pipeline/pipeline_d.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+namespace {
+
+/**
+ * Returns the thread pool that runs the workers of every parallel aggregation, which bounds the
+ * number of threads they use across the server. Workers only wait for the aggregation that
+ * scheduled them, which never runs on the pool, so a busy pool delays them but cannot deadlock.
+ */
+ThreadPool* getWorkerPool() {
+    // Never destroyed, since workers may still be running on it at shutdown.
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "parallelAggregation";
+        options.minThreads = 0;
+        options.maxThreads = std::max(1UL, ProcessInfo::getNumAvailableCores());
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
+}  // namespace
+
+constexpr const char* DocumentSourceParallelCursor::kStageName;
+constexpr size_t DocumentSourceParallelCursor::kMaxBufferedDocuments;
+
+DocumentSourceParallelCursor::DocumentSourceParallelCursor(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID uuid,
+    BSONObj query,
+    std::vector<RecordId> boundaries,
+    std::vector<BSONObj> workerStages,
+    std::string planSummary)
+    : DocumentSource(expCtx),
+      _nss(nss),
+      _uuid(std::move(uuid)),
+      _query(query.getOwned()),
+      _boundaries(std::move(boundaries)),
+      _workerStages(std::move(workerStages)),
+      _planSummary(std::move(planSummary)),
+      _workerMaxMemoryUsageBytes(internalDocumentSourceGroupMaxMemoryBytes.load() /
+                                 (_boundaries.size() + 1)) {
+    invariant(std::is_sorted(_boundaries.begin(), _boundaries.end()));
+}
+
+intrusive_ptr<DocumentSourceParallelCursor> DocumentSourceParallelCursor::create(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID uuid,
+    BSONObj query,
+    std::vector<RecordId> boundaries,
+    std::vector<BSONObj> workerStages,
+    std::string planSummary) {
+    return new DocumentSourceParallelCursor(expCtx,
+                                            nss,
+                                            std::move(uuid),
+                                            std::move(query),
+                                            std::move(boundaries),
+                                            std::move(workerStages),
+                                            std::move(planSummary));
+}
+
+DocumentSourceParallelCursor::~DocumentSourceParallelCursor() {
+    stopWorkers();
+}
+
+const char* DocumentSourceParallelCursor::getSourceName() const {
+    return kStageName;
+}
+
+Value DocumentSourceParallelCursor::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    const long long numWorkers = _boundaries.size() + 1;
+    return Value(DOC(getSourceName() << DOC("query" << _query << "workers" << numWorkers)));
+}
+
+DocumentSource::GetNextResult DocumentSourceParallelCursor::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_workersStarted) {
+        startWorkers();
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    pExpCtx->opCtx->waitForConditionOrInterrupt(_documentsAvailable, lk, [&] {
+        return !_buffer.empty() || !_workerStatus.isOK() || _numActiveWorkers == 0;
+    });
+    uassertStatusOK(_workerStatus);
+
+    if (_buffer.empty()) {
+        return GetNextResult::makeEOF();
+    }
+
+    Document next = std::move(_buffer.front());
+    _buffer.pop_front();
+    _spaceAvailable.notify_one();
+    return std::move(next);
+}
+
+PlanSummaryStats DocumentSourceParallelCursor::getPlanSummaryStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _planSummaryStats;
+}
+
+void DocumentSourceParallelCursor::startWorkers() {
+    invariant(!_workersStarted);
+    _workersStarted = true;
+
+    const size_t numRanges = _boundaries.size() + 1;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workerOpCtxs.assign(numRanges, nullptr);
+        _numActiveWorkers = numRanges;
+    }
+
+    auto serviceContext = pExpCtx->opCtx->getServiceContext();
+    for (size_t rangeIndex = 0; rangeIndex < numRanges; ++rangeIndex) {
+        // Each worker gets its own ExpressionContext, and so its own collator and variables, and
+        // produces partial results for the merging stage which follows this one.
+        auto workerExpCtx = pExpCtx->copyWith(_nss, _uuid);
+        workerExpCtx->needsMerge = true;
+
+        auto status = getWorkerPool()->schedule([this, serviceContext, rangeIndex, workerExpCtx] {
+            runWorker(serviceContext, rangeIndex, workerExpCtx);
+        });
+        if (!status.isOK()) {
+            // The workers which were not scheduled will never report that they have finished.
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _numActiveWorkers -= numRanges - rangeIndex;
+            _documentsAvailable.notify_all();
+            uassertStatusOK(status);
+        }
+    }
+}
+
+void DocumentSourceParallelCursor::stopWorkers() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _disposed = true;
+        for (auto workerOpCtx : _workerOpCtxs) {
+            if (workerOpCtx) {
+                stdx::lock_guard<Client> clientLock(*workerOpCtx->getClient());
+                workerOpCtx->getServiceContext()->killOperation(clientLock, workerOpCtx);
+            }
+        }
+        _spaceAvailable.notify_all();
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _documentsAvailable.wait(lk, [&] { return _numActiveWorkers == 0; });
+    _buffer.clear();
+}
+
+void DocumentSourceParallelCursor::doDispose() {
+    stopWorkers();
+}
+
+void DocumentSourceParallelCursor::runWorker(ServiceContext* serviceContext,
+                                             size_t rangeIndex,
+                                             intrusive_ptr<ExpressionContext> workerExpCtx) {
+    ThreadClient tc(str::stream() << "parallelAggregation-" << rangeIndex, serviceContext);
+    auto opCtx = cc().makeOperationContext();
+
+    bool disposed;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        disposed = _disposed;
+        if (!disposed) {
+            _workerOpCtxs[rangeIndex] = opCtx.get();
+        }
+    }
+
+    Status status = Status::OK();
+    if (!disposed) {
+        try {
+            produceRange(opCtx.get(), rangeIndex, workerExpCtx);
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _workerOpCtxs[rangeIndex] = nullptr;
+    if (!status.isOK() && !_disposed) {
+        LOG(1) << "parallel aggregation worker over " << _nss << " failed: " << status;
+        if (_workerStatus.isOK()) {
+            _workerStatus = status;
+        }
+    }
+    --_numActiveWorkers;
+    _documentsAvailable.notify_all();
+}
+
+void DocumentSourceParallelCursor::produceRange(
+    OperationContext* opCtx,
+    size_t rangeIndex,
+    const intrusive_ptr<ExpressionContext>& workerExpCtx) {
+    workerExpCtx->opCtx = opCtx;
+    auto pipeline = uassertStatusOK(Pipeline::parse(_workerStages, workerExpCtx));
+    if (auto group = dynamic_cast<DocumentSourceGroup*>(pipeline->getSources().back().get())) {
+        group->setMaxMemoryUsageBytes(_workerMaxMemoryUsageBytes);
+    }
+
+    boost::optional<RecordId> minRecord;
+    if (rangeIndex > 0) {
+        minRecord = _boundaries[rangeIndex - 1];
+    }
+    boost::optional<RecordId> maxRecord;
+    if (rangeIndex < _boundaries.size()) {
+        maxRecord = _boundaries[rangeIndex];
+    }
+    {
+        // Fails with NamespaceNotFound if the collection was dropped since this stage was created.
+        AutoGetCollectionForRead autoColl(opCtx,
+                                          NamespaceStringOrUUID(_nss.db().toString(), _uuid));
+        PipelineD::prepareRangeCursorSource(
+            autoColl.getCollection(), _query, minRecord, maxRecord, pipeline.get());
+    }
+
+    while (auto next = pipeline->getNext()) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        opCtx->waitForConditionOrInterrupt(_spaceAvailable, lk, [&] {
+            return _disposed || _buffer.size() < kMaxBufferedDocuments;
+        });
+        if (_disposed) {
+            return;
+        }
+        _buffer.push_back(std::move(*next));
+        _documentsAvailable.notify_one();
+    }
+
+    PlanSummaryStats stats;
+    PipelineD::getPlanSummaryStats(pipeline.get(), &stats);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _planSummaryStats.nReturned += stats.nReturned;
+    _planSummaryStats.totalKeysExamined += stats.totalKeysExamined;
+    _planSummaryStats.totalDocsExamined += stats.totalDocsExamined;
+    _planSummaryStats.usedDisk = _planSummaryStats.usedDisk || stats.usedDisk;
+}
+
+}  // namespace mongo
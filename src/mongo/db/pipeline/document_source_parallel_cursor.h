@@ -0,0 +1,190 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+/**
+ * Runs several copies of the start of a pipeline at once, each over its own range of RecordIds in
+ * a collection, and returns the documents they produce in no particular order.
+ *
+ * Each copy runs as a task on a thread pool shared by all parallel aggregations, with its own
+ * Client and OperationContext, and is built from the serialized stages it was given behind a
+ * DocumentSourceCursor which scans its range. The stages are parsed with 'needsMerge' set, so a
+ * trailing $group outputs partial results which a merging $group after this stage combines, just
+ * as for a sharded aggregation. The memory limit of the $group is split evenly between the copies.
+ *
+ * The workers are scheduled by the first call to getNext(), by which time the aggregation no
+ * longer holds its collection lock, and are stopped by dispose(). Workers wait for a pool thread
+ * when the pool is busy with other aggregations.
+ */
+class DocumentSourceParallelCursor final : public DocumentSource {
+public:
+    static constexpr auto kStageName = "$parallelCursor";
+
+    /**
+     * Creates a stage which runs one copy of the stages described by 'workerStages' for each of the
+     * ranges into which 'boundaries' splits the collection 'nss', whose UUID must stay 'uuid' for
+     * the lifetime of the stage. Each copy reads the documents matching 'query'. 'boundaries' must
+     * be ascending; the first range is unbounded below and the last unbounded above.
+     */
+    static boost::intrusive_ptr<DocumentSourceParallelCursor> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID uuid,
+        BSONObj query,
+        std::vector<RecordId> boundaries,
+        std::vector<BSONObj> workerStages,
+        std::string planSummary);
+
+    ~DocumentSourceParallelCursor();
+
+    GetNextResult getNext() final;
+
+    const char* getSourceName() const final;
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<MergingLogic> mergingLogic() final {
+        return boost::none;
+    }
+
+    const std::string& getPlanSummaryStr() const {
+        return _planSummary;
+    }
+
+    /**
+     * Returns the summary statistics of the plans run by the workers which have finished so far.
+     */
+    PlanSummaryStats getPlanSummaryStats() const;
+
+protected:
+    /**
+     * Stops the workers and waits for them to finish.
+     */
+    void doDispose() final;
+
+private:
+    // The most documents the workers may have produced that getNext() has not yet returned.
+    static constexpr size_t kMaxBufferedDocuments = 1024;
+
+    DocumentSourceParallelCursor(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                 const NamespaceString& nss,
+                                 UUID uuid,
+                                 BSONObj query,
+                                 std::vector<RecordId> boundaries,
+                                 std::vector<BSONObj> workerStages,
+                                 std::string planSummary);
+
+    void startWorkers();
+
+    /**
+     * Interrupts the workers, if any are running, and waits for all of them to finish. Workers
+     * which have not started yet exit as soon as they get a thread.
+     */
+    void stopWorkers();
+
+    /**
+     * Body of the task which runs the copy of the pipeline over the range of RecordIds with the
+     * given index.
+     */
+    void runWorker(ServiceContext* serviceContext,
+                   size_t rangeIndex,
+                   boost::intrusive_ptr<ExpressionContext> workerExpCtx);
+
+    /**
+     * Runs the worker pipeline on 'opCtx', handing each document it produces to getNext(). Returns
+     * early if the stage is disposed of.
+     */
+    void produceRange(OperationContext* opCtx,
+                      size_t rangeIndex,
+                      const boost::intrusive_ptr<ExpressionContext>& workerExpCtx);
+
+    const NamespaceString _nss;
+    const UUID _uuid;
+    const BSONObj _query;
+    const std::vector<RecordId> _boundaries;
+    const std::vector<BSONObj> _workerStages;
+    const std::string _planSummary;
+
+    // The memory limit of the $group each worker runs.
+    const size_t _workerMaxMemoryUsageBytes;
+
+    bool _workersStarted = false;
+
+    // Protects all of the members below.
+    mutable stdx::mutex _mutex;
+
+    // Signalled when a document is added to '_buffer', when a worker fails and when a worker
+    // finishes.
+    stdx::condition_variable _documentsAvailable;
+
+    // Signalled when a document is taken from '_buffer' and when the stage is disposed of.
+    stdx::condition_variable _spaceAvailable;
+
+    std::deque<Document> _buffer;
+
+    // The OperationContexts of the running workers, indexed by range, so that dispose() can
+    // interrupt them. Null for workers which have not started or have finished.
+    std::vector<OperationContext*> _workerOpCtxs;
+
+    // Workers which have been scheduled and have not finished, whether or not they have started.
+    size_t _numActiveWorkers = 0;
+    Status _workerStatus = Status::OK();
+    bool _disposed = false;
+
+    PlanSummaryStats _planSummaryStats;
+};
+
+}  // namespace mongo
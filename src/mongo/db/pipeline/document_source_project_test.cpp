@@ -116,6 +116,28 @@ TEST_F(ProjectStageTest, InclusionShouldBeAbleToProcessMultipleDocuments) {
     ASSERT(project->getNext().isEOF());
 }
 
+TEST_F(ProjectStageTest, ShouldProjectEachDocumentOfABatch) {
+    auto project = DocumentSourceProject::create(BSON("a" << true), getExpCtx());
+    auto source = DocumentSourceMock::create({"{a: 1, b: 2}", "{a: 3, b: 4}", "{a: 5, b: 6}"});
+    project->setSource(source.get());
+
+    std::vector<Document> batch;
+    ASSERT(project->getNextBatch(&batch, 2) ==
+           DocumentSource::GetNextResult::ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 2UL);
+    ASSERT_EQUALS(1, batch[0].getField("a").getInt());
+    ASSERT(batch[0].getField("b").missing());
+    ASSERT_EQUALS(3, batch[1].getField("a").getInt());
+    ASSERT(batch[1].getField("b").missing());
+
+    batch.clear();
+    ASSERT(project->getNextBatch(&batch, 2) ==
+           DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 1UL);
+    ASSERT_EQUALS(5, batch[0].getField("a").getInt());
+    ASSERT(batch[0].getField("b").missing());
+}
+
 /**
  * Basic sanity check that two documents can be projected correctly with a simple inclusion
  * projection.
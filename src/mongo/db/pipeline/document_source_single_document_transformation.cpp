@@ -70,6 +70,21 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::getNex
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
 
+DocumentSource::GetNextResult::ReturnStatus
+DocumentSourceSingleDocumentTransformation::getNextBatch(std::vector<Document>* batch,
+                                                         size_t maxBatchSize) {
+    pExpCtx->checkForInterrupt();
+
+    // Transform the new input in place, so that each result replaces the document it came from.
+    const auto firstNew = batch->size();
+    const auto status = pSource->getNextBatch(batch, maxBatchSize);
+    for (auto it = batch->begin() + firstNew; it != batch->end(); ++it) {
+        *it = _parsedTransform->applyTransformation(*it);
+    }
+
+    return status;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
     _parsedTransform->optimize();
     return this;
@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 
 namespace mongo {
@@ -325,6 +326,7 @@ SortOptions DocumentSourceSort::makeSortOptions() const {
         opts.limit = _limitSrc->getLimit();
 
     opts.maxMemoryUsageBytes = _maxMemoryUsageBytes;
+    opts.parallelism = internalDocumentSourceSortParallelism.load();
     if (pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
         opts.extSortAllowed = true;
         opts.tempDir = pExpCtx->tempDir;
@@ -334,14 +336,24 @@ SortOptions DocumentSourceSort::makeSortOptions() const {
 }
 
 DocumentSource::GetNextResult DocumentSourceSort::populate() {
-    auto nextInput = pSource->getNext();
-    for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-        loadDocument(nextInput.releaseDocument());
+    const size_t batchSize = internalDocumentSourceBatchSize.load();
+    std::vector<Document> batch;
+    batch.reserve(batchSize);
+
+    auto status = GetNextResult::ReturnStatus::kAdvanced;
+    while (status == GetNextResult::ReturnStatus::kAdvanced) {
+        batch.clear();
+        status = pSource->getNextBatch(&batch, batchSize);
+        for (auto&& doc : batch) {
+            loadDocument(std::move(doc));
+        }
     }
-    if (nextInput.isEOF()) {
-        loadingDone();
+
+    if (status == GetNextResult::ReturnStatus::kPauseExecution) {
+        return GetNextResult::makePauseExecution();
     }
-    return nextInput;
+    loadingDone();
+    return GetNextResult::makeEOF();
 }
 
 void DocumentSourceSort::loadDocument(Document&& doc) {
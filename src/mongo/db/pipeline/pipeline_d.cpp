@@ -60,15 +60,19 @@
 #include "mongo/db/pipeline/document_source_geo_near_cursor.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_parallel_cursor.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/explain.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
@@ -394,6 +398,27 @@ getSortAndGroupStagesFromPipeline(const Pipeline::SourceContainer& sources) {
     return std::make_pair(sortStage, groupStage);
 }
 
+/**
+ * Returns an iterator to the first $group in 'sources' if every stage before it filters or
+ * reshapes one document at a time, so that copies of the stages up to and including the $group
+ * can each run over part of the input. Returns 'sources.end()' otherwise.
+ */
+Pipeline::SourceContainer::const_iterator findParallelizableGroup(
+    const Pipeline::SourceContainer& sources) {
+    static const std::set<StringData> kPerDocumentStages = {
+        "$match"_sd, "$project"_sd, "$addFields"_sd, "$replaceRoot"_sd, "$unwind"_sd};
+
+    for (auto it = sources.begin(); it != sources.end(); ++it) {
+        if (dynamic_cast<DocumentSourceGroup*>(it->get())) {
+            return it;
+        }
+        if (!kPerDocumentStages.count((*it)->getSourceName())) {
+            break;
+        }
+    }
+    return sources.end();
+}
+
 }  // namespace
 
 void PipelineD::prepareGenericCursorSource(Collection* collection,
@@ -472,6 +497,11 @@ void PipelineD::prepareGenericCursorSource(Collection* collection,
         }
     }
 
+    if (attemptToParallelize(
+            collection, pipeline, *exec, deps, queryObj, sortObj, projForQuery)) {
+        return;
+    }
+
     // If this is a change stream pipeline, make sure that we tell DSCursor to track the oplog time.
     const bool trackOplogTS =
         (pipeline->peekFront() && pipeline->peekFront()->constraints().isChangeStreamStage());
@@ -484,6 +514,112 @@ void PipelineD::prepareGenericCursorSource(Collection* collection,
                     projForQuery);
 }
 
+bool PipelineD::attemptToParallelize(Collection* collection,
+                                     Pipeline* pipeline,
+                                     const PlanExecutor& exec,
+                                     const DepsTracker& deps,
+                                     const BSONObj& queryObj,
+                                     const BSONObj& sortObj,
+                                     const BSONObj& projectionObj) {
+    const size_t numWorkers = internalQueryParallelAggWorkers.load();
+    auto expCtx = pipeline->getContext();
+    auto opCtx = expCtx->opCtx;
+
+    // The workers read with their own locks and snapshots, just as a yielding scan reads each batch
+    // with a new snapshot, which only local read concern outside a transaction allows. A sharded
+    // collection would need every worker to filter out orphans.
+    if (numWorkers <= 1 || !collection || !collection->uuid() || collection->ns().isOplog() ||
+        expCtx->explain || expCtx->tailableMode != TailableModeEnum::kNormal ||
+        expCtx->inMultiDocumentTransaction || expCtx->fromMongos || expCtx->subPipelineDepth > 0 ||
+        opCtx->getClient()->isInDirectClient() || ShardingState::get(opCtx)->enabled() ||
+        repl::ReadConcernArgs::get(opCtx).getLevel() !=
+            repl::ReadConcernLevel::kLocalReadConcern) {
+        return false;
+    }
+
+    // Only a plain collection scan can be split into ranges of RecordIds.
+    if (!sortObj.isEmpty() || !projectionObj.isEmpty() || deps.getNeedsAnyMetadata() ||
+        exec.getRootStage()->stageType() != STAGE_COLLSCAN) {
+        return false;
+    }
+
+    Pipeline::SourceContainer& sources = pipeline->_sources;
+    const auto groupIt = findParallelizableGroup(sources);
+    if (groupIt == sources.end() ||
+        collection->getRecordStore()->numRecords(opCtx) <
+            internalQueryParallelAggMinRecords.load()) {
+        return false;
+    }
+
+    auto boundaries = collection->getRecordStore()->sampleRangeBoundaries(opCtx, numWorkers);
+    if (boundaries.empty()) {
+        return false;
+    }
+
+    // The workers parse their own copies of the stages, so that none of them is shared between
+    // threads.
+    const auto workerStagesEnd = std::next(groupIt);
+    std::vector<BSONObj> workerStages;
+    for (auto it = sources.cbegin(); it != workerStagesEnd; ++it) {
+        std::vector<Value> serializedStages;
+        (*it)->serializeToArray(serializedStages);
+        for (auto&& stage : serializedStages) {
+            workerStages.push_back(stage.getDocument().toBson());
+        }
+    }
+
+    auto mergingStage = (*groupIt)->mergingLogic()->mergingStage;
+    sources.erase(sources.cbegin(), workerStagesEnd);
+    pipeline->addInitialSource(std::move(mergingStage));
+    auto parallelCursor = DocumentSourceParallelCursor::create(expCtx,
+                                                               collection->ns(),
+                                                               *collection->uuid(),
+                                                               queryObj,
+                                                               std::move(boundaries),
+                                                               std::move(workerStages),
+                                                               Explain::getPlanSummary(&exec));
+    pipeline->addInitialSource(std::move(parallelCursor));
+    return true;
+}
+
+void PipelineD::prepareRangeCursorSource(Collection* collection,
+                                         const BSONObj& queryObj,
+                                         boost::optional<RecordId> minRecord,
+                                         boost::optional<RecordId> maxRecord,
+                                         Pipeline* pipeline) {
+    invariant(collection);
+    auto expCtx = pipeline->getContext();
+    auto opCtx = expCtx->opCtx;
+    dassert(opCtx->lockState()->isCollectionLockedForMode(collection->ns().ns(), MODE_IS));
+
+    auto qr = stdx::make_unique<QueryRequest>(collection->ns());
+    qr->setFilter(queryObj);
+    qr->setCollation(expCtx->getCollator() ? expCtx->getCollator()->getSpec().toBSON()
+                                           : expCtx->collation);
+    const ExtensionsCallbackReal extensionsCallback(opCtx, &collection->ns());
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(
+        opCtx, std::move(qr), expCtx, extensionsCallback, Pipeline::kAllowedMatcherFeatures));
+
+    CollectionScanParams params;
+    params.minRecord = std::move(minRecord);
+    params.maxRecord = std::move(maxRecord);
+    auto ws = stdx::make_unique<WorkingSet>();
+    auto root =
+        stdx::make_unique<CollectionScan>(opCtx, collection, params, ws.get(), cq->root());
+    auto exec = uassertStatusOK(PlanExecutor::make(opCtx,
+                                                   std::move(ws),
+                                                   std::move(root),
+                                                   std::move(cq),
+                                                   collection,
+                                                   PlanExecutor::YIELD_AUTO));
+
+    auto deps = pipeline->getDependencies(DepsTracker::MetadataAvailable::kNoMetadata);
+    addCursorSource(pipeline,
+                    DocumentSourceCursor::create(collection, std::move(exec), expCtx),
+                    std::move(deps),
+                    queryObj);
+}
+
 void PipelineD::prepareGeoNearCursorSource(Collection* collection,
                                            const NamespaceString& nss,
                                            const AggregationRequest* aggRequest,
@@ -814,6 +950,10 @@ std::string PipelineD::getPlanSummaryStr(const Pipeline* pipeline) {
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         return docSourceCursor->getPlanSummaryStr();
     }
+    if (auto parallelCursor =
+            dynamic_cast<DocumentSourceParallelCursor*>(pipeline->_sources.front().get())) {
+        return parallelCursor->getPlanSummaryStr();
+    }
 
     return "";
 }
@@ -824,6 +964,9 @@ void PipelineD::getPlanSummaryStats(const Pipeline* pipeline, PlanSummaryStats*
     if (auto docSourceCursor =
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         *statsOut = docSourceCursor->getPlanSummaryStats();
+    } else if (auto parallelCursor = dynamic_cast<DocumentSourceParallelCursor*>(
+                   pipeline->_sources.front().get())) {
+        *statsOut = parallelCursor->getPlanSummaryStats();
     }
 
     bool hasSortStage{false};
@@ -39,6 +39,7 @@
 #include "mongo/db/pipeline/document_source_cursor.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/record_id.h"
 
 namespace mongo {
 class Collection;
@@ -97,6 +98,20 @@ public:
                                            const AggregationRequest* aggRequest,
                                            Pipeline* pipeline);
 
+    /**
+     * Attaches a DocumentSourceCursor to the front of 'pipeline' which scans the documents of
+     * 'collection' that match 'queryObj' and whose RecordIds lie in ['minRecord', 'maxRecord').
+     * Either bound may be omitted to scan from the start or to the end of the collection. Used by
+     * the workers of a $parallelCursor, which each scan one such range.
+     *
+     * Callers must take care to ensure that 'collection' is locked in at least IS-mode.
+     */
+    static void prepareRangeCursorSource(Collection* collection,
+                                         const BSONObj& queryObj,
+                                         boost::optional<RecordId> minRecord,
+                                         boost::optional<RecordId> maxRecord,
+                                         Pipeline* pipeline);
+
     static std::string getPlanSummaryStr(const Pipeline* pipeline);
 
     static void getPlanSummaryStats(const Pipeline* pipeline, PlanSummaryStats* statsOut);
@@ -135,6 +150,22 @@ private:
         BSONObj* sortObj,
         BSONObj* projectionObj);
 
+    /**
+     * If the internalQueryParallelAggWorkers knob allows it, and 'pipeline' reads an unsharded
+     * collection through the collection scan in 'exec' and begins with stages which each reshape
+     * or filter one document at a time followed by a $group, replaces those stages with a
+     * $parallelCursor which runs copies of them over several ranges of the collection at once and
+     * the merging half of the $group. Returns whether 'pipeline' was rewritten, in which case
+     * 'exec' is not needed.
+     */
+    static bool attemptToParallelize(Collection* collection,
+                                     Pipeline* pipeline,
+                                     const PlanExecutor& exec,
+                                     const DepsTracker& deps,
+                                     const BSONObj& queryObj,
+                                     const BSONObj& sortObj,
+                                     const BSONObj& projectionObj);
+
     /**
      * Adds 'cursor' to the front of 'pipeline', using 'deps' to inform the cursor of its
      * dependencies. If specified, 'queryObj', 'sortObj' and 'projectionObj' are passed to the
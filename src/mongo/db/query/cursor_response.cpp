@@ -55,16 +55,34 @@ const char kPostBatchResumeTokenField[] = "postBatchResumeToken";
 
 CursorResponseBuilder::CursorResponseBuilder(rpc::ReplyBuilderInterface* replyBuilder,
                                              Options options = Options())
-    : _options(options), _replyBuilder(replyBuilder) {
+    : _options(options),
+      _replyBuilder(replyBuilder),
+      _sharedObjectBuilder(replyBuilder->getSharedObjectBuilder()) {
     if (_options.useDocumentSequences) {
         _docSeqBuilder.emplace(_replyBuilder->getDocSequenceBuilder(
             _options.isInitialResponse ? kBatchDocSequenceFieldInitial : kBatchDocSequenceField));
     } else {
         _bodyBuilder.emplace(_replyBuilder->getBodyBuilder());
         _cursorObject.emplace(_bodyBuilder->subobjStart(kCursorField));
-        _batch.emplace(_cursorObject->subarrayStart(_options.isInitialResponse ? kBatchFieldInitial
-                                                                               : kBatchField));
+        const StringData batchField = _options.isInitialResponse ? kBatchFieldInitial : kBatchField;
+        // The array's size follows its type byte and NUL-terminated field name.
+        const int batchSizeOffset = _cursorObject->bb().len() + 1 + batchField.size() + 1;
+        _batch.emplace(_cursorObject->subarrayStart(batchField));
+        if (_sharedObjectBuilder) {
+            _sharedObjectBuilder->addSharedObjectContainer(_cursorObject->offset());
+            _sharedObjectBuilder->addSharedObjectContainer(batchSizeOffset);
+        }
+    }
+}
+
+void CursorResponseBuilder::_appendShared(const BSONObj& obj) {
+    if (_options.useDocumentSequences) {
+        _docSeqBuilder->appendShared(obj);
+    } else {
+        _batch->subobjStart();
+        _sharedObjectBuilder->appendSharedObject(obj);
     }
+    _sharedBytes += obj.objsize() - BSONObj().objsize();
 }
 
 void CursorResponseBuilder::done(CursorId cursorId, StringData cursorNamespace) {
@@ -97,6 +115,7 @@ void CursorResponseBuilder::abandon() {
     _bodyBuilder.reset();
     _replyBuilder->reset();
     _numDocs = 0;
+    _sharedBytes = 0;
     _active = false;
 }
 
@@ -73,14 +73,24 @@ public:
             abandon();
     }
 
+    /**
+     * Owned documents at least this large are referenced by the reply rather than copied into it
+     * when the reply allows it (see ReplyBuilderInterface::getSharedObjectBuilder()). Smaller
+     * ones are cheaper to copy than to send as separate segments.
+     */
+    static constexpr int kMinSharedObjectSize = 16 * 1024;
+
     size_t bytesUsed() const {
         invariant(_active);
-        return _options.useDocumentSequences ? _docSeqBuilder->len() : _batch->len();
+        return (_options.useDocumentSequences ? _docSeqBuilder->len() : _batch->len()) +
+            _sharedBytes;
     }
 
     void append(const BSONObj& obj) {
         invariant(_active);
-        if (_options.useDocumentSequences) {
+        if (_sharedObjectBuilder && obj.isOwned() && obj.objsize() >= kMinSharedObjectSize) {
+            _appendShared(obj);
+        } else if (_options.useDocumentSequences) {
             _docSeqBuilder->append(obj);
         } else {
             _batch->append(obj);
@@ -114,8 +124,11 @@ public:
     void abandon();
 
 private:
+    void _appendShared(const BSONObj& obj);
+
     const Options _options;
     rpc::ReplyBuilderInterface* const _replyBuilder;
+    OpMsgBuilder* const _sharedObjectBuilder;
     // Order here is important to ensure destruction in the correct order.
     boost::optional<BSONObjBuilder> _bodyBuilder;
     boost::optional<BSONObjBuilder> _cursorObject;
@@ -124,6 +137,8 @@ private:
 
     bool _active = true;
     long long _numDocs = 0;
+    // Bytes of referenced documents beyond the placeholders that stand for them in the buffer.
+    size_t _sharedBytes = 0;
     Timestamp _latestOplogTimestamp;
     BSONObj _postBatchResumeToken;
 };
@@ -29,6 +29,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/db/query/cursor_response.h"
 
 #include "mongo/rpc/op_msg_rpc_impls.h"
@@ -389,6 +391,35 @@ TEST(CursorResponseTest, cursorReturnDocumentSequences) {
     ASSERT_BSONOBJ_EQ(opMsg.body, expectedBody);
 }
 
+TEST(CursorResponseTest, cursorReferencesLargeDocuments) {
+    rpc::OpMsgReplyBuilder builder(rpc::OpMsgReplyBuilder::SharedObjects::kAllow);
+    BSONObj smallDoc = BSON("_id" << 1);
+    BSONObj largeDoc =
+        BSON("_id" << 2 << "pad" << std::string(CursorResponseBuilder::kMinSharedObjectSize, 'x'));
+
+    CursorResponseBuilder crb(&builder, CursorResponseBuilder::Options());
+    crb.append(smallDoc);
+    crb.append(largeDoc);
+    crb.append(smallDoc);
+    ASSERT_GT(crb.bytesUsed(), size_t(largeDoc.objsize()));
+    crb.done(CursorId(123), "db.coll");
+    builder.getBodyBuilder().append("ok", 1.0);
+
+    auto msg = builder.done();
+    ASSERT(msg.isSegmented());
+    ASSERT(std::any_of(msg.segments().begin(), msg.segments().end(), [&](const auto& segment) {
+        return segment.data == largeDoc.objdata();
+    }));
+
+    auto opMsg = OpMsg::parse(msg);
+    auto response = unittest::assertGet(CursorResponse::parseFromBSON(opMsg.body));
+    ASSERT_EQ(response.getCursorId(), CursorId(123));
+    ASSERT_EQ(response.getBatch().size(), 3U);
+    ASSERT_BSONOBJ_EQ(response.getBatch()[0], smallDoc);
+    ASSERT_BSONOBJ_EQ(response.getBatch()[1], largeDoc);
+    ASSERT_BSONOBJ_EQ(response.getBatch()[2], smallDoc);
+}
+
 }  // namespace
 
 }  // namespace mongo
@@ -51,6 +51,9 @@ MONGO_FAIL_POINT_DEFINE(waitBeforeUnpinningOrDeletingCursorAfterGetMoreBatch);
 const OperationContext::Decoration<AwaitDataState> awaitDataState =
     OperationContext::declareDecoration<AwaitDataState>();
 
+const OperationContext::Decoration<bool> replyIsStreamed =
+    OperationContext::declareDecoration<bool>();
+
 bool FindCommon::enoughForFirstBatch(const QueryRequest& qr, long long numDocs) {
     if (!qr.getEffectiveBatchSize()) {
         // We enforce a default batch size for the initial find if no batch size is specified.
@@ -60,7 +63,10 @@ bool FindCommon::enoughForFirstBatch(const QueryRequest& qr, long long numDocs)
     return numDocs >= qr.getEffectiveBatchSize().value();
 }
 
-bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int bytesBuffered) {
+bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc,
+                                  long long numDocs,
+                                  int bytesBuffered,
+                                  int maxBytes) {
     invariant(numDocs >= 0);
     if (!numDocs) {
         // Allow the first output document to exceed the limit to ensure we can always make
@@ -68,7 +74,7 @@ bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int
         return true;
     }
 
-    return (bytesBuffered + nextDoc.objsize()) <= kMaxBytesToReturnToClientAtOnce;
+    return (bytesBuffered + nextDoc.objsize()) <= maxBytes;
 }
 
 BSONObj FindCommon::transformSortSpec(const BSONObj& sortSpec) {
@@ -52,6 +52,13 @@ struct AwaitDataState {
 
 extern const OperationContext::Decoration<AwaitDataState> awaitDataState;
 
+/**
+ * True if the reply to this operation is part of an exhaust stream, in which the server sends the
+ * next reply with the 'moreToCome' flag set instead of waiting for another request. A getMore in
+ * such a stream may return a smaller batch, since the rest of the results follow right after it.
+ */
+extern const OperationContext::Decoration<bool> replyIsStreamed;
+
 class BSONObj;
 class QueryRequest;
 
@@ -111,9 +118,12 @@ public:
     /**
      * Given the number of docs ('numDocs') and bytes ('bytesBuffered') currently buffered as a
      * response to a cursor-generating command, returns true if there are enough remaining bytes in
-     * our budget to fit 'nextDoc'.
+     * our budget of 'maxBytes' to fit 'nextDoc'.
      */
-    static bool haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int bytesBuffered);
+    static bool haveSpaceForNext(const BSONObj& nextDoc,
+                                 long long numDocs,
+                                 int bytesBuffered,
+                                 int maxBytes = kMaxBytesToReturnToClientAtOnce);
 
     /**
      * Transforms the raw sort spec into one suitable for use as the ordering specification in
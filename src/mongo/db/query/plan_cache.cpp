@@ -353,9 +353,22 @@ std::string SolutionCacheData::toString() const {
 
 PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+PlanCache::PlanCache(size_t size) {
+    // Give every shard enough entries that a small cache keeps a close approximation of LRU.
+    const size_t kMinEntriesPerShard = 64;
+    const size_t numShards = std::max<size_t>(
+        1, std::min<size_t>(internalQueryCacheNumShards.load(), size / kMinEntriesPerShard));
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+    for (size_t i = 0; i < numShards; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->capacity = size / numShards + (i < size % numShards ? 1 : 0);
+        _shards.push_back(std::move(shard));
+    }
+}
+
+PlanCache::PlanCache(const std::string& ns) : PlanCache(internalQueryCacheSize.load()) {
+    _ns = ns;
+}
 
 PlanCache::~PlanCache() {}
 
@@ -380,7 +393,7 @@ std::unique_ptr<CachedSolution> PlanCache::getCacheEntryIfActive(const PlanCache
 PlanCache::NewEntryState PlanCache::getNewEntryState(const CanonicalQuery& query,
                                                      uint32_t queryHash,
                                                      uint32_t planCacheKey,
-                                                     PlanCacheEntry* oldEntry,
+                                                     const PlanCacheEntry* oldEntry,
                                                      size_t newWorks,
                                                      double growthCoefficient) {
     NewEntryState res;
@@ -429,7 +442,7 @@ PlanCache::NewEntryState PlanCache::getNewEntryState(const CanonicalQuery& query
                << unsignedIntToFixedLengthHex(queryHash) << " planCacheKey "
                << unsignedIntToFixedLengthHex(planCacheKey) << " from " << oldEntry->works << " to "
                << increasedWorks;
-        oldEntry->works = increasedWorks;
+        res.increasedWorks = increasedWorks;
 
         // Don't create a new entry.
         res.shouldBeCreated = false;
@@ -476,7 +489,8 @@ Status PlanCache::set(const CanonicalQuery& query,
 
     const auto key = computeKey(query);
     const size_t newWorks = why->stats[0]->common.works;
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Shard& shard = shardFor(key);
+    stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
     bool isNewEntryActive = false;
     uint32_t queryHash;
     uint32_t planCacheKey;
@@ -486,9 +500,8 @@ Status PlanCache::set(const CanonicalQuery& query,
         planCacheKey = canonical_query_encoder::computeHash(key.stringData());
         queryHash = canonical_query_encoder::computeHash(key.getStableKeyStringData());
     } else {
-        PlanCacheEntry* oldEntry = nullptr;
-        Status cacheStatus = _cache.get(key, &oldEntry);
-        invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
+        const auto oldSlot = findSlot(shardLock, shard, key);
+        const PlanCacheEntry* oldEntry = oldSlot ? oldSlot->entry.get() : nullptr;
         if (oldEntry) {
             queryHash = oldEntry->queryHash;
             planCacheKey = oldEntry->planCacheKey;
@@ -505,6 +518,12 @@ Status PlanCache::set(const CanonicalQuery& query,
             newWorks,
             worksGrowthCoefficient.get_value_or(internalQueryCacheWorksGrowthCoefficient));
 
+        if (newState.increasedWorks) {
+            std::unique_ptr<PlanCacheEntry> updatedEntry(oldEntry->clone());
+            updatedEntry->works = *newState.increasedWorks;
+            addSlot(shardLock, &shard, key, std::move(updatedEntry));
+        }
+
         if (!newState.shouldBeCreated) {
             return Status::OK();
         }
@@ -533,11 +552,11 @@ Status PlanCache::set(const CanonicalQuery& query,
     }
     newEntry->projection = projBuilder.obj();
 
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
+    const auto evictedSlot = addSlot(shardLock, &shard, key, std::move(newEntry));
 
-    if (NULL != evictedEntry.get()) {
+    if (evictedSlot) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
-               << "removed least recently used entry " << redact(evictedEntry->toString());
+               << "removed least recently used entry " << redact(evictedSlot->entry->toString());
     }
 
     return Status::OK();
@@ -550,15 +569,17 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
     }
 
     PlanCacheKey key = computeKey(query);
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
-    if (!cacheStatus.isOK()) {
-        invariant(cacheStatus == ErrorCodes::NoSuchKey);
+    Shard& shard = shardFor(key);
+    stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+    const auto slot = findSlot(shardLock, shard, key);
+    if (!slot) {
         return;
     }
-    invariant(entry);
-    entry->isActive = false;
+
+    // Entries are not modified in place, since readers may be copying from them.
+    std::unique_ptr<PlanCacheEntry> inactiveEntry(slot->entry->clone());
+    inactiveEntry->isActive = false;
+    addSlot(shardLock, &shard, key, std::move(inactiveEntry));
 }
 
 PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
@@ -567,47 +588,58 @@ PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
 }
 
 PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
-    if (!cacheStatus.isOK()) {
-        invariant(cacheStatus == ErrorCodes::NoSuchKey);
+    std::shared_ptr<CacheSlot> slot;
+    {
+        Shard& shard = shardFor(key);
+        stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+        slot = findSlot(shardLock, shard, key);
+    }
+    if (!slot) {
         return {CacheEntryState::kNotPresent, nullptr};
     }
-    invariant(entry);
 
+    // The slot keeps the entry alive, and the fields copied here are never modified once the entry
+    // is in the cache, so the copy is made without holding the shard's mutex.
+    const PlanCacheEntry& entry = *slot->entry;
     auto state =
-        entry->isActive ? CacheEntryState::kPresentActive : CacheEntryState::kPresentInactive;
-    return {state, stdx::make_unique<CachedSolution>(key, *entry)};
+        entry.isActive ? CacheEntryState::kPresentActive : CacheEntryState::kPresentInactive;
+    return {state, stdx::make_unique<CachedSolution>(key, entry)};
 }
 
 Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
     PlanCacheKey ck = computeKey(cq);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
-    if (!cacheStatus.isOK()) {
-        return cacheStatus;
+    Shard& shard = shardFor(ck);
+    stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+    const auto slot = findSlot(shardLock, shard, ck);
+    if (!slot) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in plan cache");
     }
-    invariant(entry);
 
     // We store up to a constant number of feedback entries.
-    if (entry->feedback.size() < static_cast<size_t>(internalQueryCacheFeedbacksStored.load())) {
-        entry->feedback.push_back(score);
+    auto& feedback = slot->entry->feedback;
+    if (feedback.size() < static_cast<size_t>(internalQueryCacheFeedbacksStored.load())) {
+        feedback.push_back(score);
     }
 
     return Status::OK();
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    const auto key = computeKey(canonicalQuery);
+    Shard& shard = shardFor(key);
+    stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+    if (!shard.slots.erase(key)) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in plan cache");
+    }
+    return Status::OK();
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> shardLock(shard->mutex);
+        shard->slots.clear();
+    }
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -621,32 +653,36 @@ PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
 StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
-    if (!cacheStatus.isOK()) {
-        return cacheStatus;
+    Shard& shard = shardFor(key);
+    stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+    const auto slot = findSlot(shardLock, shard, key);
+    if (!slot) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in plan cache");
     }
-    invariant(entry);
 
-    return std::unique_ptr<PlanCacheEntry>(entry->clone());
+    return std::unique_ptr<PlanCacheEntry>(slot->entry->clone());
 }
 
 std::vector<std::unique_ptr<PlanCacheEntry>> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<std::unique_ptr<PlanCacheEntry>> entries;
 
-    for (auto&& cacheEntry : _cache) {
-        auto entry = cacheEntry.second;
-        entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> shardLock(shard->mutex);
+        for (auto&& slot : shard->slots) {
+            entries.push_back(std::unique_ptr<PlanCacheEntry>(slot.second->entry->clone()));
+        }
     }
 
     return entries;
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t total = 0;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> shardLock(shard->mutex);
+        total += shard->slots.size();
+    }
+    return total;
 }
 
 void PlanCache::notifyOfIndexUpdates(const std::vector<CoreIndexInfo>& indexCores) {
@@ -657,17 +693,55 @@ std::vector<BSONObj> PlanCache::getMatchingStats(
     const std::function<BSONObj(const PlanCacheEntry&)>& serializationFunc,
     const std::function<bool(const BSONObj&)>& filterFunc) const {
     std::vector<BSONObj> results;
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
 
-    for (auto&& cacheEntry : _cache) {
-        const auto entry = cacheEntry.second;
-        auto serializedEntry = serializationFunc(*entry);
-        if (filterFunc(serializedEntry)) {
-            results.push_back(serializedEntry);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> shardLock(shard->mutex);
+        for (auto&& slot : shard->slots) {
+            auto serializedEntry = serializationFunc(*slot.second->entry);
+            if (filterFunc(serializedEntry)) {
+                results.push_back(serializedEntry);
+            }
         }
     }
 
     return results;
 }
 
+PlanCache::Shard& PlanCache::shardFor(const PlanCacheKey& key) const {
+    return *_shards[PlanCacheKeyHasher{}(key) % _shards.size()];
+}
+
+std::shared_ptr<PlanCache::CacheSlot> PlanCache::findSlot(WithLock,
+                                                          const Shard& shard,
+                                                          const PlanCacheKey& key) {
+    auto it = shard.slots.find(key);
+    if (it == shard.slots.end()) {
+        return nullptr;
+    }
+    it->second->lastAccess.store(shard.accessClock.addAndFetch(1));
+    return it->second;
+}
+
+std::shared_ptr<PlanCache::CacheSlot> PlanCache::addSlot(WithLock,
+                                                         Shard* shard,
+                                                         const PlanCacheKey& key,
+                                                         std::unique_ptr<PlanCacheEntry> entry) {
+    auto slot = std::make_shared<CacheSlot>(std::move(entry), shard->accessClock.addAndFetch(1));
+    shard->slots[key] = std::move(slot);
+    if (shard->slots.size() <= shard->capacity) {
+        return nullptr;
+    }
+
+    // Inserts only happen after multi-planning, which costs far more than this scan of the shard.
+    auto victim = std::min_element(shard->slots.begin(),
+                                   shard->slots.end(),
+                                   [](const auto& lhs, const auto& rhs) {
+                                       return lhs.second->lastAccess.load() <
+                                           rhs.second->lastAccess.load();
+                                   });
+    auto evictedSlot = std::move(victim->second);
+    shard->slots.erase(victim);
+    return evictedSlot;
+}
+
 }  // namespace mongo
@@ -35,11 +35,13 @@
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/index_tag.h"
-#include "mongo/db/query/lru_key_value.h"
 #include "mongo/db/query/plan_cache_indexability.h"
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/new.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
 
 namespace mongo {
 
@@ -351,6 +353,12 @@ public:
  * Caches the best solution to a query.  Aside from the (CanonicalQuery -> QuerySolution)
  * mapping, the cache contains information on why that mapping was made and statistics on the
  * cache entry's actual performance on subsequent runs.
+ *
+ * The cache is split into shards by the hash of the PlanCacheKey, each with its own mutex, so that
+ * lookups for different query shapes rarely contend. A lookup holds its shard's mutex only while
+ * it finds the entry. Recency is recorded with an atomic store and the cached plan is copied after
+ * the mutex is released. When a shard is full, the entry with the oldest recorded access is
+ * evicted, which is an approximation of LRU for the cache as a whole.
  */
 class PlanCache {
 private:
@@ -534,19 +542,68 @@ private:
     struct NewEntryState {
         bool shouldBeCreated = false;
         bool shouldBeActive = false;
+
+        // Set when no entry should be created, but the 'works' of the existing inactive entry
+        // should be raised to this value.
+        boost::optional<size_t> increasedWorks;
     };
 
     NewEntryState getNewEntryState(const CanonicalQuery& query,
                                    uint32_t queryHash,
                                    uint32_t planCacheKey,
-                                   PlanCacheEntry* oldEntry,
+                                   const PlanCacheEntry* oldEntry,
                                    size_t newWorks,
                                    double growthCoefficient);
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
+    /**
+     * A PlanCacheEntry together with the time of its most recent use. Apart from its 'feedback',
+     * an entry is never modified after it is added to the cache. Changes are made to a copy which
+     * then replaces the slot, so that readers can copy out of an entry without holding a lock.
+     */
+    struct CacheSlot {
+        CacheSlot(std::unique_ptr<PlanCacheEntry> entry, unsigned long long lastAccess)
+            : entry(std::move(entry)), lastAccess(lastAccess) {}
+
+        const std::unique_ptr<PlanCacheEntry> entry;
+
+        // The value of the shard's 'accessClock' when the entry was last looked up.
+        AtomicWord<unsigned long long> lastAccess;
+    };
+
+    struct alignas(stdx::hardware_destructive_interference_size) Shard {
+        // Protects 'slots' and the 'feedback' of the entries in it.
+        mutable stdx::mutex mutex;
+
+        stdx::unordered_map<PlanCacheKey, std::shared_ptr<CacheSlot>, PlanCacheKeyHasher> slots;
+
+        // Maximum number of entries in this shard.
+        size_t capacity = 0;
+
+        // Ticks once per lookup. Used to order the entries in the shard by recency.
+        mutable AtomicWord<unsigned long long> accessClock{0};
+    };
+
+    Shard& shardFor(const PlanCacheKey& key) const;
+
+    /**
+     * Returns the slot for 'key' in 'shard' and marks it as the most recently used, or returns
+     * nullptr if there is none.
+     */
+    static std::shared_ptr<CacheSlot> findSlot(WithLock,
+                                               const Shard& shard,
+                                               const PlanCacheKey& key);
+
+    /**
+     * Stores 'entry' under 'key' in 'shard', replacing any existing entry. If the shard is over
+     * capacity afterwards, evicts and returns the slot of its least recently used entry.
+     */
+    static std::shared_ptr<CacheSlot> addSlot(WithLock,
+                                              Shard* shard,
+                                              const PlanCacheKey& key,
+                                              std::unique_ptr<PlanCacheEntry> entry);
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    // Fixed at construction, so looking up a shard needs no synchronization.
+    std::vector<std::unique_ptr<Shard>> _shards;
 
     // Full namespace of collection.
     std::string _ns;
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxThreads = 64;
+
+// Number of distinct query shapes in the cache. The threads cycle through all of them, so that
+// lookups are spread over the shards as they would be for a mixed workload.
+const int kNumShapes = 1000;
+
+const NamespaceString kNss("test.collection");
+
+std::unique_ptr<PlanCache> planCache;
+std::vector<std::unique_ptr<CanonicalQuery>> queries;
+std::vector<PlanCacheKey> keys;
+
+std::unique_ptr<PlanRankingDecision> createDecision() {
+    auto why = std::make_unique<PlanRankingDecision>();
+    auto stats = std::make_unique<PlanStageStats>(CommonStats("COLLSCAN"), STAGE_COLLSCAN);
+    stats->specific = std::make_unique<CollectionScanStats>();
+    why->stats.push_back(std::move(stats));
+    why->scores.push_back(0U);
+    why->candidateOrder.push_back(0);
+    return why;
+}
+
+/**
+ * Creates a plan cache split into 'numShards' shards which holds an active entry for each of
+ * 'kNumShapes' query shapes.
+ */
+void populatePlanCache(int numShards) {
+    const int oldNumShards = internalQueryCacheNumShards.load();
+    internalQueryCacheNumShards.store(numShards);
+    ON_BLOCK_EXIT([oldNumShards] { internalQueryCacheNumShards.store(oldNumShards); });
+
+    planCache = std::make_unique<PlanCache>(internalQueryCacheSize.load());
+
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    for (int i = 0; i < kNumShapes; ++i) {
+        auto qr = std::make_unique<QueryRequest>(kNss);
+        qr->setFilter(BSON("a" + std::to_string(i) << 1));
+        queries.push_back(
+            uassertStatusOK(CanonicalQuery::canonicalize(opCtx.get(), std::move(qr))));
+
+        auto qs = std::make_unique<QuerySolution>();
+        qs->cacheData = std::make_unique<SolutionCacheData>();
+        qs->cacheData->tree = std::make_unique<PlanCacheIndexTree>();
+        std::vector<QuerySolution*> solns = {qs.get()};
+
+        // The first set() creates an inactive entry and the second one activates it.
+        for (int j = 0; j < 2; ++j) {
+            uassertStatusOK(planCache->set(*queries.back(), solns, createDecision(), Date_t{}));
+        }
+        keys.push_back(planCache->computeKey(*queries.back()));
+    }
+}
+
+void clearPlanCache() {
+    keys.clear();
+    queries.clear();
+    planCache.reset();
+}
+
+void BM_PlanCacheGetByKey(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        populatePlanCache(state.range(0));
+    }
+
+    size_t i = state.thread_index * (kNumShapes / kMaxThreads);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(planCache->get(keys[i++ % kNumShapes]));
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index == 0) {
+        clearPlanCache();
+    }
+}
+
+void BM_PlanCacheGetByQuery(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        populatePlanCache(state.range(0));
+    }
+
+    // Includes computing the key, as the query planner does for every cacheable query.
+    size_t i = state.thread_index * (kNumShapes / kMaxThreads);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(planCache->get(*queries[i++ % kNumShapes]));
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index == 0) {
+        clearPlanCache();
+    }
+}
+
+void BM_PlanCacheGetSameShape(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        populatePlanCache(state.range(0));
+    }
+
+    // Every thread looks up the same shape, so they all contend on a single shard.
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(planCache->get(keys[0]));
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index == 0) {
+        clearPlanCache();
+    }
+}
+
+// The argument is the number of shards. A single shard behaves like the unsharded cache.
+BENCHMARK(BM_PlanCacheGetByKey)->Arg(1)->Arg(16)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK(BM_PlanCacheGetByQuery)->Arg(1)->Arg(16)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK(BM_PlanCacheGetSameShape)->Arg(1)->Arg(16)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
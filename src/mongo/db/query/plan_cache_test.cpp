@@ -565,6 +565,34 @@ TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
 }
 
+TEST(PlanCacheTest, ShardedPlanCacheEvictsLeastRecentlyUsedPerShard) {
+    const int oldNumShards = internalQueryCacheNumShards.load();
+    internalQueryCacheNumShards.store(4);
+    ON_BLOCK_EXIT([oldNumShards] { internalQueryCacheNumShards.store(oldNumShards); });
+
+    // Large enough to be split into four shards.
+    const size_t kCacheSize = 256;
+    PlanCache planCache(kCacheSize);
+    QueryTestServiceContext serviceContext;
+
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (size_t i = 0; i < 2 * kCacheSize; ++i) {
+        const std::string query = str::stream() << "{a" << i << ": 1}";
+        queries.push_back(canonicalize(query.c_str()));
+        addCacheEntryForShape(*queries.back(), &planCache);
+        ASSERT_LTE(planCache.size(), kCacheSize);
+
+        // The first shape is looked up after every insert, so it is never the least recently
+        // used entry in its shard.
+        ASSERT_EQ(planCache.get(*queries.front()).state,
+                  PlanCache::CacheEntryState::kPresentInactive);
+    }
+
+    // Every shard has been filled, and the newest shape is still cached.
+    ASSERT_EQ(planCache.size(), kCacheSize);
+    ASSERT_EQ(planCache.get(*queries.back()).state, PlanCache::CacheEntryState::kPresentInactive);
+}
+
 TEST(PlanCacheTest, PlanCacheRemoveDeletesInactiveEntries) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
@@ -35,13 +35,20 @@
 
 #include "mongo/base/counter.h"
 #include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/op_msg.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -52,6 +59,15 @@ Counter64 readersCreatedStats;
 ServerStatusMetricField<Counter64> displayReadersCreated("repl.network.readersCreated",
                                                          &readersCreatedStats);
 
+// Requests sent while reading the oplog over an exhaust cursor, and batches which the sync source
+// streamed without being asked.
+Counter64 exhaustRequestsStats;
+ServerStatusMetricField<Counter64> displayExhaustRequests("repl.network.exhaust.requests",
+                                                          &exhaustRequestsStats);
+Counter64 exhaustStreamedBatchesStats;
+ServerStatusMetricField<Counter64> displayExhaustStreamedBatches(
+    "repl.network.exhaust.streamedBatches", &exhaustStreamedBatchesStats);
+
 // Number of seconds for the `maxTimeMS` on the initial `find` command.
 //
 // For the initial 'find' request, we provide a generous timeout, to account for the potentially
@@ -90,6 +106,13 @@ AbstractOplogFetcher::AbstractOplogFetcher(executor::TaskExecutor* executor,
     invariant(onShutdownCallbackFn);
 }
 
+AbstractOplogFetcher::~AbstractOplogFetcher() {
+    // The stream thread may still be returning from _finishCallback.
+    if (_streamThread.joinable()) {
+        _streamThread.join();
+    }
+}
+
 Milliseconds AbstractOplogFetcher::_getInitialFindMaxTime() const {
     return Milliseconds(oplogInitialFindMaxSeconds.load() * 1000);
 }
@@ -102,6 +125,10 @@ Milliseconds AbstractOplogFetcher::_getGetMoreMaxTime() const {
     return kDefaultOplogGetMoreMaxMS;
 }
 
+bool AbstractOplogFetcher::_useExhaustStream() const {
+    return false;
+}
+
 std::string AbstractOplogFetcher::toString() const {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     str::stream msg;
@@ -111,6 +138,9 @@ std::string AbstractOplogFetcher::toString() const {
     if (_fetcher) {
         msg << " fetcher: " << _fetcher->getDiagnosticString();
     }
+    if (_streamThread.joinable()) {
+        msg << " exhaust stream from: " << _source;
+    }
     return msg;
 }
 
@@ -129,6 +159,10 @@ void AbstractOplogFetcher::_makeAndScheduleFetcherCallback(
     Status scheduleStatus = Status::OK();
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (_useExhaustStream()) {
+            _startExhaustStream_inlock(findCommandObj, metadataObj, _getInitialFindMaxTime());
+            return;
+        }
         _fetcher = _makeFetcher(findCommandObj, metadataObj, _getInitialFindMaxTime());
         scheduleStatus = _scheduleFetcher_inlock();
     }
@@ -152,6 +186,9 @@ void AbstractOplogFetcher::_doShutdown_inlock() noexcept {
     if (_fetcher) {
         _fetcher->shutdown();
     }
+    if (_streamConnection) {
+        _streamConnection->shutdownAndDisallowReconnect();
+    }
 }
 
 stdx::mutex* AbstractOplogFetcher::_getMutex() noexcept {
@@ -245,30 +282,37 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
         _fetcherRestarts = 0;
     }
 
+    Status finalStatus = Status::OK();
+    if (!_processSuccessfulBatch(result.getValue(), getMoreBob, &finalStatus)) {
+        _finishCallback(finalStatus);
+    }
+}
+
+bool AbstractOplogFetcher::_processSuccessfulBatch(const Fetcher::QueryResponse& queryResponse,
+                                                   BSONObjBuilder* getMoreBob,
+                                                   Status* finalStatus) {
     if (_isShuttingDown()) {
-        _finishCallback(
-            Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down"));
-        return;
+        *finalStatus = Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down");
+        return false;
     }
 
     // At this point we have a successful batch and can call the subclass's _onSuccessfulBatch.
-    const auto& queryResponse = result.getValue();
     auto batchResult = _onSuccessfulBatch(queryResponse);
     if (!batchResult.isOK()) {
         // The stopReplProducer fail point expects this to return successfully. If another fail
         // point wants this to return unsuccessfully, it should use a different error code.
         if (batchResult.getStatus() == ErrorCodes::FailPointEnabled) {
-            _finishCallback(Status::OK());
-            return;
+            *finalStatus = Status::OK();
+            return false;
         }
-        _finishCallback(batchResult.getStatus());
-        return;
+        *finalStatus = batchResult.getStatus();
+        return false;
     }
 
     // No more data. Stop processing and return Status::OK.
     if (!getMoreBob) {
-        _finishCallback(Status::OK());
-        return;
+        *finalStatus = Status::OK();
+        return false;
     }
 
     // We have now processed the batch and should move forward our view of _lastFetched. Note that
@@ -278,8 +322,8 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
     if (documents.size() > 0) {
         auto lastDocRes = OpTime::parseFromOplogEntry(documents.back());
         if (!lastDocRes.isOK()) {
-            _finishCallback(lastDocRes.getStatus());
-            return;
+            *finalStatus = lastDocRes.getStatus();
+            return false;
         }
         auto lastDoc = lastDocRes.getValue();
         LOG(3) << _getComponentName()
@@ -291,13 +335,165 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
 
     // Check for shutdown to save an unnecessary `getMore` request.
     if (_isShuttingDown()) {
-        _finishCallback(
-            Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down"));
-        return;
+        *finalStatus = Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down");
+        return false;
     }
 
     // The _onSuccessfulBatch function returns the `getMore` command we want to send.
     getMoreBob->appendElements(batchResult.getValue());
+    return true;
+}
+
+void AbstractOplogFetcher::_startExhaustStream_inlock(BSONObj findCommandObj,
+                                                      BSONObj metadataObj,
+                                                      Milliseconds findMaxTime) {
+    invariant(!_streamThread.joinable());
+    readersCreatedStats.increment();
+    _streamThread = stdx::thread([this, findCommandObj, metadataObj, findMaxTime] {
+        _runExhaustStream(findCommandObj, metadataObj, findMaxTime);
+    });
+}
+
+void AbstractOplogFetcher::_runExhaustStream(BSONObj findCommandObj,
+                                             BSONObj metadataObj,
+                                             Milliseconds findMaxTime) {
+    Client::initThread("ExhaustOplogFetcher");
+
+    Status finalStatus = Status::OK();
+    while (true) {
+        auto streamStatus =
+            _readExhaustStream(findCommandObj, metadataObj, findMaxTime, &finalStatus);
+        if (streamStatus.isOK()) {
+            break;
+        }
+
+        if (_isShuttingDown()) {
+            LOG(1) << _getComponentName() << " oplog query cancelled to " << _getSource() << ": "
+                   << redact(streamStatus);
+            finalStatus =
+                Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down");
+            break;
+        }
+
+        findMaxTime = _getRetriedFindMaxTime();
+        findCommandObj = _makeFindCommandObject(_nss, _getLastOpTimeFetched(), findMaxTime);
+        metadataObj = _makeMetadataObject();
+
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (_fetcherRestarts == _maxFetcherRestarts) {
+            log() << "Error returned from oplog query (no more query restarts left): "
+                  << redact(streamStatus);
+            finalStatus = streamStatus;
+            break;
+        }
+        log() << "Restarting oplog query due to error: " << redact(streamStatus)
+              << ". Last fetched optime: " << _lastFetched
+              << ". Restarts remaining: " << (_maxFetcherRestarts - _fetcherRestarts);
+        _fetcherRestarts++;
+        readersCreatedStats.increment();
+    }
+
+    _finishCallback(finalStatus);
+}
+
+Status AbstractOplogFetcher::_readExhaustStream(const BSONObj& findCommandObj,
+                                                const BSONObj& metadataObj,
+                                                Milliseconds findMaxTime,
+                                                Status* finalStatus) {
+    // An awaitData cursor on the oplog sends a batch, possibly empty, at least once per `getMore`
+    // timeout, so a longer silence means the sync source is gone.
+    const auto socketTimeout =
+        std::max(findMaxTime, _getGetMoreMaxTime()) + kNetworkTimeoutBufferMS;
+    auto connection = stdx::make_unique<DBClientConnection>(
+        false /* autoReconnect */, durationCount<Milliseconds>(socketTimeout) / 1000.0);
+    auto conn = connection.get();
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (_isShuttingDown_inlock()) {
+            *finalStatus =
+                Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down");
+            return Status::OK();
+        }
+        _streamConnection = std::move(connection);
+    }
+    ON_BLOCK_EXIT([this] {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _streamConnection.reset();
+    });
+
+    try {
+        auto status = conn->connect(_source, StringData());
+        if (!status.isOK()) {
+            return status;
+        }
+        if (!replAuthenticate(conn)) {
+            return {ErrorCodes::AuthenticationFailed,
+                    str::stream() << "Failed to authenticate to " << _source};
+        }
+
+        Message request =
+            OpMsgRequest::fromDBAndBody(_nss.db(), findCommandObj, metadataObj).serialize();
+        Message reply;
+        Timer timer;
+        exhaustRequestsStats.increment();
+        conn->call(request, reply, true /* assertOk */, nullptr);
+
+        for (bool first = true;; first = false) {
+            auto replyObj = OpMsg::parse(reply).body;
+            status = getStatusFromCommandResult(replyObj);
+            if (!status.isOK()) {
+                return status;
+            }
+            auto cursorResponse = CursorResponse::parseFromBSON(replyObj);
+            if (!cursorResponse.isOK()) {
+                return cursorResponse.getStatus();
+            }
+
+            Fetcher::QueryResponse queryResponse;
+            queryResponse.cursorId = cursorResponse.getValue().getCursorId();
+            queryResponse.nss = cursorResponse.getValue().getNSS();
+            queryResponse.documents = cursorResponse.getValue().releaseBatch();
+            queryResponse.otherFields.metadata = replyObj;
+            queryResponse.elapsedMillis = Milliseconds(timer.millis());
+            queryResponse.first = first;
+
+            // Reset fetcher restart counter on successful response.
+            {
+                stdx::lock_guard<stdx::mutex> lock(_mutex);
+                invariant(_isActive_inlock());
+                _fetcherRestarts = 0;
+            }
+
+            BSONObjBuilder getMoreBob;
+            if (!_processSuccessfulBatch(
+                    queryResponse, queryResponse.cursorId ? &getMoreBob : nullptr, finalStatus)) {
+                return Status::OK();
+            }
+
+            timer.reset();
+            if (OpMsg::isFlagSet(reply, OpMsg::kMoreToCome)) {
+                // The sync source sends the next batch without waiting to be asked. Each reply in
+                // the stream answers the one before it.
+                const auto lastReplyId = reply.header().getId();
+                if (!conn->recv(reply, lastReplyId)) {
+                    return {ErrorCodes::HostUnreachable,
+                            str::stream() << "Lost oplog exhaust stream from " << _source};
+                }
+                exhaustStreamedBatchesStats.increment();
+                continue;
+            }
+
+            // This is either the reply to the `find`, which cannot start an exhaust stream, or the
+            // sync source chose not to stream. Ask for the next batch, offering to take a stream.
+            request = OpMsgRequest::fromDBAndBody(_nss.db(), getMoreBob.obj(), metadataObj)
+                          .serialize();
+            OpMsg::setFlag(&request, OpMsg::kExhaustSupported);
+            exhaustRequestsStats.increment();
+            conn->call(request, reply, true /* assertOk */, nullptr);
+        }
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
 }
 
 void AbstractOplogFetcher::_finishCallback(Status status) {
@@ -31,12 +31,14 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
+#include "mongo/client/dbclient_connection.h"
 #include "mongo/client/fetcher.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/abstract_async_component.h"
 #include "mongo/db/repl/optime_with.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
 namespace repl {
@@ -49,6 +51,12 @@ namespace repl {
  *
  * The `find` command and metadata are provided by oplog fetchers that subclass the abstract oplog
  * fetcher. Subclasses also provide a callback to run on successful batches.
+ *
+ * Subclasses may instead ask for the oplog to be read over an exhaust cursor. In that mode a
+ * dedicated thread holds one connection to the sync source, which streams each batch as soon as the
+ * previous one has been sent rather than waiting for a `getMore` round trip. The thread stops
+ * reading from the connection while the subclass callback blocks, for instance waiting for space in
+ * the oplog buffer, which throttles the sync source through TCP flow control.
  */
 class AbstractOplogFetcher : public AbstractAsyncComponent {
     MONGO_DISALLOW_COPYING(AbstractOplogFetcher);
@@ -77,7 +85,7 @@ public:
                          OnShutdownCallbackFn onShutdownCallbackFn,
                          const std::string& componentName);
 
-    virtual ~AbstractOplogFetcher() = default;
+    virtual ~AbstractOplogFetcher();
 
     std::string toString() const;
 
@@ -119,6 +127,12 @@ protected:
      */
     virtual Milliseconds _getGetMoreMaxTime() const;
 
+    /**
+     * Returns true if the oplog should be read over an exhaust cursor rather than through a
+     * Fetcher issuing one `getMore` per batch.
+     */
+    virtual bool _useExhaustStream() const;
+
     /**
      * Returns the sync source from which this oplog fetcher is fetching.
      */
@@ -197,6 +211,44 @@ private:
      */
     void _callback(const Fetcher::QueryResponseStatus& result, BSONObjBuilder* getMoreBob);
 
+    /**
+     * Hands a successful batch to the subclass and moves '_lastFetched' forward. Used by both the
+     * Fetcher and the exhaust stream.
+     *
+     * Returns true and fills in 'getMoreBob' if fetching should continue. Otherwise returns false
+     * and sets 'finalStatus' to the status to pass to _finishCallback. A null 'getMoreBob' means
+     * the sync source has no more results.
+     */
+    bool _processSuccessfulBatch(const Fetcher::QueryResponse& queryResponse,
+                                 BSONObjBuilder* getMoreBob,
+                                 Status* finalStatus);
+
+    /**
+     * Starts the thread which reads the oplog over an exhaust cursor.
+     */
+    void _startExhaustStream_inlock(BSONObj findCommandObj,
+                                    BSONObj metadataObj,
+                                    Milliseconds findMaxTime);
+
+    /**
+     * Body of the exhaust stream thread. Reads from the sync source until fetching is over,
+     * reopening the cursor from the last fetched entry on errors like the Fetcher path does, and
+     * then calls _finishCallback.
+     */
+    void _runExhaustStream(BSONObj findCommandObj, BSONObj metadataObj, Milliseconds findMaxTime);
+
+    /**
+     * Connects to the sync source, issues the `find` command and tails the resulting cursor with
+     * exhaust `getMore` requests.
+     *
+     * A non-OK return means the stream broke and may be reopened. An OK return means fetching is
+     * over and 'finalStatus' holds the status to pass to _finishCallback.
+     */
+    Status _readExhaustStream(const BSONObj& findCommandObj,
+                              const BSONObj& metadataObj,
+                              Milliseconds findMaxTime,
+                              Status* finalStatus);
+
     /**
      * Notifies caller that the oplog fetcher has completed processing operations from
      * the remote oplog using the "_onShutdownCallbackFn".
@@ -229,6 +281,13 @@ private:
 
     // Handle to currently scheduled _makeAndScheduleFetcherCallback task.
     executor::TaskExecutor::CallbackHandle _makeAndScheduleFetcherHandle;
+
+    // Thread reading the oplog when _useExhaustStream() is true.
+    stdx::thread _streamThread;
+
+    // Connection used by '_streamThread'. Only set while the thread is talking to the sync source,
+    // so that shutdown can interrupt it.
+    std::unique_ptr<DBClientConnection> _streamConnection;
 };
 
 }  // namespace repl
@@ -44,6 +44,8 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/collection_bulk_loader_impl.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -51,6 +53,16 @@
 
 namespace mongo {
 namespace repl {
+namespace {
+
+// Whether initial sync generates index keys on a worker thread while the inserting thread moves
+// on to the next batch of documents.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncBuildIndexesOnWorkerThread, bool, false);
+
+// The number of inserted batches that may wait for the index worker before inserts block.
+const size_t kMaxPendingIndexBatches = 4;
+
+}  // namespace
 
 CollectionBulkLoaderImpl::CollectionBulkLoaderImpl(ServiceContext::UniqueClient&& client,
                                                    ServiceContext::UniqueOperationContext&& opCtx,
@@ -108,6 +120,23 @@ Status CollectionBulkLoaderImpl::init(const std::vector<BSONObj>& secondaryIndex
                 _idIndexBlock.reset();
             }
 
+            // The worker calls MultiIndexBlock::insert() off the owning thread, which is only
+            // safe when the inserts go to bulk builders.
+            if (initialSyncBuildIndexesOnWorkerThread.load() &&
+                (_idIndexBlock || _secondaryIndexesBlock) &&
+                (!_idIndexBlock || _idIndexBlock->insertsIntoBulkBuilders()) &&
+                (!_secondaryIndexesBlock || _secondaryIndexesBlock->insertsIntoBulkBuilders())) {
+                ThreadPool::Options options;
+                options.poolName = "initial sync index builder Pool";
+                options.threadNamePrefix = "initialSyncIndexBuilder-";
+                options.maxThreads = 1;
+                options.onCreateThread = [](const std::string& threadName) {
+                    Client::initThread(threadName.c_str());
+                };
+                _indexWorker = stdx::make_unique<ThreadPool>(options);
+                _indexWorker->startup();
+            }
+
             return Status::OK();
         });
 }
@@ -118,7 +147,9 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
     return _runTaskReleaseResourcesOnFailure([&] {
         UnreplicatedWritesBlock uwb(_opCtx.get());
 
+        std::vector<std::pair<BSONObj, RecordId>> indexBatch;
         for (auto iter = begin; iter != end; ++iter) {
+            RecordId insertedLoc;
             Status status = writeConflictRetry(
                 _opCtx.get(), "CollectionBulkLoaderImpl::insertDocuments", _nss.ns(), [&] {
                     WriteUnitOfWork wunit(_opCtx.get());
@@ -127,6 +158,10 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
                         // This flavor of insertDocument will not update any pre-existing indexes,
                         // only the indexers passed in.
                         auto onRecordInserted = [&](const RecordId& loc) {
+                            if (_indexWorker) {
+                                insertedLoc = loc;
+                                return Status::OK();
+                            }
                             return _addDocumentToIndexBlocks(doc, loc);
                         };
                         const auto status = _autoColl->getCollection()->insertDocumentForBulkLoader(
@@ -153,14 +188,27 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
                 return status;
             }
 
+            if (_indexWorker) {
+                indexBatch.emplace_back(iter->getOwned(), insertedLoc);
+            }
             ++count;
         }
+        if (_indexWorker) {
+            return _scheduleIndexBatch(std::move(indexBatch));
+        }
         return Status::OK();
     });
 }
 
 Status CollectionBulkLoaderImpl::commit() {
     return _runTaskReleaseResourcesOnFailure([&] {
+        if (_indexWorker) {
+            auto status = _waitForIndexWorker();
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+
         _stats.startBuildingIndexes = Date_t::now();
         LOG(2) << "Creating indexes for ns: " << _nss.ns();
         UnreplicatedWritesBlock uwb(_opCtx.get());
@@ -260,6 +308,8 @@ Status CollectionBulkLoaderImpl::commit() {
 
 void CollectionBulkLoaderImpl::_releaseResources() {
     invariant(&cc() == _opCtx->getClient());
+    _stopIndexWorker();
+
     if (_secondaryIndexesBlock) {
         _secondaryIndexesBlock->cleanUpAfterBuild(_opCtx.get(), _collection);
         _secondaryIndexesBlock.reset();
@@ -308,6 +358,73 @@ Status CollectionBulkLoaderImpl::_addDocumentToIndexBlocks(const BSONObj& doc,
     return Status::OK();
 }
 
+Status CollectionBulkLoaderImpl::_scheduleIndexBatch(
+    std::vector<std::pair<BSONObj, RecordId>> batch) {
+    {
+        stdx::unique_lock<stdx::mutex> lk(_indexWorkerMutex);
+        _indexWorkerCondition.wait(lk, [this] {
+            return _pendingIndexBatches < kMaxPendingIndexBatches || !_indexWorkerStatus.isOK();
+        });
+        if (!_indexWorkerStatus.isOK()) {
+            return _indexWorkerStatus;
+        }
+        ++_pendingIndexBatches;
+    }
+
+    auto status = _indexWorker->schedule([ this, batch = std::move(batch) ] {
+        Status batchStatus = Status::OK();
+        {
+            stdx::lock_guard<stdx::mutex> lk(_indexWorkerMutex);
+            batchStatus = _indexWorkerStatus;
+        }
+        // The bulk builders only generate and sort keys, so they do not use '_opCtx' even though
+        // it belongs to the inserting thread.
+        for (auto it = batch.begin(); batchStatus.isOK() && it != batch.end(); ++it) {
+            try {
+                batchStatus = _addDocumentToIndexBlocks(it->first, it->second);
+            } catch (const DBException& ex) {
+                batchStatus = ex.toStatus();
+            }
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_indexWorkerMutex);
+        if (!batchStatus.isOK() && _indexWorkerStatus.isOK()) {
+            _indexWorkerStatus = batchStatus;
+        }
+        --_pendingIndexBatches;
+        _indexWorkerCondition.notify_all();
+    });
+    if (!status.isOK()) {
+        stdx::lock_guard<stdx::mutex> lk(_indexWorkerMutex);
+        --_pendingIndexBatches;
+        _indexWorkerCondition.notify_all();
+        return status;
+    }
+    ++_stats.indexWorkerBatches;
+    return Status::OK();
+}
+
+Status CollectionBulkLoaderImpl::_waitForIndexWorker() {
+    stdx::unique_lock<stdx::mutex> lk(_indexWorkerMutex);
+    _indexWorkerCondition.wait(lk, [this] { return _pendingIndexBatches == 0; });
+    return _indexWorkerStatus;
+}
+
+void CollectionBulkLoaderImpl::_stopIndexWorker() {
+    if (!_indexWorker) {
+        return;
+    }
+    {
+        stdx::lock_guard<stdx::mutex> lk(_indexWorkerMutex);
+        if (_indexWorkerStatus.isOK()) {
+            _indexWorkerStatus = {ErrorCodes::CallbackCanceled, "Bulk loader index worker stopped"};
+        }
+    }
+    _indexWorker->shutdown();
+    _indexWorker->join();
+    _indexWorker.reset();
+}
+
 CollectionBulkLoaderImpl::Stats CollectionBulkLoaderImpl::getStats() const {
     return _stats;
 }
@@ -323,6 +440,7 @@ BSONObj CollectionBulkLoaderImpl::Stats::toBSON() const {
     auto indexElapsed = endBuildingIndexes - startBuildingIndexes;
     long long indexElapsedMillis = duration_cast<Milliseconds>(indexElapsed).count();
     bob.appendNumber("indexElapsedMillis", indexElapsedMillis);
+    bob.appendNumber("indexWorkerBatches", indexWorkerBatches);
     return bob.obj();
 }
 
@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
@@ -39,6 +42,9 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/collection_bulk_loader.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
 namespace repl {
@@ -47,6 +53,10 @@ namespace repl {
  * Class in charge of building a collection during data loading (like initial sync).
  *
  * Note: Call commit when done inserting documents.
+ *
+ * When initialSyncBuildIndexesOnWorkerThread is set and every index is built through a bulk
+ * builder, the index keys for each batch of inserted documents are generated on a worker thread
+ * while the next batch is being inserted into the record store.
  */
 class CollectionBulkLoaderImpl : public CollectionBulkLoader {
     MONGO_DISALLOW_COPYING(CollectionBulkLoaderImpl);
@@ -55,6 +65,8 @@ public:
     struct Stats {
         Date_t startBuildingIndexes;
         Date_t endBuildingIndexes;
+        // Batches of inserted documents whose index keys were generated by the index worker.
+        size_t indexWorkerBatches = 0;
 
         std::string toString() const;
         BSONObj toBSON() const;
@@ -88,6 +100,23 @@ private:
      */
     Status _addDocumentToIndexBlocks(const BSONObj& doc, const RecordId& loc);
 
+    /**
+     * Hands a batch of inserted documents to '_indexWorker' to be added to the index blocks,
+     * waiting while too many batches are already pending. Returns the first error the worker ran
+     * into, if any.
+     */
+    Status _scheduleIndexBatch(std::vector<std::pair<BSONObj, RecordId>> batch);
+
+    /**
+     * Waits for '_indexWorker' to process every batch handed to it and returns its first error.
+     */
+    Status _waitForIndexWorker();
+
+    /**
+     * Discards the batches '_indexWorker' has not processed yet and joins it.
+     */
+    void _stopIndexWorker();
+
     ServiceContext::UniqueClient _client;
     ServiceContext::UniqueOperationContext _opCtx;
     std::unique_ptr<AutoGetCollection> _autoColl;
@@ -97,6 +126,16 @@ private:
     std::unique_ptr<MultiIndexBlock> _secondaryIndexesBlock;
     BSONObj _idIndexSpec;
     Stats _stats;
+
+    // Adds inserted documents to the index blocks off the inserting thread. Has a single thread so
+    // that batches are processed in insertion order. Null if documents are indexed inline.
+    std::unique_ptr<ThreadPool> _indexWorker;
+
+    // Guards the index worker state below.
+    stdx::mutex _indexWorkerMutex;
+    stdx::condition_variable _indexWorkerCondition;
+    size_t _pendingIndexBatches = 0;
+    Status _indexWorkerStatus = Status::OK();
 };
 
 }  // namespace repl
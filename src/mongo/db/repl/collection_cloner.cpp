@@ -33,9 +33,11 @@
 
 #include "mongo/db/repl/collection_cloner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/dbclient_connection.h"
 #include "mongo/client/remote_command_retry_scheduler.h"
@@ -47,6 +49,7 @@
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/fail_point_service.h"
@@ -74,6 +77,29 @@ MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListIndexesAttempts, int, 3);
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionFindAttempts, int, 3);
 // Whether to use the "exhaust cursor" feature when retrieving collection data.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(collectionClonerUsesExhaust, bool, true);
+// The maximum number of _id ranges a collection is split into for cloning. Each range after the
+// first is read by its own thread over its own connection to the sync source.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncCollectionClonerRanges, int, 1)
+    ->withValidator([](const int& value) {
+        return (value >= 1 && value <= 16)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream()
+                         << "initialSyncCollectionClonerRanges must be between 1 and 16. '"
+                         << value
+                         << "' is an invalid setting.");
+    });
+// The smallest amount of data, in megabytes, worth reading as a separate range. Collections
+// smaller than this are always cloned over a single connection.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncCollectionClonerMinRangeMB, int, 256)
+    ->withValidator([](const int& value) {
+        return (value >= 1)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream() << "initialSyncCollectionClonerMinRangeMB must be at least 1. '"
+                                   << value
+                                   << "' is an invalid setting.");
+    });
 }  // namespace
 
 // Failpoint which causes initial sync to hang before establishing its cursor to clone the
@@ -266,6 +292,9 @@ void CollectionCloner::_cancelRemainingWork_inlock() {
     if (_queryState == QueryState::kRunning) {
         _queryState = QueryState::kCanceling;
         _clientConnection->shutdownAndDisallowReconnect();
+        for (auto&& rangeConnection : _rangeConnections) {
+            rangeConnection->shutdownAndDisallowReconnect();
+        }
     } else {
         _queryState = QueryState::kFinished;
     }
@@ -492,6 +521,7 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
                     _queryState = QueryState::kFinished;
                     _clientConnection.reset();
+                    _rangeConnections.clear();
                 }
                 _condition.notify_all();
             });
@@ -546,6 +576,21 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
         return;
     }
 
+    // Each split point ends one _id range and starts the next. Every range after the first gets
+    // its own connection, created here so that cancellation can reach it.
+    const auto splitPoints = _computeRangeSplitPoints();
+    if (!splitPoints.empty()) {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        for (size_t i = 0; i < splitPoints.size(); ++i) {
+            _rangeConnections.push_back(_createClientFn());
+            if (_queryState == QueryState::kCanceling) {
+                _rangeConnections.back()->shutdownAndDisallowReconnect();
+            }
+        }
+        LOG(1) << "CollectionCloner ns: '" << _sourceNss.ns() << "' cloning "
+               << splitPoints.size() + 1 << " _id ranges concurrently";
+    }
+
     // This completion guard invokes _finishCallback on destruction.
     auto cancelRemainingWorkInLock = [this]() { _cancelRemainingWork_inlock(); };
     auto finishCallbackFn = [this](const Status& status) { _finishCallback(status); };
@@ -557,20 +602,87 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
     // The admin database is always cloned first, so all user data should use readOnce.
     const bool readOnceAvailable = serverGlobalParams.featureCompatibility.getVersionUnsafe() ==
         ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42;
-    try {
-        _clientConnection->query(
-            [this, onCompletionGuard](DBClientCursorBatchIterator& iter) {
-                _handleNextBatch(onCompletionGuard, iter);
-            },
-            NamespaceStringOrUUID(_sourceNss.db().toString(), *_options.uuid),
-            readOnceAvailable ? QUERY("query" << BSONObj() << "$readOnce" << true) : Query(),
-            nullptr /* fieldsToReturn */,
-            QueryOption_NoCursorTimeout | QueryOption_SlaveOk |
-                (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
-            _collectionClonerBatchSize);
-    } catch (const DBException& e) {
-        auto queryStatus = e.toStatus().withContext(str::stream() << "Error querying collection '"
-                                                                  << _sourceNss.ns());
+    auto makeRangeQuery = [&](size_t range) {
+        if (splitPoints.empty()) {
+            return readOnceAvailable ? QUERY("query" << BSONObj() << "$readOnce" << true)
+                                     : Query();
+        }
+        BSONObjBuilder queryBob;
+        queryBob.append("query", BSONObj());
+        if (readOnceAvailable) {
+            queryBob.append("$readOnce", true);
+        }
+        queryBob.append("$hint", BSON("_id" << 1));
+        if (range > 0) {
+            queryBob.append("$min", splitPoints[range - 1]);
+        }
+        if (range < splitPoints.size()) {
+            queryBob.append("$max", splitPoints[range]);
+        }
+        return Query(queryBob.obj());
+    };
+    auto readRange = [&](size_t range) -> Status {
+        DBClientConnection* conn =
+            range == 0 ? _clientConnection.get() : _rangeConnections[range - 1].get();
+        if (range > 0) {
+            Status connectStatus = conn->connect(_source, StringData());
+            if (!connectStatus.isOK()) {
+                return connectStatus;
+            }
+            if (!replAuthenticate(conn)) {
+                return {ErrorCodes::AuthenticationFailed,
+                        str::stream() << "Failed to authenticate to " << _source};
+            }
+        }
+        try {
+            conn->query(
+                [this, onCompletionGuard](DBClientCursorBatchIterator& iter) {
+                    _handleNextBatch(onCompletionGuard, iter);
+                },
+                NamespaceStringOrUUID(_sourceNss.db().toString(), *_options.uuid),
+                makeRangeQuery(range),
+                nullptr /* fieldsToReturn */,
+                QueryOption_NoCursorTimeout | QueryOption_SlaveOk |
+                    (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
+                _collectionClonerBatchSize);
+        } catch (const DBException& e) {
+            return e.toStatus();
+        }
+        return Status::OK();
+    };
+
+    // The first range to fail shuts down the connections of the others so that they stop early;
+    // its error is the one reported.
+    Status queryStatus = Status::OK();
+    auto runRange = [&](size_t range) {
+        Status rangeStatus = readRange(range);
+        if (rangeStatus.isOK()) {
+            return;
+        }
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (!queryStatus.isOK()) {
+            return;
+        }
+        queryStatus = rangeStatus;
+        if (!splitPoints.empty()) {
+            _clientConnection->shutdownAndDisallowReconnect();
+            for (auto&& rangeConnection : _rangeConnections) {
+                rangeConnection->shutdownAndDisallowReconnect();
+            }
+        }
+    };
+    std::vector<stdx::thread> rangeThreads;
+    for (size_t range = 1; range <= splitPoints.size(); ++range) {
+        rangeThreads.emplace_back([&runRange, range] { runRange(range); });
+    }
+    runRange(0);
+    for (auto&& rangeThread : rangeThreads) {
+        rangeThread.join();
+    }
+
+    if (!queryStatus.isOK()) {
+        queryStatus = queryStatus.withContext(str::stream() << "Error querying collection '"
+                                                            << _sourceNss.ns());
         stdx::unique_lock<stdx::mutex> lock(_mutex);
         if (queryStatus.code() == ErrorCodes::OperationFailed ||
             queryStatus.code() == ErrorCodes::CursorNotFound ||
@@ -595,11 +707,112 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
     onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, Status::OK());
 }
 
+std::vector<BSONObj> CollectionCloner::_computeRangeSplitPoints() {
+    const int maxRanges = initialSyncCollectionClonerRanges.load();
+    if (maxRanges <= 1 || _idIndexSpec.isEmpty()) {
+        return {};
+    }
+
+    // A collection with a collation orders string _ids in its _id index by collation key, so the
+    // range bounds would have to be collation keys too.
+    if (!_options.collation.isEmpty()) {
+        LOG(1) << "CollectionCloner ns: '" << _sourceNss.ns()
+               << "' cloning as a single range because the collection has a collation";
+        return {};
+    }
+
+    auto splitPoints = _sampleRangeSplitPoints(maxRanges);
+    if (!splitPoints.isOK()) {
+        log() << "CollectionCloner ns: '" << _sourceNss.ns()
+              << "' cloning as a single range, unable to compute _id split points: "
+              << splitPoints.getStatus();
+        return {};
+    }
+    return std::move(splitPoints.getValue());
+}
+
+StatusWith<std::vector<BSONObj>> CollectionCloner::_sampleRangeSplitPoints(int maxRanges) {
+    // Both commands look the collection up by name and are served by secondaries. If the
+    // collection was renamed or dropped since listCollections, the split points may not match
+    // the collection being cloned, which only affects how evenly the work is spread: the ranges
+    // still cover the whole _id key space.
+    const long long minRangeBytes =
+        static_cast<long long>(initialSyncCollectionClonerMinRangeMB.load()) * 1024 * 1024;
+    BSONObj collStats;
+    try {
+        _clientConnection->runCommand(_sourceNss.db().toString(),
+                                      BSON("collStats" << _sourceNss.coll()),
+                                      collStats,
+                                      QueryOption_SlaveOk);
+    } catch (const DBException& e) {
+        return e.toStatus();
+    }
+    Status status = getStatusFromCommandResult(collStats);
+    if (!status.isOK()) {
+        return status.withContext("collStats failed");
+    }
+    if (!collStats["size"].isNumber()) {
+        return {ErrorCodes::NoSuchKey, "collStats did not report the collection size"};
+    }
+    const long long numRanges =
+        std::min<long long>(maxRanges, collStats["size"].safeNumberLong() / minRangeBytes);
+    if (numRanges <= 1) {
+        return std::vector<BSONObj>();
+    }
+
+    // A few samples per range make the ranges hold similar amounts of data. The batch size has
+    // room for one more document so that the sync source closes the cursor after the first batch.
+    const long long kSamplesPerRange = 16;
+    const long long numSamples = numRanges * kSamplesPerRange;
+    BSONObj sampleResult;
+    try {
+        _clientConnection->runCommand(
+            _sourceNss.db().toString(),
+            BSON("aggregate" << _sourceNss.coll() << "pipeline"
+                             << BSON_ARRAY(BSON("$sample" << BSON("size" << numSamples))
+                                           << BSON("$project" << BSON("_id" << 1)))
+                             << "cursor"
+                             << BSON("batchSize" << numSamples + 1)),
+            sampleResult,
+            QueryOption_SlaveOk);
+    } catch (const DBException& e) {
+        return e.toStatus();
+    }
+    auto cursorResponse = CursorResponse::parseFromBSON(sampleResult);
+    if (!cursorResponse.isOK()) {
+        return cursorResponse.getStatus().withContext("$sample of _id values failed");
+    }
+
+    std::vector<BSONObj> samples;
+    for (auto&& doc : cursorResponse.getValue().getBatch()) {
+        if (doc["_id"].eoo()) {
+            return {ErrorCodes::NoSuchKey, "sampled document has no _id"};
+        }
+        samples.push_back(doc["_id"].wrap());
+    }
+    if (samples.empty()) {
+        return std::vector<BSONObj>();
+    }
+    const auto lessThan = SimpleBSONObjComparator::kInstance.makeLessThan();
+    std::sort(samples.begin(), samples.end(), lessThan);
+
+    // The range queries read [$min, $max) in _id index order, so strictly ascending split points
+    // give ranges that cover every _id exactly once.
+    std::vector<BSONObj> splitPoints;
+    for (long long range = 1; range < numRanges; ++range) {
+        const auto& splitPoint = samples[range * samples.size() / numRanges];
+        if (splitPoints.empty() || lessThan(splitPoints.back(), splitPoint)) {
+            splitPoints.push_back(splitPoint);
+        }
+    }
+    return splitPoints;
+}
+
 void CollectionCloner::_handleNextBatch(std::shared_ptr<OnCompletionGuard> onCompletionGuard,
                                         DBClientCursorBatchIterator& iter) {
-    _stats.receivedBatches++;
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stats.receivedBatches++;
         uassert(ErrorCodes::CallbackCanceled,
                 "Collection cloning cancelled.",
                 _queryState != QueryState::kCanceling);
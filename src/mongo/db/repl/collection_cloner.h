@@ -35,6 +35,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/dbclient_connection.h"
@@ -214,10 +215,28 @@ private:
     /**
      * Using a DBClientConnection, executes a query to retrieve all documents in the collection.
      * For each batch returned by the upstream node, _handleNextBatch will be called with the data.
+     * When the collection is split into _id ranges, the ranges after the first are read
+     * concurrently on threads of their own, each with its own connection.
      * This method will return when the entire query is finished or failed.
      */
     void _runQuery(const executor::TaskExecutor::CallbackArgs& callbackData);
 
+    /**
+     * Returns the _id split points dividing the collection into ranges of at least
+     * initialSyncCollectionClonerMinRangeMB each, at most initialSyncCollectionClonerRanges of
+     * them. Returns no split points, meaning a single range, if splitting is disabled, does not
+     * apply to the collection or fails. Failures are logged.
+     * Uses '_clientConnection', which must already be connected.
+     */
+    std::vector<BSONObj> _computeRangeSplitPoints();
+
+    /**
+     * Computes the split points for at most 'maxRanges' ranges from the collection size reported
+     * by collStats and a $sample of _id values, both read from the sync source with slaveOk.
+     * The split points are strictly ascending {_id: <value>} objects.
+     */
+    StatusWith<std::vector<BSONObj>> _sampleRangeSplitPoints(int maxRanges);
+
     /**
      * Put all results from a query batch into a buffer to be inserted, and schedule
      * it to be inserted.
@@ -301,6 +320,10 @@ private:
     // allow cancellation, and those other threads may access it only when holding '_mutex'.
     std::unique_ptr<DBClientConnection> _clientConnection;
 
+    // (M) Connections used to read the _id ranges after the first one, in range order. Governed
+    // by the same rules as '_clientConnection'.
+    std::vector<std::unique_ptr<DBClientConnection>> _rangeConnections;
+
     // State transitions:
     // PreStart --> Running --> ShuttingDown --> Complete
     // It is possible to skip intermediate states. For example,
@@ -28,9 +28,11 @@
  */
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
+#include "mongo/client/dbclient_mockcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -38,6 +40,7 @@
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/task_executor_proxy.h"
@@ -1463,4 +1466,217 @@ TEST_F(CollectionClonerRenamedBeforeStartTest,
     ASSERT_FALSE(collectionCloner->isActive());
 }
 
+/**
+ * Answers queries the way the _id index of the sync source would answer the range queries of a
+ * collection split into _id ranges, returning only the documents between the $min (inclusive)
+ * and $max (exclusive) bounds. Records the queries and commands it is sent.
+ */
+class IdRangeMockDBClientConnection : public MockDBClientConnection {
+public:
+    struct Requests {
+        stdx::mutex mutex;
+        std::vector<BSONObj> queries;
+        std::vector<BSONObj> commands;
+    };
+
+    IdRangeMockDBClientConnection(MockRemoteDBServer* remote, std::shared_ptr<Requests> requests)
+        : MockDBClientConnection(remote), _requests(std::move(requests)) {}
+
+    using MockDBClientConnection::query;
+    std::unique_ptr<DBClientCursor> query(const NamespaceStringOrUUID& nsOrUuid,
+                                          Query query,
+                                          int nToReturn,
+                                          int nToSkip,
+                                          const BSONObj* fieldsToReturn,
+                                          int queryOptions,
+                                          int batchSize) override {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_requests->mutex);
+            _requests->queries.push_back(query.obj.getOwned());
+        }
+        const BSONObj min = query.obj.getObjectField("$min");
+        const BSONObj max = query.obj.getObjectField("$max");
+        auto cursor = MockDBClientConnection::query(
+            nsOrUuid, query, nToReturn, nToSkip, fieldsToReturn, queryOptions, batchSize);
+        BSONArrayBuilder inRange;
+        while (cursor->more()) {
+            BSONObj doc = cursor->next();
+            BSONObj id = doc["_id"].wrap();
+            if ((min.isEmpty() || id.woCompare(min) >= 0) &&
+                (max.isEmpty() || id.woCompare(max) < 0)) {
+                inRange.append(doc);
+            }
+        }
+        return std::make_unique<DBClientMockCursor>(this, inRange.arr(), batchSize);
+    }
+
+    using MockDBClientConnection::runCommandWithTarget;
+    std::pair<rpc::UniqueReply, DBClientBase*> runCommandWithTarget(OpMsgRequest request) override {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_requests->mutex);
+            _requests->commands.push_back(request.body.getOwned());
+        }
+        return MockDBClientConnection::runCommandWithTarget(std::move(request));
+    }
+
+private:
+    std::shared_ptr<Requests> _requests;
+};
+
+void setServerParameter(StringData name, StringData value) {
+    ASSERT_OK(ServerParameterSet::getGlobal()
+                  ->getMap()
+                  .find(name.toString())
+                  ->second->setFromString(value.toString()));
+}
+
+class CollectionClonerRangesTest : public CollectionClonerTest {
+protected:
+    void setUp() override {
+        CollectionClonerTest::setUp();
+        setServerParameter("initialSyncCollectionClonerRanges", "4");
+        setServerParameter("initialSyncCollectionClonerMinRangeMB", "1");
+
+        for (int i = 0; i < kNumDocs; ++i) {
+            _server->insert(nss.ns(), BSON("_id" << i));
+        }
+        // Every range gets a connection of its own.
+        collectionCloner->setCreateClientFn_forTest([this] {
+            return std::unique_ptr<DBClientConnection>(
+                new IdRangeMockDBClientConnection(_server.get(), _requests));
+        });
+        storageInterface->createCollectionForBulkFn =
+            [this](const NamespaceString& nss,
+                   const CollectionOptions& options,
+                   const BSONObj idIndexSpec,
+                   const std::vector<BSONObj>& nonIdIndexSpecs)
+            -> StatusWith<std::unique_ptr<CollectionBulkLoaderMock>> {
+                auto loader = std::make_unique<CollectionBulkLoaderMock>(collectionStats);
+                loader->insertDocsFn = [this](const std::vector<BSONObj>::const_iterator begin,
+                                              const std::vector<BSONObj>::const_iterator end) {
+                    for (auto it = begin; it != end; ++it) {
+                        _insertedIds.push_back((*it)["_id"].numberInt());
+                    }
+                    return Status::OK();
+                };
+                Status result = loader->init(nonIdIndexSpecs);
+                if (!result.isOK())
+                    return result;
+
+                _loader = loader.get();
+                return std::move(loader);
+            };
+    }
+
+    void tearDown() override {
+        setServerParameter("initialSyncCollectionClonerRanges", "1");
+        setServerParameter("initialSyncCollectionClonerMinRangeMB", "256");
+        CollectionClonerTest::tearDown();
+    }
+
+    void setSampledIds(const std::vector<int>& ids) {
+        BSONArrayBuilder batch;
+        for (int id : ids) {
+            batch.append(BSON("_id" << id));
+        }
+        _server->setCommandReply("aggregate",
+                                 BSON("cursor" << BSON("id" << 0LL << "ns" << nss.ns()
+                                                            << "firstBatch"
+                                                            << batch.arr())
+                                               << "ok"
+                                               << 1));
+    }
+
+    void runCloner() {
+        ASSERT_OK(collectionCloner->startup());
+        {
+            executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+            processNetworkResponse(createCountResponse(kNumDocs));
+            processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+        }
+        collectionCloner->join();
+        ASSERT_OK(getStatus());
+    }
+
+    // Checks that every document of the collection was cloned exactly once.
+    void assertClonedEveryDocumentOnce() {
+        std::sort(_insertedIds.begin(), _insertedIds.end());
+        ASSERT_EQUALS(static_cast<size_t>(kNumDocs), _insertedIds.size());
+        for (int i = 0; i < kNumDocs; ++i) {
+            ASSERT_EQUALS(i, _insertedIds[i]);
+        }
+    }
+
+    static constexpr int kNumDocs = 100;
+    const BSONObj kCollStatsReply = BSON("ok" << 1 << "size" << 64 * 1024 * 1024 << "count"
+                                              << kNumDocs);
+
+    std::shared_ptr<IdRangeMockDBClientConnection::Requests> _requests =
+        std::make_shared<IdRangeMockDBClientConnection::Requests>();
+    // Inserts run on the database worker one batch at a time.
+    std::vector<int> _insertedIds;
+};
+
+TEST_F(CollectionClonerRangesTest, RangeQueriesCoverTheIdSpaceWithoutOverlap) {
+    _server->setCommandReply("collStats", kCollStatsReply);
+    // Sampled _ids arrive unsorted and may repeat. The split points are the quartiles.
+    setSampledIds({70, 20, 45, 20, 90, 5, 60, 33});
+
+    runCloner();
+    assertClonedEveryDocumentOnce();
+
+    // The size and the samples are read with slaveOk, which a secondary sync source serves.
+    ASSERT_EQUALS(2U, _requests->commands.size());
+    for (auto&& command : _requests->commands) {
+        ASSERT_TRUE(command.hasField("$readPreference")) << command;
+    }
+
+    // Each range starts where the previous one ends, the first one is unbounded below and the last
+    // one unbounded above.
+    auto queries = _requests->queries;
+    ASSERT_EQUALS(4U, queries.size());
+    std::sort(queries.begin(), queries.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.getObjectField("$min").woCompare(rhs.getObjectField("$min")) < 0;
+    });
+    const std::vector<BSONObj> splitPoints = {
+        BSON("_id" << 20), BSON("_id" << 45), BSON("_id" << 70)};
+    for (size_t range = 0; range < queries.size(); ++range) {
+        const auto& query = queries[range];
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 1), query.getObjectField("$hint"));
+        ASSERT_BSONOBJ_EQ(range == 0 ? BSONObj() : splitPoints[range - 1],
+                          query.getObjectField("$min"));
+        ASSERT_BSONOBJ_EQ(range == splitPoints.size() ? BSONObj() : splitPoints[range],
+                          query.getObjectField("$max"));
+    }
+}
+
+TEST_F(CollectionClonerRangesTest, ClonesAsSingleRangeWhenSamplingFails) {
+    _server->setCommandReply("collStats", kCollStatsReply);
+    _server->setCommandReply("aggregate",
+                             BSON("ok" << 0 << "errmsg"
+                                       << "$sample failed"
+                                       << "code"
+                                       << ErrorCodes::InternalError));
+
+    runCloner();
+    assertClonedEveryDocumentOnce();
+
+    ASSERT_EQUALS(1U, _requests->queries.size());
+    ASSERT_FALSE(_requests->queries[0].hasField("$min"));
+    ASSERT_FALSE(_requests->queries[0].hasField("$max"));
+}
+
+TEST_F(CollectionClonerRangesTest, ClonesAsSingleRangeWhenCollectionIsSmall) {
+    _server->setCommandReply("collStats",
+                             BSON("ok" << 1 << "size" << 1024 * 1024 << "count" << kNumDocs));
+
+    runCloner();
+    assertClonedEveryDocumentOnce();
+
+    // There is nothing to sample for.
+    ASSERT_EQUALS(1U, _requests->commands.size());
+    ASSERT_EQUALS(1U, _requests->queries.size());
+    ASSERT_FALSE(_requests->queries[0].hasField("$min"));
+}
+
 }  // namespace
@@ -82,6 +82,19 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(collectionClonerBatchSize, int, 0)
 // The number of attempts for the listCollections commands.
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListCollectionsAttempts, int, 3);
 
+// The number of collections of a database cloned at the same time. Each collection cloner uses its
+// own connection to the sync source and holds a task executor thread while it reads documents.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncMaxConcurrentCollectionClones, int, 1)
+    ->withValidator([](const int& value) {
+        return (value >= 1 && value <= 4)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream()
+                         << "initialSyncMaxConcurrentCollectionClones must be between 1 and 4. '"
+                         << value
+                         << "' is an invalid setting.");
+    });
+
 // Failpoint which causes initial sync to hang right after listCollections, but before cloning
 // any colelctions in the 'database' database.
 MONGO_FAIL_POINT_DEFINE(initialSyncHangAfterListCollections);
@@ -422,18 +435,48 @@ void DatabaseCloner::_listCollectionsCallback(const StatusWith<Fetcher::QueryRes
         }
     }
 
-    // Start first collection cloner.
-    _currentCollectionClonerIter = _collectionCloners.begin();
+    // Start the first collection cloners.
+    _nextCollectionClonerIter = _collectionCloners.begin();
+    _startCollectionCloners_inlock();
+    if (_activeCollectionCloners == 0) {
+        invariant(!_collectionClonersStatus.isOK());
+        _finishCallback_inlock(lk, _collectionClonersStatus);
+        return;
+    }
+}
+
+void DatabaseCloner::_startCollectionCloners_inlock() {
+    const auto maxActive =
+        static_cast<size_t>(std::max(1, initialSyncMaxConcurrentCollectionClones.load()));
+    while (_collectionClonersStatus.isOK() && _activeCollectionCloners < maxActive &&
+           _nextCollectionClonerIter != _collectionCloners.end()) {
+        auto&& collectionCloner = *_nextCollectionClonerIter++;
 
-    LOG(1) << "    cloning collection " << _currentCollectionClonerIter->getSourceNamespace();
+        LOG(1) << "    cloning collection " << collectionCloner.getSourceNamespace();
 
-    Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-    if (!startStatus.isOK()) {
-        LOG(1) << "    failed to start collection cloning on "
-               << _currentCollectionClonerIter->getSourceNamespace() << ": " << redact(startStatus);
-        _finishCallback_inlock(lk, startStatus);
+        ++_activeCollectionCloners;
+        Status startStatus = _startCollectionCloner(collectionCloner);
+        if (!startStatus.isOK()) {
+            --_activeCollectionCloners;
+            LOG(1) << "    failed to start collection cloning on "
+                   << collectionCloner.getSourceNamespace() << ": " << redact(startStatus);
+            _failCollectionCloning_inlock(startStatus, collectionCloner.getSourceNamespace());
+        }
+    }
+}
+
+void DatabaseCloner::_failCollectionCloning_inlock(const Status& status,
+                                                   const NamespaceString& nss) {
+    if (!_collectionClonersStatus.isOK()) {
         return;
     }
+    _collectionClonersStatus = status;
+
+    for (auto&& collectionCloner : _collectionCloners) {
+        if (collectionCloner.getSourceNamespace() != nss) {
+            collectionCloner.shutdown();
+        }
+    }
 }
 
 void DatabaseCloner::_collectionClonerCallback(const Status& status, const NamespaceString& nss) {
@@ -451,30 +494,24 @@ void DatabaseCloner::_collectionClonerCallback(const Status& status, const Names
     _collectionWork(collStatus, nss);
     lk.lock();
 
+    invariant(_activeCollectionCloners > 0);
+    --_activeCollectionCloners;
+
     // Failure to clone a collection will stop the database cloner from
     // cloning the rest of the collections in the listCollections result.
     if (!collStatus.isOK()) {
-        Status failStatus = {ErrorCodes::InitialSyncFailure, collStatus.toString()};
-        _finishCallback_inlock(lk, failStatus);
-        return;
+        _failCollectionCloning_inlock({ErrorCodes::InitialSyncFailure, collStatus.toString()},
+                                      nss);
+    } else {
+        ++_stats.clonedCollections;
     }
 
-    ++_stats.clonedCollections;
-    _currentCollectionClonerIter++;
+    _startCollectionCloners_inlock();
 
-    if (_currentCollectionClonerIter != _collectionCloners.end()) {
-        Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-        if (!startStatus.isOK()) {
-            LOG(1) << "    failed to start collection cloning on "
-                   << _currentCollectionClonerIter->getSourceNamespace() << ": "
-                   << redact(startStatus);
-            _finishCallback_inlock(lk, startStatus);
-            return;
-        }
-        return;
+    // Finish once every started collection cloner has reported back.
+    if (_activeCollectionCloners == 0) {
+        _finishCallback_inlock(lk, _collectionClonersStatus);
     }
-
-    _finishCallback_inlock(lk, Status::OK());
 }
 
 void DatabaseCloner::_finishCallback(const Status& status) {
@@ -192,6 +192,19 @@ private:
      */
     void _collectionClonerCallback(const Status& status, const NamespaceString& nss);
 
+    /**
+     * Starts collection cloners in listCollections order until the number running reaches the
+     * 'initialSyncMaxConcurrentCollectionClones' server parameter. Records the failure if a cloner
+     * cannot be started.
+     */
+    void _startCollectionCloners_inlock();
+
+    /**
+     * Records the first failure among the collection cloners and shuts down the others, except the
+     * cloner of 'nss' which is the one reporting the failure.
+     */
+    void _failCollectionCloning_inlock(const Status& status, const NamespaceString& nss);
+
     /**
      * Reports completion status.
      * Sets cloner to inactive.
@@ -235,7 +248,12 @@ private:
     std::vector<BSONObj> _collectionInfos;                               // (M)
     std::vector<NamespaceString> _collectionNamespaces;                  // (M)
     std::list<CollectionCloner> _collectionCloners;                      // (M)
-    std::list<CollectionCloner>::iterator _currentCollectionClonerIter;  // (M)
+    std::list<CollectionCloner>::iterator _nextCollectionClonerIter;     // (M)
+    size_t _activeCollectionCloners = 0;                                 // (M)
+    // First error reported by or while starting a collection cloner. Once set, no more
+    // collection cloners are started and the database cloner finishes with this status when
+    // the running ones have stopped.
+    Status _collectionClonersStatus = Status::OK();  // (M)
     ScheduleDbWorkFn
         _scheduleDbWorkFn;  // (RT) Function for scheduling database work using the executor.
     StartCollectionClonerFn _startCollectionCloner;  // (RT)
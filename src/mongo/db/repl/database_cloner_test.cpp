@@ -39,10 +39,12 @@
 #include "mongo/db/repl/base_cloner_test_fixture.h"
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/unittest/task_executor_proxy.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/uuid.h"
 
 namespace {
@@ -789,6 +791,68 @@ TEST_F(DatabaseClonerTest, ShutdownCancelsCollectionCloning) {
     ASSERT_EQUALS(ErrorCodes::InitialSyncFailure, getStatus());
 }
 
+TEST_F(DatabaseClonerTest, StartsUpToMaxConcurrentCollectionClones) {
+    ASSERT_OK(ServerParameterSet::getGlobal()
+                  ->getMap()
+                  .find("initialSyncMaxConcurrentCollectionClones")
+                  ->second->setFromString("2"));
+    ON_BLOCK_EXIT([] {
+        ASSERT_OK(ServerParameterSet::getGlobal()
+                      ->getMap()
+                      .find("initialSyncMaxConcurrentCollectionClones")
+                      ->second->setFromString("1"));
+    });
+
+    ASSERT_OK(_databaseCloner->startup());
+
+    auto net = getNet();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+
+        assertRemoteCommandNameEquals(
+            "listCollections",
+            net->scheduleSuccessfulResponse(createListCollectionsResponse(
+                0,
+                BSON_ARRAY(BSON("name"
+                                << "a"
+                                << "options"
+                                << _options1.toBSON())
+                           << BSON("name"
+                                   << "b"
+                                   << "options"
+                                   << _options2.toBSON())
+                           << BSON("name"
+                                   << "c"
+                                   << "options"
+                                   << _options3.toBSON())))));
+        net->runReadyNetworkOperations();
+
+        // The first two collection cloners start right away and send their count requests. The
+        // third one waits for one of them to finish.
+        auto noi = net->getNextReadyRequest();
+        assertRemoteCommandNameEquals("count", noi->getRequest());
+        ASSERT_EQUALS(*_options1.uuid, UUID::parse(noi->getRequest().cmdObj.firstElement()));
+        net->blackHole(noi);
+
+        noi = net->getNextReadyRequest();
+        assertRemoteCommandNameEquals("count", noi->getRequest());
+        ASSERT_EQUALS(*_options2.uuid, UUID::parse(noi->getRequest().cmdObj.firstElement()));
+        net->blackHole(noi);
+
+        ASSERT_FALSE(net->hasReadyRequests());
+    }
+
+    _databaseCloner->shutdown();
+
+    // Deliver cancellation events to both cloners.
+    executor::NetworkInterfaceMock::InNetworkGuard(net)->runReadyNetworkOperations();
+
+    _databaseCloner->join();
+    ASSERT_FALSE(_databaseCloner->isActive());
+    ASSERT_EQUALS(DatabaseCloner::State::kComplete, _databaseCloner->getState_forTest());
+    ASSERT_EQUALS(ErrorCodes::InitialSyncFailure, getStatus());
+}
+
 TEST_F(DatabaseClonerTest, FirstCollectionListIndexesFailed) {
     ASSERT_EQUALS(DatabaseCloner::State::kPreStart, _databaseCloner->getState_forTest());
 
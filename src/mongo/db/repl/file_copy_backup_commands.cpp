@@ -0,0 +1,280 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/repl/repl_set_command.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+// How long a file copy backup may go without being read before another node may take it over. An
+// open backup pins a checkpoint and the oplog after it, so an abandoned one must not live forever.
+MONGO_EXPORT_SERVER_PARAMETER(fileCopyBackupIdleTimeoutSecs, int, 600);
+
+// The largest chunk of a file returned by one _readFileCopyBackupFile command.
+const long long kMaxChunkBytes = 8 * 1024 * 1024;
+
+// The number of times to try opening a backup that raced with a checkpoint.
+const int kMaxOpenAttempts = 10;
+
+/**
+ * The file copy backup open on this node, if any. The storage engine supports a single backup at
+ * a time.
+ */
+struct FileCopyBackup {
+    stdx::mutex mutex;
+    boost::optional<UUID> backupId;
+    // Absolute paths of the files in the backup, keyed by their path relative to the dbpath.
+    std::map<std::string, std::string> files;
+    Date_t lastActivity;
+};
+
+const auto getFileCopyBackup = ServiceContext::declareDecoration<FileCopyBackup>();
+
+void closeBackup_inlock(OperationContext* opCtx, FileCopyBackup* backup) {
+    opCtx->getServiceContext()->getStorageEngine()->endNonBlockingBackup(opCtx);
+    log() << "Closed file copy backup " << *backup->backupId;
+    backup->backupId = boost::none;
+    backup->files.clear();
+}
+
+UUID parseBackupId(const BSONObj& cmdObj, StringData fieldName) {
+    return uassertStatusOK(UUID::parse(cmdObj[fieldName]));
+}
+
+class CmdBeginFileCopyBackup : public ReplSetCommand {
+public:
+    CmdBeginFileCopyBackup() : ReplSetCommand("_beginFileCopyBackup") {}
+
+    std::string help() const override {
+        return "Internal command. Opens a backup of this node's data files to be copied by file "
+               "copy initial sync. { _beginFileCopyBackup: 1 }";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string&,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        auto replCoord = ReplicationCoordinator::get(opCtx);
+        uassertStatusOK(replCoord->checkReplEnabledForCommand(&result));
+        const auto memberState = replCoord->getMemberState();
+        uassert(ErrorCodes::NotMasterOrSecondary,
+                str::stream() << "Cannot open a file copy backup in state "
+                              << memberState.toString(),
+                memberState.primary() || memberState.secondary());
+
+        auto storageEngine = opCtx->getServiceContext()->getStorageEngine();
+        uassert(ErrorCodes::CommandNotSupported,
+                "File copy backups require a persistent storage engine that supports recovering "
+                "to a stable timestamp",
+                !storageEngine->isEphemeral() &&
+                    storageEngine->supportsRecoverToStableTimestamp());
+
+        auto& backup = getFileCopyBackup(opCtx->getServiceContext());
+        stdx::lock_guard<stdx::mutex> lk(backup.mutex);
+        if (backup.backupId) {
+            const auto idleTimeout = Seconds(fileCopyBackupIdleTimeoutSecs.load());
+            uassert(ErrorCodes::CannotBackup,
+                    str::stream() << "File copy backup " << *backup.backupId
+                                  << " is already open",
+                    Date_t::now() - backup.lastActivity >= idleTimeout);
+            log() << "Closing file copy backup " << *backup.backupId << ", idle since "
+                  << backup.lastActivity;
+            closeBackup_inlock(opCtx, &backup);
+        }
+
+        // The backup is of the last checkpoint taken. Read the checkpoint timestamp on both sides
+        // of opening it so that a checkpoint completing in between is noticed.
+        std::vector<std::string> files;
+        Timestamp checkpointTimestamp;
+        for (int attempt = 1;; ++attempt) {
+            const auto before = storageEngine->getLastStableRecoveryTimestamp();
+            files = uassertStatusOK(storageEngine->beginNonBlockingBackup(opCtx));
+            const auto after = storageEngine->getLastStableRecoveryTimestamp();
+            if (before && before == after) {
+                checkpointTimestamp = *before;
+                break;
+            }
+            storageEngine->endNonBlockingBackup(opCtx);
+            uassert(ErrorCodes::CannotBackup,
+                    before ? "Checkpoints kept completing while opening a file copy backup"
+                           : "No stable checkpoint has been taken yet",
+                    before && attempt < kMaxOpenAttempts);
+        }
+
+        // The storage engine metadata is not part of the backup but describes how the files are
+        // laid out, so it travels with them.
+        const boost::filesystem::path dbpath(storageGlobalParams.dbpath);
+        const auto metadataPath = dbpath / "storage.bson";
+        if (boost::filesystem::exists(metadataPath)) {
+            files.push_back(metadataPath.string());
+        }
+
+        std::map<std::string, std::string> filesByRelativePath;
+        const auto dbpathPrefix = dbpath.string();
+        for (auto&& file : files) {
+            std::string relativePath = file;
+            if (StringData(file).startsWith(dbpathPrefix)) {
+                relativePath = file.substr(dbpathPrefix.size());
+            }
+            while (!relativePath.empty() && (relativePath[0] == '/' || relativePath[0] == '\\')) {
+                relativePath.erase(0, 1);
+            }
+            filesByRelativePath.emplace(relativePath, file);
+        }
+
+        backup.backupId = UUID::gen();
+        backup.files = std::move(filesByRelativePath);
+        backup.lastActivity = Date_t::now();
+        log() << "Opened file copy backup " << *backup.backupId << " of " << backup.files.size()
+              << " files at checkpoint timestamp " << checkpointTimestamp;
+
+        backup.backupId->appendToBuilder(&result, "backupId");
+        result.append("checkpointTimestamp", checkpointTimestamp);
+        BSONArrayBuilder filesBuilder(result.subarrayStart("files"));
+        for (auto&& file : backup.files) {
+            boost::system::error_code ec;
+            const auto fileSize = boost::filesystem::file_size(file.second, ec);
+            filesBuilder.append(
+                BSON("filename" << file.first << "fileSize"
+                                << static_cast<long long>(ec ? 0 : fileSize)));
+        }
+        filesBuilder.done();
+        return true;
+    }
+} cmdBeginFileCopyBackup;
+
+class CmdReadFileCopyBackupFile : public ReplSetCommand {
+public:
+    CmdReadFileCopyBackupFile() : ReplSetCommand("_readFileCopyBackupFile") {}
+
+    std::string help() const override {
+        return "Internal command. Reads part of a file in the open file copy backup. "
+               "{ _readFileCopyBackupFile: <backupId>, filename: <string>, offset: <number>, "
+               "length: <number> }";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string&,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const auto backupId = parseBackupId(cmdObj, getName());
+        std::string filename;
+        uassertStatusOK(bsonExtractStringField(cmdObj, "filename", &filename));
+        long long offset;
+        uassertStatusOK(bsonExtractIntegerField(cmdObj, "offset", &offset));
+        long long length;
+        uassertStatusOK(bsonExtractIntegerField(cmdObj, "length", &length));
+        uassert(ErrorCodes::BadValue,
+                "offset must not be negative and length must be positive",
+                offset >= 0 && length > 0);
+        length = std::min(length, kMaxChunkBytes);
+
+        std::string path;
+        {
+            auto& backup = getFileCopyBackup(opCtx->getServiceContext());
+            stdx::lock_guard<stdx::mutex> lk(backup.mutex);
+            uassert(ErrorCodes::CannotBackup,
+                    str::stream() << "File copy backup " << backupId << " is not open",
+                    backup.backupId == backupId);
+            // Only files listed by the backup may be read, so the name cannot reach outside it.
+            auto it = backup.files.find(filename);
+            uassert(ErrorCodes::NoSuchKey,
+                    str::stream() << "File '" << filename << "' is not part of file copy backup "
+                                  << backupId,
+                    it != backup.files.end());
+            path = it->second;
+            backup.lastActivity = Date_t::now();
+        }
+
+        std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+        uassert(ErrorCodes::FileNotOpen,
+                str::stream() << "Failed to open '" << path << "' for reading",
+                file.is_open());
+        std::unique_ptr<char[]> buffer(new char[length]);
+        file.seekg(offset);
+        file.read(buffer.get(), length);
+        const auto bytesRead = file.gcount();
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to read '" << path << "' at offset " << offset,
+                bytesRead == length || file.eof());
+
+        result.appendBinData("data", bytesRead, BinDataGeneral, buffer.get());
+        result.append("eof", bytesRead < length);
+        return true;
+    }
+} cmdReadFileCopyBackupFile;
+
+class CmdEndFileCopyBackup : public ReplSetCommand {
+public:
+    CmdEndFileCopyBackup() : ReplSetCommand("_endFileCopyBackup") {}
+
+    std::string help() const override {
+        return "Internal command. Closes the open file copy backup. "
+               "{ _endFileCopyBackup: <backupId> }";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string&,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const auto backupId = parseBackupId(cmdObj, getName());
+        auto& backup = getFileCopyBackup(opCtx->getServiceContext());
+        stdx::lock_guard<stdx::mutex> lk(backup.mutex);
+        uassert(ErrorCodes::CannotBackup,
+                str::stream() << "File copy backup " << backupId << " is not open",
+                backup.backupId == backupId);
+        closeBackup_inlock(opCtx, &backup);
+        return true;
+    }
+} cmdEndFileCopyBackup;
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,402 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplicationInitialSync
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/file_copy_initial_sync.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/client/dbclient_connection.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/repl/oplog_interface_local.h"
+#include "mongo/db/repl/oplogreader.h"
+#include "mongo/db/repl/replication_consistency_markers.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/repl/replication_process.h"
+#include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+// How initial sync copies data from its sync source: "logical" clones every collection through
+// queries, "fileCopy" copies the data files of 'initialSyncFileCopySource' at startup.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncMethod, std::string, "logical")
+    ->withValidator([](const std::string& value) {
+        return (value == "logical" || value == "fileCopy")
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream() << "initialSyncMethod must be 'logical' or 'fileCopy'. '"
+                                   << value
+                                   << "' is an invalid setting.");
+    });
+
+// The replica set member whose data files are copied by file copy initial sync.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncFileCopySource, std::string, "");
+
+// The directory in the dbpath that files are copied into before being moved into place.
+const char kStagingDirName[] = "_fileCopyInitialSync";
+
+// Present in the dbpath while the staged files are moved into place. Every file has been copied in
+// full before it is created, so finding it at startup means that the move has to be finished.
+const char kInstallingMarkerName[] = "_fileCopyInitialSync.installing";
+
+// Present in the dbpath from when the copied files are in place until the documents in the local
+// database that describe the sync source rather than this node have been replaced.
+const char kInstalledMarkerName[] = "_fileCopyInitialSync.installed";
+
+// Collections in the local database holding documents that belong to the sync source: its member
+// id and its vote in replica set elections.
+const NamespaceString kSourceIdentityNamespaces[] = {NamespaceString("local.me"),
+                                                     NamespaceString("local.replset.election")};
+
+// The size of each chunk of a file requested from the sync source.
+const long long kChunkBytes = 8 * 1024 * 1024;
+
+namespace fs = boost::filesystem;
+
+/**
+ * Returns true if the dbpath holds nothing but a lock file or the staging directory left behind
+ * by an earlier attempt.
+ */
+bool isDbpathEmpty(const fs::path& dbpath) {
+    if (!fs::exists(dbpath)) {
+        return true;
+    }
+    for (fs::directory_iterator it(dbpath), end; it != end; ++it) {
+        const auto name = it->path().filename().string();
+        if (name != "mongod.lock" && name != kStagingDirName) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns an error unless 'filename' is a relative path that stays inside the directory it is
+ * resolved against.
+ */
+Status validateRelativePath(const std::string& filename) {
+    const fs::path path(filename);
+    bool valid = !filename.empty() && path.is_relative() && !path.has_root_name();
+    for (auto&& component : path) {
+        valid = valid && component != "..";
+    }
+    if (!valid) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Sync source returned invalid file name '" << filename << "'"};
+    }
+    return Status::OK();
+}
+
+/**
+ * Copies 'filename' from the backup open on the sync source into 'destination'. Returns the
+ * number of bytes copied.
+ */
+long long copyFile(DBClientConnection* conn,
+                   const UUID& backupId,
+                   const std::string& filename,
+                   const fs::path& destination) {
+    fs::create_directories(destination.parent_path());
+    std::ofstream out(destination.string(),
+                      std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    uassert(ErrorCodes::FileNotOpen,
+            str::stream() << "Failed to open '" << destination.string() << "' for writing",
+            out.is_open());
+
+    long long offset = 0;
+    for (bool eof = false; !eof;) {
+        BSONObjBuilder cmd;
+        backupId.appendToBuilder(&cmd, "_readFileCopyBackupFile");
+        cmd.append("filename", filename);
+        cmd.append("offset", offset);
+        cmd.append("length", kChunkBytes);
+        BSONObj reply;
+        conn->runCommand("admin", cmd.obj(), reply);
+        uassertStatusOK(getStatusFromCommandResult(reply));
+
+        int length = 0;
+        const char* data = reply["data"].binData(length);
+        out.write(data, length);
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to write '" << destination.string() << "'",
+                out.good());
+        offset += length;
+        eof = reply["eof"].trueValue() || length == 0;
+    }
+
+    out.close();
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to write '" << destination.string() << "'",
+            !out.fail());
+    uassertStatusOK(fsyncFile(destination));
+    return offset;
+}
+
+/**
+ * Durably creates the empty file 'path'.
+ */
+Status writeMarker(const fs::path& path) {
+    std::ofstream out(path.string(), std::ios_base::out | std::ios_base::trunc);
+    out.close();
+    if (out.fail()) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to create '" << path.string() << "'"};
+    }
+    auto status = fsyncFile(path);
+    if (!status.isOK()) {
+        return status;
+    }
+    return fsyncParentDirectory(path);
+}
+
+/**
+ * Copies every file of a new backup on 'source' into 'staging'.
+ */
+void copyBackup(const HostAndPort& source, const fs::path& staging) {
+    DBClientConnection conn;
+    uassertStatusOK(conn.connect(source, "FileCopyInitialSync"));
+    uassert(ErrorCodes::AuthenticationFailed,
+            str::stream() << "Failed to authenticate to " << source,
+            replAuthenticate(&conn));
+
+    BSONObj beginReply;
+    conn.runCommand("admin", BSON("_beginFileCopyBackup" << 1), beginReply);
+    uassertStatusOK(getStatusFromCommandResult(beginReply));
+    const auto backupId = uassertStatusOK(UUID::parse(beginReply["backupId"]));
+    Timestamp checkpointTimestamp;
+    uassertStatusOK(
+        bsonExtractTimestampField(beginReply, "checkpointTimestamp", &checkpointTimestamp));
+
+    // Release the backup as soon as we are done with it; it pins a checkpoint and the oplog after
+    // it on the sync source. The source also releases it on its own once it goes idle.
+    ON_BLOCK_EXIT([&] {
+        try {
+            BSONObj endReply;
+            BSONObjBuilder endCmd;
+            backupId.appendToBuilder(&endCmd, "_endFileCopyBackup");
+            conn.runCommand("admin", endCmd.obj(), endReply);
+        } catch (const DBException& ex) {
+            warning() << "Failed to close file copy backup " << backupId << " on " << source
+                      << ": " << ex.toStatus();
+        }
+    });
+
+    std::vector<std::pair<std::string, long long>> files;
+    long long totalBytes = 0;
+    for (auto&& fileElem : beginReply["files"].Obj()) {
+        const auto fileObj = fileElem.Obj();
+        auto filename = fileObj["filename"].str();
+        uassertStatusOK(validateRelativePath(filename));
+        files.emplace_back(std::move(filename), fileObj["fileSize"].safeNumberLong());
+        totalBytes += files.back().second;
+    }
+    log() << "File copy initial sync copying " << files.size() << " files (" << totalBytes
+          << " bytes) from " << source << " at checkpoint timestamp " << checkpointTimestamp;
+
+    Timer timer;
+    long long copiedBytes = 0;
+    for (auto&& file : files) {
+        copiedBytes += copyFile(&conn, backupId, file.first, staging / file.first);
+        LOG(1) << "File copy initial sync copied " << file.first << ", " << copiedBytes << " of "
+               << totalBytes << " bytes done";
+    }
+    log() << "File copy initial sync copied " << copiedBytes << " bytes from " << source << " in "
+          << timer.seconds() << " seconds";
+}
+
+/**
+ * Moves the contents of 'staging' into 'dbpath' and removes 'staging'. Once the first file has
+ * been moved the dbpath is neither empty nor complete, so failing from then on is fatal, and the
+ * next startup resumes the move. Also resumes a move that was interrupted this way.
+ */
+void installFiles(const fs::path& staging, const fs::path& dbpath) {
+    const auto installingMarker = dbpath / kInstallingMarkerName;
+    if (!fs::exists(installingMarker)) {
+        auto status = writeMarker(installingMarker);
+        if (!status.isOK()) {
+            // Nothing has been moved yet, so the dbpath can still be left as it was.
+            boost::system::error_code ec;
+            fs::remove(installingMarker, ec);
+            uassertStatusOK(status);
+        }
+    }
+
+    try {
+        if (fs::exists(staging)) {
+            for (fs::directory_iterator it(staging), end; it != end; ++it) {
+                fs::rename(it->path(), dbpath / it->path().filename());
+            }
+        }
+        uassertStatusOK(fsyncParentDirectory(installingMarker));
+        uassertStatusOK(writeMarker(dbpath / kInstalledMarkerName));
+        fs::remove_all(staging);
+        fs::remove(installingMarker);
+    } catch (const DBException& ex) {
+        severe() << "File copy initial sync failed to move the copied files into "
+                 << dbpath.string() << ": " << ex.toStatus()
+                 << ". Restart the server to finish moving them.";
+        fassertFailedNoTrace(51242);
+    } catch (const fs::filesystem_error& ex) {
+        severe() << "File copy initial sync failed to move the copied files into "
+                 << dbpath.string() << ": " << ex.what()
+                 << ". Restart the server to finish moving them.";
+        fassertFailedNoTrace(51243);
+    }
+}
+
+}  // namespace
+
+Status runFileCopyInitialSync(ServiceContext* service) {
+    const fs::path dbpath(storageGlobalParams.dbpath);
+    const auto staging = dbpath / kStagingDirName;
+
+    // A move of copied files into the dbpath that was interrupted has to be finished, even if file
+    // copy initial sync is no longer selected.
+    boost::system::error_code ec;
+    const bool resumeInstall = fs::exists(dbpath / kInstallingMarkerName, ec);
+    if (!resumeInstall && initialSyncMethod != "fileCopy") {
+        return Status::OK();
+    }
+    if (!ReplicationCoordinator::get(service)->getSettings().usingReplSets()) {
+        return {ErrorCodes::InvalidOptions, "File copy initial sync requires --replSet"};
+    }
+    if (storageGlobalParams.readOnly) {
+        return {ErrorCodes::InvalidOptions, "File copy initial sync cannot run in read-only mode"};
+    }
+
+    // Keep other processes out of the dbpath while it is written to. The storage engine keeps
+    // using this lock once it starts.
+    try {
+        createLockFile(service);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+
+    if (resumeInstall) {
+        log() << "Resuming the move of the files copied by file copy initial sync into "
+              << dbpath.string();
+        installFiles(staging, dbpath);
+        return Status::OK();
+    }
+
+    auto swSource = HostAndPort::parse(initialSyncFileCopySource);
+    if (!swSource.isOK()) {
+        return swSource.getStatus().withContext(
+            "File copy initial sync requires initialSyncFileCopySource to name a sync source");
+    }
+
+    try {
+        if (!isDbpathEmpty(dbpath)) {
+            log() << "Skipping file copy initial sync because " << dbpath.string()
+                  << " already holds data";
+            return Status::OK();
+        }
+
+        fs::remove_all(staging);
+        fs::create_directories(staging);
+        copyBackup(swSource.getValue(), staging);
+        installFiles(staging, dbpath);
+        log() << "Finished file copy initial sync from " << swSource.getValue();
+        return Status::OK();
+    } catch (const DBException& ex) {
+        boost::system::error_code ec;
+        fs::remove_all(staging, ec);
+        return ex.toStatus().withContext("File copy initial sync failed");
+    } catch (const fs::filesystem_error& ex) {
+        boost::system::error_code ec;
+        fs::remove_all(staging, ec);
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "File copy initial sync failed: " << ex.what()};
+    }
+}
+
+void finishFileCopyInitialSync(OperationContext* opCtx) {
+    const auto installedMarker = fs::path(storageGlobalParams.dbpath) / kInstalledMarkerName;
+    if (!fs::exists(installedMarker)) {
+        return;
+    }
+
+    // The copied replica set configuration is the sync source's, which is only usable if this node
+    // was started as a member of the same set.
+    auto storageInterface = StorageInterface::get(opCtx);
+    const auto config = uassertStatusOKWithContext(
+        storageInterface->findSingleton(opCtx, NamespaceString::kSystemReplSetNamespace),
+        "File copy initial sync did not copy a replica set configuration");
+    const auto setName = ReplicationCoordinator::get(opCtx)->getSettings().ourSetName();
+    uassert(ErrorCodes::InvalidReplicaSetConfig,
+            str::stream() << "File copy initial sync copied the data of replica set '"
+                          << config["_id"].str()
+                          << "', but this node is a member of '"
+                          << setName
+                          << "'",
+            config["_id"].str() == setName);
+
+    for (auto&& nss : kSourceIdentityNamespaces) {
+        auto status = storageInterface->truncateCollection(opCtx, nss);
+        if (status != ErrorCodes::NamespaceNotFound) {
+            uassertStatusOK(status);
+        }
+    }
+
+    // Startup replication recovery replays the copied oplog past the backup's checkpoint. This node
+    // is not consistent before it has, whatever the sync source's minValid said. The oplog truncate
+    // after point is kept, since it describes the copied oplog.
+    auto oplogIter =
+        OplogInterfaceLocal(opCtx, NamespaceString::kRsOplogNamespace.ns()).makeIterator();
+    const auto topOfOplog = uassertStatusOK(oplogIter->next()).first;
+    ReplicationProcess::get(opCtx)->getConsistencyMarkers()->setMinValidToAtLeast(
+        opCtx, uassertStatusOK(OpTime::parseFromOplogEntry(topOfOplog)));
+
+    fs::remove(installedMarker);
+    log() << "Replaced the sync source's local documents after file copy initial sync";
+}
+
+}  // namespace repl
+}  // namespace mongo
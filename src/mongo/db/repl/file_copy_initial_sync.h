@@ -0,0 +1,72 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+namespace repl {
+
+/**
+ * File copy initial sync seeds an empty dbpath with the data files of a running replica set
+ * member instead of cloning every collection through queries. It is selected with the
+ * initialSyncMethod server parameter set to "fileCopy", and copies from the node named by
+ * initialSyncFileCopySource.
+ *
+ * The files are read from a backup opened on the source with _beginFileCopyBackup, over a single
+ * connection, into a staging directory that is moved into the dbpath once every file is complete.
+ * This runs during startup, before the storage engine opens the dbpath, because the data files of
+ * a running storage engine cannot be replaced. On the following startup the storage engine
+ * recovers to the backup's checkpoint timestamp and startup replication recovery replays the
+ * copied oplog from there, after which the node syncs like any other secondary.
+ *
+ * Takes the dbpath's lock file before writing to it. Returns OK without doing anything if file copy
+ * initial sync is not selected or the dbpath already holds data. Errors before the copied files
+ * are moved into the dbpath leave it as it was, so the node can fall back to logical initial sync.
+ * Failing to move them is fatal, and the next startup finishes the move.
+ */
+Status runFileCopyInitialSync(ServiceContext* service);
+
+/**
+ * Replaces the documents in the local database that describe the sync source rather than this
+ * node, after a file copy initial sync has installed its files: the member id and election vote
+ * are removed, minValid is raised to the end of the copied oplog, and the copied replica set
+ * configuration must name this node's set. Must run once the storage engine has started and
+ * before replication does. Does nothing if no file copy initial sync has to be finished.
+ */
+void finishFileCopyInitialSync(OperationContext* opCtx);
+
+}  // namespace repl
+}  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
 #include "mongo/util/assert_util.h"
@@ -53,6 +54,10 @@ MONGO_FAIL_POINT_DEFINE(stopReplProducer);
 
 namespace {
 
+// Whether to read the sync source's oplog over an exhaust cursor, which lets the sync source send
+// batches back to back instead of waiting for a `getMore` round trip per batch.
+MONGO_EXPORT_SERVER_PARAMETER(oplogFetcherUsesExhaust, bool, false);
+
 // The number and time spent reading batches off the network
 TimerStats getmoreReplStats;
 ServerStatusMetricField<TimerStats> displayBatchesRecieved("repl.network.getmores",
@@ -391,6 +396,10 @@ Milliseconds OplogFetcher::_getGetMoreMaxTime() const {
     return _awaitDataTimeout;
 }
 
+bool OplogFetcher::_useExhaustStream() const {
+    return oplogFetcherUsesExhaust.load();
+}
+
 StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) {
 
     // Stop fetching and return on fail point.
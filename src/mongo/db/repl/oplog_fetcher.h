@@ -63,7 +63,9 @@ MONGO_FAIL_POINT_DECLARE(stopReplProducer);
  * Pushes operations from each batch of operations onto a buffer using the "enqueueDocumentsFn"
  * function.
  *
- * Issues a getMore command after successfully processing each batch of operations.
+ * Issues a getMore command after successfully processing each batch of operations. When the
+ * 'oplogFetcherUsesExhaust' server parameter is set, the getMore is sent as an exhaust request
+ * instead, and the sync source keeps streaming batches on its own while the cursor is open.
  *
  * When there is an error or when it is not possible to issue another getMore request, calls
  * "onShutdownCallbackFn" to signal the end of processing.
@@ -161,6 +163,7 @@ private:
     BSONObj _makeMetadataObject() const override;
 
     Milliseconds _getGetMoreMaxTime() const override;
+    bool _useExhaustStream() const override;
 
     /**
      * This function is run by the AbstractOplogFetcher on a successful batch of oplog entries.
@@ -50,7 +50,9 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_interface_local.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/repl/collection_bulk_loader_impl.h"
 #include "mongo/db/repl/storage_interface_impl.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
@@ -58,6 +60,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace {
 
@@ -606,6 +609,59 @@ TEST_F(StorageInterfaceImplTest, CreateCollectionWithIDIndexCommits) {
     ASSERT_EQ(count, 2LL);
 }
 
+TEST_F(StorageInterfaceImplTest, CollectionBulkLoaderIndexesInsertedBatchesOnWorkerThread) {
+    ASSERT_OK(ServerParameterSet::getGlobal()
+                  ->getMap()
+                  .find("initialSyncBuildIndexesOnWorkerThread")
+                  ->second->setFromString("true"));
+    ON_BLOCK_EXIT([] {
+        ASSERT_OK(ServerParameterSet::getGlobal()
+                      ->getMap()
+                      .find("initialSyncBuildIndexesOnWorkerThread")
+                      ->second->setFromString("false"));
+    });
+
+    auto opCtx = getOperationContext();
+    StorageInterfaceImpl storage;
+    auto nss = makeNamespace(_agent);
+    CollectionOptions opts = generateOptionsWithUuid();
+    std::vector<BSONObj> indexes = {BSON("v" << 1 << "key" << BSON("x" << 1) << "name"
+                                             << "x_1"
+                                             << "ns"
+                                             << nss.ns())};
+    auto loader = unittest::assertGet(
+        storage.createCollectionForBulkLoading(nss, opts, makeIdIndexSpec(nss), indexes));
+
+    // Every batch of the insert stream goes to the index worker, including one repeating an _id,
+    // which the _id index build drops as it would without the worker.
+    const int kNumBatches = 10;
+    const int kBatchSize = 100;
+    for (int batch = 0; batch < kNumBatches; ++batch) {
+        std::vector<BSONObj> docs;
+        for (int i = 0; i < kBatchSize; ++i) {
+            const int id = batch * kBatchSize + i;
+            docs.push_back(BSON("_id" << id << "x" << id % 7));
+        }
+        ASSERT_OK(loader->insertDocuments(docs.begin(), docs.end()));
+    }
+    std::vector<BSONObj> duplicate = {BSON("_id" << 0 << "x" << 0)};
+    ASSERT_OK(loader->insertDocuments(duplicate.begin(), duplicate.end()));
+    ASSERT_OK(loader->commit());
+
+    auto stats = dynamic_cast<CollectionBulkLoaderImpl*>(loader.get())->getStats();
+    ASSERT_EQ(static_cast<size_t>(kNumBatches + 1), stats.indexWorkerBatches);
+
+    AutoGetCollectionForReadCommand autoColl(opCtx, nss);
+    auto coll = autoColl.getCollection();
+    ASSERT(coll);
+    const long long kNumDocs = kNumBatches * kBatchSize;
+    ASSERT_EQ(kNumDocs, coll->getRecordStore()->numRecords(opCtx));
+    auto collIdxCat = coll->getIndexCatalog();
+    ASSERT_EQ(kNumDocs, getIndexKeyCount(opCtx, collIdxCat, collIdxCat->findIdIndex(opCtx)));
+    ASSERT_EQ(kNumDocs,
+              getIndexKeyCount(opCtx, collIdxCat, collIdxCat->findIndexByName(opCtx, "x_1")));
+}
+
 void _testDestroyUncommitedCollectionBulkLoader(
     OperationContext* opCtx,
     const NamespaceString& nss,
@@ -34,6 +34,7 @@
 #include "mongo/db/repl/sync_tail.h"
 
 #include "third_party/murmurhash3/MurmurHash3.h"
+#include <algorithm>
 #include <boost/functional/hash.hpp>
 #include <memory>
 
@@ -68,6 +69,7 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/session.h"
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/db/stats/timer_stats.h"
@@ -79,6 +81,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -87,6 +90,10 @@ namespace {
 MONGO_FAIL_POINT_DEFINE(pauseBatchApplicationBeforeCompletion);
 MONGO_FAIL_POINT_DEFINE(hangAfterRecordingOpApplicationStartTime);
 
+// When true, batches without commands write their oplog entries while the operations are applied,
+// and the next batch is assigned to writer threads while the current one is still being applied.
+MONGO_EXPORT_SERVER_PARAMETER(replPipelinedBatchApplication, bool, true);
+
 // The oplog entries applied
 Counter64 opsAppliedStats;
 ServerStatusMetricField<Counter64> displayOpsApplied("repl.apply.ops", &opsAppliedStats);
@@ -105,6 +112,66 @@ ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// Each writer thread is given this many conflict groups on average, so that the writers which
+// finish early have groups left to claim.
+const size_t kConflictGroupsPerWriter = 4;
+
+/**
+ * Reports how much work each writer thread did during batch application, as
+ * repl.apply.writers in serverStatus, so that skew between the writers can be seen. Writer 'i' is
+ * the 'i'-th task scheduled on the writer pool for each batch.
+ */
+class WriterUtilizationStats final : public ServerStatusMetric {
+public:
+    WriterUtilizationStats() : ServerStatusMetric("repl.apply.writers") {}
+
+    void record(size_t writer, long long ops, long long conflictGroups, long long busyMicros) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_writers.size() <= writer) {
+            _writers.resize(writer + 1);
+        }
+        auto& stats = _writers[writer];
+        stats.ops += ops;
+        stats.conflictGroups += conflictGroups;
+        stats.busyMicros += busyMicros;
+    }
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        BSONArrayBuilder writersBuilder(b.subarrayStart(_leafName));
+        for (auto&& stats : _writers) {
+            BSONObjBuilder writerBuilder(writersBuilder.subobjStart());
+            writerBuilder.append("ops", stats.ops);
+            writerBuilder.append("conflictGroups", stats.conflictGroups);
+            writerBuilder.append("busyMicros", stats.busyMicros);
+        }
+    }
+
+private:
+    struct Stats {
+        long long ops = 0;
+        long long conflictGroups = 0;
+        long long busyMicros = 0;
+    };
+
+    mutable stdx::mutex _mutex;
+    std::vector<Stats> _writers;
+} writerUtilizationStats;
+
+// Number of batches which were assigned to writer threads while the previous batch was applied.
+Counter64 batchesPartitionedAhead;
+ServerStatusMetricField<Counter64> displayBatchesPartitionedAhead(
+    "repl.apply.batchesPartitionedAhead", &batchesPartitionedAhead);
+
+/**
+ * Returns true if any of the operations is a command. Commands may change the collection
+ * properties that the assignment of operations to writer threads depends on, so batches containing
+ * them are applied strictly in phases.
+ */
+bool containsCommands(const MultiApplier::Operations& ops) {
+    return std::any_of(ops.begin(), ops.end(), [](const OplogEntry& op) { return op.isCommand(); });
+}
+
 class ApplyBatchFinalizer {
 public:
     ApplyBatchFinalizer(ReplicationCoordinator* replCoord) : _replCoord(replCoord) {}
@@ -415,37 +482,68 @@ const OplogApplier::Options& SyncTail::getOptions() const {
 
 namespace {
 
-// Doles out all the work to the writer pool threads.
-// Does not modify writerVectors, but passes non-const pointers to inner vectors into func.
-void applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
+// Doles out all the work to the writer pool threads and waits for it to complete. Operations in
+// different conflict groups never touch the same document, or the same collection where that is
+// required, so the groups may be applied in any order. Rather than binding each group to a writer,
+// every writer repeatedly claims the largest group that hasn't been claimed yet. A large group,
+// such as the updates to a single hot document, then occupies one writer while the others drain
+// the remaining groups.
+// Does not modify conflictGroups, but passes non-const pointers to inner vectors into func.
+void applyOps(std::vector<MultiApplier::OperationPtrs>& conflictGroups,
               ThreadPool* writerPool,
+              size_t numWriters,
               const SyncTail::MultiSyncApplyFunc& func,
               SyncTail* st,
               std::vector<Status>* statusVector,
               std::vector<WorkerMultikeyPathInfo>* workerMultikeyPathInfo) {
-    invariant(writerVectors.size() == statusVector->size());
-    for (size_t i = 0; i < writerVectors.size(); i++) {
-        if (!writerVectors[i].empty()) {
-            invariant(writerPool->schedule([
-                &func,
-                st,
-                &writer = writerVectors.at(i),
-                &status = statusVector->at(i),
-                &workerMultikeyPathInfo = workerMultikeyPathInfo->at(i)
-            ] {
-                auto opCtx = cc().makeOperationContext();
-                status = opCtx->runWithoutInterruption(
-                    [&] { return func(opCtx.get(), &writer, st, &workerMultikeyPathInfo); });
-            }));
+    invariant(conflictGroups.size() == statusVector->size());
+    invariant(conflictGroups.size() == workerMultikeyPathInfo->size());
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < conflictGroups.size(); i++) {
+        if (!conflictGroups[i].empty()) {
+            order.push_back(i);
         }
     }
+    std::stable_sort(order.begin(), order.end(), [&conflictGroups](size_t lhs, size_t rhs) {
+        return conflictGroups[lhs].size() > conflictGroups[rhs].size();
+    });
+
+    AtomicWord<unsigned long long> nextGroup{0};
+    const size_t numTasks = std::min(numWriters, order.size());
+    for (size_t writer = 0; writer < numTasks; writer++) {
+        invariant(writerPool->schedule([&, writer] {
+            Timer timer;
+            long long opsApplied = 0;
+            long long groupsApplied = 0;
+            for (auto next = nextGroup.fetchAndAdd(1); next < order.size();
+                 next = nextGroup.fetchAndAdd(1)) {
+                const auto group = order[next];
+                opsApplied += conflictGroups[group].size();
+                groupsApplied++;
+
+                auto opCtx = cc().makeOperationContext();
+                (*statusVector)[group] = opCtx->runWithoutInterruption([&] {
+                    return func(opCtx.get(),
+                                &conflictGroups[group],
+                                st,
+                                &(*workerMultikeyPathInfo)[group]);
+                });
+            }
+            writerUtilizationStats.record(
+                writer, opsApplied, groupsApplied, durationCount<Microseconds>(timer.elapsed()));
+        }));
+    }
+    writerPool->waitForIdle();
 }
 
-// Schedules the writes to the oplog for 'ops' into threadPool. The caller must guarantee that 'ops'
-// stays valid until all scheduled work in the thread pool completes.
+// Schedules the writes to the oplog for 'ops' into threadPool, using at most 'maxWriters' of its
+// threads. The caller must guarantee that 'ops' stays valid until all scheduled work in the thread
+// pool completes.
 void scheduleWritesToOplog(OperationContext* opCtx,
                            StorageInterface* storageInterface,
                            ThreadPool* threadPool,
+                           size_t maxWriters,
                            const MultiApplier::Operations& ops) {
 
     auto makeOplogWriterForRange = [storageInterface, &ops](size_t begin, size_t end) {
@@ -477,8 +575,8 @@ void scheduleWritesToOplog(OperationContext* opCtx,
     // would result too little work per thread. This also ensures that we can amortize the
     // setup/teardown overhead across many writes.
     const size_t kMinOplogEntriesPerThread = 16;
-    const bool enoughToMultiThread =
-        ops.size() >= kMinOplogEntriesPerThread * threadPool->getStats().numThreads;
+    const size_t numOplogThreads = std::min(maxWriters, threadPool->getStats().numThreads);
+    const bool enoughToMultiThread = ops.size() >= kMinOplogEntriesPerThread * numOplogThreads;
 
     // Only doc-locking engines support parallel writes to the oplog because they are required to
     // ensure that oplog entries are ordered correctly, even if inserted out-of-order. Additionally,
@@ -492,7 +590,6 @@ void scheduleWritesToOplog(OperationContext* opCtx,
     }
 
 
-    const size_t numOplogThreads = threadPool->getStats().numThreads;
     const size_t numOpsPerThread = ops.size() / numOplogThreads;
     for (size_t thread = 0; thread < numOplogThreads; thread++) {
         size_t begin = thread * numOpsPerThread;
@@ -618,7 +715,11 @@ public:
         _thread.join();
     }
 
-    OpQueue getNextBatch(Seconds maxWaitTime) {
+    /**
+     * Returns the next batch. If the batch was already assigned to writer threads while the
+     * previous batch was being applied, that assignment is returned through 'partition'.
+     */
+    OpQueue getNextBatch(Seconds maxWaitTime, std::unique_ptr<WriterPartition>* partition) {
         stdx::unique_lock<stdx::mutex> lk(_mutex);
         if (_ops.empty() && !_ops.mustShutdown()) {
             // We intentionally don't care about whether this returns due to signaling or timeout
@@ -628,6 +729,7 @@ public:
 
         OpQueue ops = std::move(_ops);
         _ops = OpQueue(0);
+        *partition = std::move(_partition);
         _cv.notify_all();
 
         return ops;
@@ -684,10 +786,30 @@ private:
                 continue;  // Don't emit empty batches.
             }
 
-            stdx::unique_lock<stdx::mutex> lk(_mutex);
-            // Block until the previous batch has been taken.
-            _cv.wait(lk, [&] { return _ops.empty(); });
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                // Block until the previous batch has been taken.
+                _cv.wait(lk, [&] { return _ops.empty(); });
+            }
+
+            // The previous batch is now being applied, so assign the operations of this one to
+            // writer threads in the meantime. This is only safe if the batch being applied cannot
+            // change the collection properties the assignment depends on. Only this thread fills
+            // _ops, so it stays empty while the assignment runs without holding _mutex.
+            const bool canPartitionAhead = !ops.empty() && !_previousBatchContainsCommands &&
+                replPipelinedBatchApplication.load();
+            if (!ops.empty()) {
+                _previousBatchContainsCommands = containsCommands(ops.getBatch());
+            }
+            std::unique_ptr<WriterPartition> partition;
+            if (canPartitionAhead) {
+                auto opCtx = cc().makeOperationContext();
+                partition = _syncTail->_partitionBatchAhead(opCtx.get(), ops.getMutableBatch());
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
             _ops = std::move(ops);
+            _partition = std::move(partition);
             _cv.notify_all();
             if (_ops.mustShutdown()) {
                 _isDead = true;
@@ -700,9 +822,13 @@ private:
     StorageInterface* const _storageInterface;
     OplogBuffer* const _oplogBuffer;
 
-    stdx::mutex _mutex;  // Guards _ops.
+    stdx::mutex _mutex;  // Guards _ops and _partition.
     stdx::condition_variable _cv;
     OpQueue _ops;
+    std::unique_ptr<WriterPartition> _partition;
+
+    // Only accessed by the batcher thread.
+    bool _previousBatchContainsCommands = false;
 
     // This only exists so the destructor invariants rather than deadlocking.
     // TODO remove once we trust noexcept enough to mark oplogApplication() as noexcept.
@@ -762,7 +888,8 @@ void SyncTail::_oplogApplication(OplogBuffer* oplogBuffer,
         long long termWhenBufferIsEmpty = replCoord->getTerm();
         // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
         // ready in time, we'll loop again so we can do the above checks periodically.
-        OpQueue ops = batcher->getNextBatch(Seconds(1));
+        std::unique_ptr<WriterPartition> partition;
+        OpQueue ops = batcher->getNextBatch(Seconds(1), &partition);
         if (ops.empty()) {
             if (ops.mustShutdown()) {
                 // Shut down and exit oplog application loop.
@@ -797,8 +924,8 @@ void SyncTail::_oplogApplication(OplogBuffer* oplogBuffer,
 
         // Apply the operations in this batch. 'multiApply' returns the optime of the last op that
         // was applied, which should be the last optime in the batch.
-        auto lastOpTimeAppliedInBatch =
-            fassertNoTrace(34437, multiApply(&opCtx, ops.releaseBatch()));
+        auto lastOpTimeAppliedInBatch = fassertNoTrace(
+            34437, _multiApply(&opCtx, ops.releaseBatch(), std::move(partition)));
         invariant(lastOpTimeAppliedInBatch == lastOpTimeInBatch);
 
         // In order to provide resilience in the event of a crash in the middle of batch
@@ -1205,7 +1332,9 @@ Status multiSyncApply(OperationContext* opCtx,
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
- * writerVectors - Set of operations for each worker thread to apply.
+ * writerVectors - Conflict groups of operations. Operations which may conflict with each other
+ *      are always assigned to the same group, in oplog order. The writer threads claim the
+ *      groups one at a time.
  * derivedOps - If provided, this function inserts a decomposition of applyOps operations
  *      and instructions for updating the transactions table.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
@@ -1308,7 +1437,38 @@ void SyncTail::_fillWriterVectors(OperationContext* opCtx,
     }
 }
 
+std::unique_ptr<SyncTail::WriterPartition> SyncTail::_partitionBatch(
+    OperationContext* opCtx, MultiApplier::Operations* ops) {
+    auto partition = stdx::make_unique<WriterPartition>();
+    partition->writerVectors.resize(_writerPool->getStats().numThreads *
+                                    kConflictGroupsPerWriter);
+    _fillWriterVectors(opCtx, ops, &partition->writerVectors, &partition->derivedOps);
+    return partition;
+}
+
+std::unique_ptr<SyncTail::WriterPartition> SyncTail::_partitionBatchAhead(
+    OperationContext* opCtx, MultiApplier::Operations* ops) {
+    // See the comment on the UninterruptibleLockGuard in OpQueueBatcher::run(). The batch being
+    // applied holds the parallel batch writer lock, which must not block the collection lookups.
+    UninterruptibleLockGuard noInterrupt(opCtx->lockState());
+    ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(opCtx->lockState());
+
+    return _partitionBatch(opCtx, ops);
+}
+
 StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::Operations ops) {
+    return _multiApply(opCtx, std::move(ops), nullptr);
+}
+
+StatusWith<OpTime> SyncTail::multiApplyPartitionedAheadForTest(OperationContext* opCtx,
+                                                               MultiApplier::Operations ops) {
+    auto partition = _partitionBatchAhead(opCtx, &ops);
+    return _multiApply(opCtx, std::move(ops), std::move(partition));
+}
+
+StatusWith<OpTime> SyncTail::_multiApply(OperationContext* opCtx,
+                                         MultiApplier::Operations ops,
+                                         std::unique_ptr<WriterPartition> partition) {
     invariant(!ops.empty());
 
     LOG(2) << "replication batch size is " << ops.size();
@@ -1326,7 +1486,17 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
     // Increment the batch size stat.
     oplogApplicationBatchSize.increment(ops.size());
 
-    std::vector<WorkerMultikeyPathInfo> multikeyVector(_writerPool->getStats().numThreads);
+    const auto numWriters = _writerPool->getStats().numThreads;
+    const auto numConflictGroups = numWriters * kConflictGroupsPerWriter;
+
+    // A batch without commands can have its oplog entries written while its operations are
+    // applied. Should the node fail in the middle, the 'oplogTruncateAfterPoint' removes the
+    // partially written oplog entries and 'minValid', which already covers the whole batch, keeps
+    // the node from considering the partially applied data consistent.
+    const bool overlapOplogWrites = !_options.skipWritesToOplog &&
+        replPipelinedBatchApplication.load() && !containsCommands(ops);
+
+    std::vector<WorkerMultikeyPathInfo> multikeyVector(numConflictGroups);
     {
         // Each node records cumulative batch application stats for itself using this timer.
         TimerHolder timer(&applyBatchStats);
@@ -1338,34 +1508,52 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
         // Write batch of ops into oplog.
         if (!_options.skipWritesToOplog) {
             _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, ops.front().getTimestamp());
-            scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, ops);
+            if (overlapOplogWrites) {
+                _consistencyMarkers->setMinValidToAtLeast(opCtx, ops.back().getOpTime());
+            }
+            // The writes are scheduled first, so when the operations are applied at the same time
+            // they must leave most writer threads free for them.
+            const size_t maxOplogWriters =
+                overlapOplogWrites ? std::max<size_t>(1, numWriters / 4) : numWriters;
+            scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, maxOplogWriters, ops);
         }
 
-        // Holds 'pseudo operations' generated by secondaries to aid in replication.
-        // Keep in scope until all operations in 'ops' and 'derivedOps' have been applied.
-        // Pseudo operations include:
+        // Holds 'pseudo operations' generated by secondaries to aid in replication in its
+        // 'derivedOps'. Keep in scope until all operations in 'ops' and 'derivedOps' have been
+        // applied. Pseudo operations include:
         // - applyOps operations expanded to individual ops.
         // - ops to update config.transactions. Normal writes to config.transactions in the
         //   primary don't create an oplog entry, so extract info from writes with transactions
         //   and create a pseudo oplog.
-        std::vector<MultiApplier::Operations> derivedOps;
-
-        std::vector<MultiApplier::OperationPtrs> writerVectors(_writerPool->getStats().numThreads);
-        _fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        //
+        // The batcher may already have assigned the operations to writer threads while the
+        // previous batch was being applied.
+        if (partition && partition->writerVectors.size() == numConflictGroups) {
+            batchesPartitionedAhead.increment();
+        } else {
+            partition = _partitionBatch(opCtx, &ops);
+        }
 
-        // Wait for writes to finish before applying ops.
-        _writerPool->waitForIdle();
+        if (!overlapOplogWrites) {
+            // Wait for writes to finish before applying ops.
+            _writerPool->waitForIdle();
 
-        // Reset consistency markers in case the node fails while applying ops.
-        if (!_options.skipWritesToOplog) {
-            _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
-            _consistencyMarkers->setMinValidToAtLeast(opCtx, ops.back().getOpTime());
+            // Reset consistency markers in case the node fails while applying ops.
+            if (!_options.skipWritesToOplog) {
+                _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
+                _consistencyMarkers->setMinValidToAtLeast(opCtx, ops.back().getOpTime());
+            }
         }
 
         {
-            std::vector<Status> statusVector(_writerPool->getStats().numThreads, Status::OK());
-            applyOps(writerVectors, _writerPool, _applyFunc, this, &statusVector, &multikeyVector);
-            _writerPool->waitForIdle();
+            std::vector<Status> statusVector(numConflictGroups, Status::OK());
+            applyOps(partition->writerVectors,
+                     _writerPool,
+                     numWriters,
+                     _applyFunc,
+                     this,
+                     &statusVector,
+                     &multikeyVector);
 
             // If any of the statuses is not ok, return error.
             for (auto it = statusVector.cbegin(); it != statusVector.cend(); ++it) {
@@ -1375,12 +1563,18 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
                         << "Failed to apply batch of operations. Number of operations in batch: "
                         << ops.size() << ". First operation: " << redact(ops.front().toBSON())
                         << ". Last operation: " << redact(ops.back().toBSON())
-                        << ". Oplog application failed in writer thread "
+                        << ". Oplog application failed in conflict group "
                         << std::distance(statusVector.cbegin(), it) << ": " << redact(status);
                     return status;
                 }
             }
         }
+
+        // Both the oplog writes and the operations have finished, so the oplog no longer needs to
+        // be truncated should the node fail.
+        if (overlapOplogWrites) {
+            _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
+        }
     }
 
     // Notify the storage engine that a replication batch has completed. This means that all the
@@ -88,8 +88,9 @@ public:
      * During steady state replication, oplogApplication() obtains batches of operations to apply
      * from 'observer'. It is not required to provide 'observer' at construction if we do not plan
      * on using oplogApplication(). During the oplog application phase, the batch of operations is
-     * distributed across writer threads in 'writerPool'. Each writer thread applies its own vector
-     * of operations using 'func'. The writer thread pool is not owned by us.
+     * split into groups of operations which may conflict with each other. The writer threads in
+     * 'writerPool' claim these groups one at a time and apply each using 'func'. The writer thread
+     * pool is not owned by us.
      */
     SyncTail(OplogApplier::Observer* observer,
              ReplicationConsistencyMarkers* consistencyMarkers,
@@ -153,6 +154,9 @@ public:
         const std::vector<OplogEntry>& getBatch() const {
             return _batch;
         }
+        std::vector<OplogEntry>* getMutableBatch() {
+            return &_batch;
+        }
 
         void emplace_back(BSONObj obj) {
             invariant(!_mustShutdown);
@@ -228,7 +232,9 @@ public:
      * Applies a batch of oplog entries by writing the oplog entries to the local oplog and then
      * using a set of threads to apply the operations. It will only apply (but will
      * still write to the oplog) oplog entries with a timestamp greater than or equal to the
-     * beginApplyingTimestamp.
+     * beginApplyingTimestamp. Unless the batch contains commands or the
+     * replPipelinedBatchApplication server parameter is off, the oplog entries are written while
+     * the operations are applied.
      *
      * If the batch application is successful, returns the optime of the last op applied, which
      * should be the last op in the batch.
@@ -240,7 +246,25 @@ public:
      */
     StatusWith<OpTime> multiApply(OperationContext* opCtx, MultiApplier::Operations ops);
 
+    /**
+     * Like multiApply(), but assigns the operations to writer threads the way the batcher does
+     * while the previous batch is being applied. For testing only.
+     */
+    StatusWith<OpTime> multiApplyPartitionedAheadForTest(OperationContext* opCtx,
+                                                         MultiApplier::Operations ops);
+
 private:
+    /**
+     * The operations of a batch split into conflict groups, which the writer threads claim one at a
+     * time. The pointers in 'writerVectors' refer to the batch and to 'derivedOps', so the vectors
+     * holding the operations may be moved but must not be copied or resized while the partition
+     * is in use.
+     */
+    struct WriterPartition {
+        std::vector<MultiApplier::OperationPtrs> writerVectors;
+        std::vector<MultiApplier::Operations> derivedOps;
+    };
+
     /**
      * Pops the operation at the front of the OplogBuffer.
      * Updates stats on BackgroundSync.
@@ -264,6 +288,27 @@ private:
                             std::vector<MultiApplier::OperationPtrs>* writerVectors,
                             std::vector<MultiApplier::Operations>* derivedOps);
 
+    /**
+     * Splits the operations in 'ops' into conflict groups for the writer threads.
+     */
+    std::unique_ptr<WriterPartition> _partitionBatch(OperationContext* opCtx,
+                                                     MultiApplier::Operations* ops);
+
+    /**
+     * Assigns the operations in 'ops' to the writer threads from outside of batch application,
+     * without conflicting with the parallel batch writer lock held by the batch being applied.
+     */
+    std::unique_ptr<WriterPartition> _partitionBatchAhead(OperationContext* opCtx,
+                                                          MultiApplier::Operations* ops);
+
+    /**
+     * Implements multiApply(). If 'partition' is set, it is the assignment of 'ops' to the writer
+     * threads computed while the previous batch was being applied.
+     */
+    StatusWith<OpTime> _multiApply(OperationContext* opCtx,
+                                   MultiApplier::Operations ops,
+                                   std::unique_ptr<WriterPartition> partition);
+
     OplogApplier::Observer* const _observer;
     ReplicationConsistencyMarkers* const _consistencyMarkers;
     StorageInterface* const _storageInterface;
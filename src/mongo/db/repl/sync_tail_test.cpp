@@ -35,6 +35,7 @@
 #include <vector>
 
 #include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/collection_options.h"
@@ -43,6 +44,7 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/feature_compatibility_version_parser.h"
+#include "mongo/db/commands/server_status_internal.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
@@ -62,6 +64,7 @@
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/sync_tail.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/session_txn_record_gen.h"
@@ -458,6 +461,202 @@ TEST_F(SyncTailTest,
                                                      createOplogCollectionOptions()));
 }
 
+/**
+ * Applies two inserts with multiApply() and returns the oplog truncate after points seen by the
+ * writer threads while they applied the operations.
+ */
+std::vector<Timestamp> _testTruncateAfterPointsSeenDuringApplication(
+    OperationContext* opCtx,
+    ReplicationConsistencyMarkers* const consistencyMarkers,
+    StorageInterface* const storageInterface,
+    const NamespaceString& nss,
+    bool pipelined) {
+    ASSERT_OK(ServerParameterSet::getGlobal()
+                  ->getMap()
+                  .find("replPipelinedBatchApplication")
+                  ->second->setFromString(pipelined ? "true" : "false"));
+    ON_BLOCK_EXIT([] {
+        ASSERT_OK(ServerParameterSet::getGlobal()
+                      ->getMap()
+                      .find("replPipelinedBatchApplication")
+                      ->second->setFromString("true"));
+    });
+
+    createCollection(opCtx, nss, CollectionOptions());
+    auto op1 = makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1));
+    auto op2 = makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2));
+
+    stdx::mutex mutex;
+    std::vector<OpTime> minValids;
+    std::vector<Timestamp> truncateAfterPoints;
+    auto applyOperationFn = [&](OperationContext* opCtx,
+                                MultiApplier::OperationPtrs*,
+                                SyncTail*,
+                                WorkerMultikeyPathInfo*) -> Status {
+        auto minValid = consistencyMarkers->getMinValid(opCtx);
+        auto truncateAfterPoint = consistencyMarkers->getOplogTruncateAfterPoint(opCtx);
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        minValids.push_back(minValid);
+        truncateAfterPoints.push_back(truncateAfterPoint);
+        return Status::OK();
+    };
+
+    auto writerPool = OplogApplier::makeWriterPool();
+    SyncTail syncTail(
+        nullptr, consistencyMarkers, storageInterface, applyOperationFn, writerPool.get());
+    ASSERT_EQUALS(op2.getOpTime(), unittest::assertGet(syncTail.multiApply(opCtx, {op1, op2})));
+
+    // 'minValid' must cover the whole batch before any operation is applied.
+    for (auto&& minValid : minValids) {
+        ASSERT_EQUALS(op2.getOpTime(), minValid);
+    }
+
+    // The oplog entries have been written once the batch is applied.
+    ASSERT_EQUALS(Timestamp(), consistencyMarkers->getOplogTruncateAfterPoint(opCtx));
+    ASSERT_FALSE(truncateAfterPoints.empty());
+    return truncateAfterPoints;
+}
+
+TEST_F(SyncTailTest, MultiApplyWritesOplogEntriesWhileApplyingCrudBatchWhenPipelined) {
+    NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    auto truncateAfterPoints = _testTruncateAfterPointsSeenDuringApplication(
+        _opCtx.get(), getConsistencyMarkers(), getStorageInterface(), nss, true);
+    for (auto&& truncateAfterPoint : truncateAfterPoints) {
+        ASSERT_EQUALS(Timestamp(Seconds(1), 0), truncateAfterPoint);
+    }
+}
+
+TEST_F(SyncTailTest, MultiApplyWritesOplogEntriesBeforeApplyingWhenNotPipelined) {
+    NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    auto truncateAfterPoints = _testTruncateAfterPointsSeenDuringApplication(
+        _opCtx.get(), getConsistencyMarkers(), getStorageInterface(), nss, false);
+    for (auto&& truncateAfterPoint : truncateAfterPoints) {
+        ASSERT_EQUALS(Timestamp(), truncateAfterPoint);
+    }
+}
+
+TEST_F(SyncTailTest, MultiApplyKeepsConflictingOperationsInOneGroupInOplogOrder) {
+    NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createCollection(_opCtx.get(), nss, CollectionOptions());
+    std::vector<NamespaceString> otherNss;
+    for (int i = 0; i < 8; i++) {
+        otherNss.emplace_back(nss.ns() + "_" + std::to_string(i));
+        createCollection(_opCtx.get(), otherNss.back(), CollectionOptions());
+    }
+
+    // Many updates to one hot document, interleaved with inserts into other collections. The
+    // test storage engine doesn't support document locking, so operations only conflict by
+    // namespace.
+    MultiApplier::Operations ops;
+    for (int i = 0; i < 200; i++) {
+        const OpTime opTime(Timestamp(Seconds(1), i + 1), 1LL);
+        if (i % 2 == 0) {
+            ops.push_back(makeUpdateDocumentOplogEntry(
+                opTime, nss, BSON("_id" << 0), BSON("$set" << BSON("x" << i))));
+        } else {
+            ops.push_back(makeInsertDocumentOplogEntry(
+                opTime, otherNss[i % otherNss.size()], BSON("_id" << i)));
+        }
+    }
+
+    stdx::mutex mutex;
+    std::vector<std::vector<OplogEntry>> groupsApplied;
+    auto applyOperationFn = [&](OperationContext*,
+                                MultiApplier::OperationPtrs* operationsToApply,
+                                SyncTail*,
+                                WorkerMultikeyPathInfo*) -> Status {
+        std::vector<OplogEntry> group;
+        for (auto&& opPtr : *operationsToApply) {
+            group.push_back(*opPtr);
+        }
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        groupsApplied.push_back(std::move(group));
+        return Status::OK();
+    };
+
+    auto writerPool = OplogApplier::makeWriterPool();
+    SyncTail syncTail(nullptr,
+                      getConsistencyMarkers(),
+                      getStorageInterface(),
+                      applyOperationFn,
+                      writerPool.get());
+    ASSERT_EQUALS(ops.back().getOpTime(),
+                  unittest::assertGet(syncTail.multiApply(_opCtx.get(), ops)));
+
+    // The inserts were applied in other groups than the one holding the hot document.
+    ASSERT_GREATER_THAN(groupsApplied.size(), 1U);
+
+    size_t numOpsApplied = 0;
+    size_t numGroupsWithHotDocument = 0;
+    for (auto&& group : groupsApplied) {
+        numOpsApplied += group.size();
+
+        std::vector<OpTime> hotDocumentOpTimes;
+        for (auto&& op : group) {
+            if (op.getNss() == nss) {
+                hotDocumentOpTimes.push_back(op.getOpTime());
+            }
+        }
+        if (hotDocumentOpTimes.empty()) {
+            continue;
+        }
+        numGroupsWithHotDocument++;
+        ASSERT_EQUALS(100U, hotDocumentOpTimes.size());
+        ASSERT_TRUE(std::is_sorted(hotDocumentOpTimes.begin(), hotDocumentOpTimes.end()));
+    }
+    ASSERT_EQUALS(ops.size(), numOpsApplied);
+    ASSERT_EQUALS(1U, numGroupsWithHotDocument);
+}
+
+long long getBatchesPartitionedAhead() {
+    BSONObjBuilder bob;
+    MetricTree::theMetricTree->appendTo(bob);
+    auto metrics = bob.obj();
+    return dotted_path_support::extractElementAtPath(metrics,
+                                                     "metrics.repl.apply.batchesPartitionedAhead")
+        .numberLong();
+}
+
+TEST_F(SyncTailTest, MultiApplyAppliesOperationsAssignedToWriterThreadsAhead) {
+    NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createCollection(_opCtx.get(), nss, CollectionOptions());
+    auto op1 = makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1));
+    auto op2 = makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2));
+
+    stdx::mutex mutex;
+    std::vector<BSONObj> appliedOps;
+    auto applyOperationFn = [&](OperationContext*,
+                                MultiApplier::OperationPtrs* ops,
+                                SyncTail*,
+                                WorkerMultikeyPathInfo*) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        for (auto&& op : *ops) {
+            appliedOps.push_back(op->getObject().getOwned());
+        }
+        return Status::OK();
+    };
+
+    auto writerPool = OplogApplier::makeWriterPool();
+    SyncTail syncTail(nullptr,
+                      getConsistencyMarkers(),
+                      getStorageInterface(),
+                      applyOperationFn,
+                      writerPool.get());
+
+    // Batches assigned to writer threads by multiApply() itself are not counted.
+    auto batchesPartitionedAhead = getBatchesPartitionedAhead();
+    ASSERT_EQUALS(op1.getOpTime(), unittest::assertGet(syncTail.multiApply(_opCtx.get(), {op1})));
+    ASSERT_EQUALS(batchesPartitionedAhead, getBatchesPartitionedAhead());
+    ASSERT_EQUALS(1U, appliedOps.size());
+
+    auto lastOpTime =
+        unittest::assertGet(syncTail.multiApplyPartitionedAheadForTest(_opCtx.get(), {op2}));
+    ASSERT_EQUALS(op2.getOpTime(), lastOpTime);
+    ASSERT_EQUALS(batchesPartitionedAhead + 1, getBatchesPartitionedAhead());
+    ASSERT_EQUALS(2U, appliedOps.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), appliedOps.back());
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     auto op = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss);
@@ -61,6 +61,7 @@
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/query/find.h"
+#include "mongo/db/query/find_common.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/read_concern_args.h"
@@ -919,6 +920,10 @@ DbResponse receivedCommands(OperationContext* opCtx,
         try {  // Execute.
             curOpCommandSetup(opCtx, request);
 
+            // The service state machine answers an exhaust getMore with a stream of replies, so
+            // the command may split its results across them.
+            replyIsStreamed(opCtx) = OpMsg::isFlagSet(message, OpMsg::kExhaustSupported);
+
             Command* c = nullptr;
             // In the absence of a Command object, no redaction is possible. Therefore
             // to avoid displaying potentially sensitive information in the logs,
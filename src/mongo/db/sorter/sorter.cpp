@@ -56,12 +56,16 @@
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/sorter/sorter_thread_pool.h"
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/unowned_ptr.h"
@@ -322,6 +326,10 @@ private:
  * Merge-sorts results from 0 or more FileIterators, all of which should be iterating over sorted
  * ranges within the same file. This class is given the data source file name upon construction and
  * is responsible for deleting the data source file upon destruction.
+ *
+ * The merge is driven by a tournament ("loser") tree rather than a binary heap. Replacing the
+ * winner only requires replaying the matches on the path from its leaf to the root, which is
+ * log2(N) comparisons per returned item instead of the ~2*log2(N) a heap needs to sift down.
  */
 template <typename Key, typename Value, typename Comparator>
 class MergeIterator : public SortIteratorInterface<Key, Value> {
@@ -336,33 +344,30 @@ public:
         : _opts(opts),
           _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
           _first(true),
-          _greater(comp),
+          _comp(comp),
           _itersSourceFileName(itersSourceFileName) {
         for (size_t i = 0; i < iters.size(); i++) {
             iters[i]->openSource();
             if (iters[i]->more()) {
-                _heap.push_back(std::make_shared<Stream>(i, iters[i]->next(), iters[i]));
+                _streams.push_back(std::make_unique<Stream>(i, iters[i]->next(), iters[i]));
+                _liveStreams++;
             } else {
                 iters[i]->closeSource();
             }
         }
 
-        if (_heap.empty()) {
+        if (_streams.empty()) {
             _remaining = 0;
             return;
         }
 
-        std::make_heap(_heap.begin(), _heap.end(), _greater);
-        std::pop_heap(_heap.begin(), _heap.end(), _greater);
-        _current = _heap.back();
-        _heap.pop_back();
+        buildTree();
     }
 
     ~MergeIterator() {
         // Clear the remaining Stream objects first, to close the file handles before deleting the
         // file. Some systems will error closing the file if any file handles are still open.
-        _current.reset();
-        _heap.clear();
+        _streams.clear();
         DESTRUCTOR_GUARD(boost::filesystem::remove(_itersSourceFileName));
     }
 
@@ -370,7 +375,7 @@ public:
     void closeSource() {}
 
     bool more() {
-        if (_remaining > 0 && (_first || !_heap.empty() || _current->more()))
+        if (_remaining > 0 && (_first || _liveStreams > 1 || _streams[_tree[0]]->more()))
             return true;
 
         _remaining = 0;
@@ -384,21 +389,19 @@ public:
 
         if (_first) {
             _first = false;
-            return _current->current();
+            return _streams[_tree[0]]->current();
         }
 
-        if (!_current->advance()) {
-            verify(!_heap.empty());
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            _current = _heap.back();
-            _heap.pop_back();
-        } else if (!_heap.empty() && _greater(_current, _heap.front())) {
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            std::swap(_current, _heap.back());
-            std::push_heap(_heap.begin(), _heap.end(), _greater);
+        const size_t winner = _tree[0];
+        if (!_streams[winner]->advance()) {
+            // Closes the exhausted source. An empty slot loses every match from now on.
+            _streams[winner].reset();
+            _liveStreams--;
+            verify(_liveStreams > 0);
         }
+        replay(winner);
 
-        return _current->current();
+        return _streams[_tree[0]]->current();
     }
 
 
@@ -440,33 +443,237 @@ private:
         std::shared_ptr<Input> _rest;
     };
 
-    class STLComparator {  // uses greater rather than less-than to maintain a MinHeap
-    public:
-        explicit STLComparator(const Comparator& comp) : _comp(comp) {}
-        bool operator()(unowned_ptr<const Stream> lhs, unowned_ptr<const Stream> rhs) const {
-            // first compare data
-            dassertCompIsSane(_comp, lhs->current(), rhs->current());
-            int ret = _comp(lhs->current(), rhs->current());
-            if (ret)
-                return ret > 0;
-
-            // then compare fileNums to ensure stability
-            return lhs->fileNum > rhs->fileNum;
+    /**
+     * Returns true if the stream at index 'lhs' should be returned before the stream at index
+     * 'rhs'. Exhausted streams lose to everything.
+     */
+    bool beats(size_t lhs, size_t rhs) const {
+        const auto& lhsStream = _streams[lhs];
+        const auto& rhsStream = _streams[rhs];
+        if (!lhsStream)
+            return false;
+        if (!rhsStream)
+            return true;
+
+        // first compare data
+        dassertCompIsSane(_comp, lhsStream->current(), rhsStream->current());
+        int ret = _comp(lhsStream->current(), rhsStream->current());
+        if (ret)
+            return ret < 0;
+
+        // then compare fileNums to ensure stability
+        return lhsStream->fileNum < rhsStream->fileNum;
+    }
+
+    /**
+     * Plays the initial tournament. The leaves are the streams, stored implicitly at positions
+     * [N, 2N) of a complete binary tree; each internal node [1, N) records the loser of the match
+     * played there and _tree[0] records the overall winner.
+     */
+    void buildTree() {
+        const size_t numStreams = _streams.size();
+        _tree.assign(numStreams, 0);
+
+        std::vector<size_t> winners(2 * numStreams);
+        for (size_t i = 0; i < numStreams; i++) {
+            winners[numStreams + i] = i;
         }
+        for (size_t node = numStreams - 1; node > 0; node--) {
+            const size_t left = winners[2 * node];
+            const size_t right = winners[2 * node + 1];
+            if (beats(right, left)) {
+                winners[node] = right;
+                _tree[node] = left;
+            } else {
+                winners[node] = left;
+                _tree[node] = right;
+            }
+        }
+        _tree[0] = winners[1];
+    }
 
-    private:
-        const Comparator _comp;
-    };
+    /**
+     * Replays the matches on the path from the leaf of 'stream' to the root after its current
+     * value changed, leaving the new overall winner in _tree[0].
+     */
+    void replay(size_t stream) {
+        size_t winner = stream;
+        for (size_t node = (_streams.size() + stream) / 2; node > 0; node /= 2) {
+            if (beats(_tree[node], winner)) {
+                std::swap(_tree[node], winner);
+            }
+        }
+        _tree[0] = winner;
+    }
 
     SortOptions _opts;
     unsigned long long _remaining;
     bool _first;
-    std::shared_ptr<Stream> _current;
-    std::vector<std::shared_ptr<Stream>> _heap;  // MinHeap
-    STLComparator _greater;                      // named so calls make sense
+    const Comparator _comp;
+    std::vector<std::unique_ptr<Stream>> _streams;  // Indexed by position in the tree.
+    std::vector<size_t> _tree;                      // Loser tree over indexes into _streams.
+    size_t _liveStreams = 0;                        // Streams that have not been exhausted.
     std::string _itersSourceFileName;
 };
 
+/**
+ * Runs 'task' on the shared parallel sort pool, or on the calling thread if the pool is no longer
+ * accepting work.
+ */
+template <typename Task>
+void scheduleSortTask(Task task) {
+    auto sharedTask = std::make_shared<Task>(std::move(task));
+    if (!getParallelSortPool()->schedule([sharedTask] { (*sharedTask)(); }).isOK()) {
+        (*sharedTask)();
+    }
+}
+
+/**
+ * Sorts and spills the runs of a parallel NoLimitSorter on the shared sort pool, so that the
+ * caller can keep adding data while earlier runs are being sorted and written out.
+ *
+ * Runs are sorted concurrently, but they are appended to the shared spill file strictly in the
+ * order in which they were handed off. This keeps the file ranges contiguous and preserves the run
+ * order, which MergeIterator relies on to keep the merge stable.
+ */
+template <typename Key, typename Value, typename Comparator>
+class ParallelRunWriter {
+    MONGO_DISALLOW_COPYING(ParallelRunWriter);
+
+public:
+    typedef std::pair<Key, Value> Data;
+    typedef SortIteratorInterface<Key, Value> Iterator;
+    typedef std::pair<typename Key::SorterDeserializeSettings,
+                      typename Value::SorterDeserializeSettings>
+        Settings;
+
+    ParallelRunWriter(const SortOptions& opts,
+                      const std::string& fileName,
+                      const Comparator& comp,
+                      const Settings& settings,
+                      size_t maxRunsInFlight)
+        : _comp(comp),
+          _settings(settings),
+          _opts(opts),
+          _fileName(fileName),
+          _maxRunsInFlight(maxRunsInFlight) {
+        invariant(_maxRunsInFlight > 0);
+    }
+
+    ~ParallelRunWriter() {
+        // The owning Sorter deletes the spill file after this, so nothing may still be writing.
+        waitForAll();
+    }
+
+    /**
+     * Hands off an unsorted run to be sorted and spilled in the background. Blocks while the
+     * maximum number of runs is already in flight. Throws if an earlier run failed.
+     */
+    void addRun(std::deque<Data> run) {
+        size_t runIndex;
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _runFinished.wait(lk, [&] { return _runsInFlight < _maxRunsInFlight; });
+            uassertStatusOK(_status);
+            runIndex = _iters.size();
+            _iters.emplace_back();
+            ++_runsInFlight;
+        }
+        scheduleSortTask([ this, runIndex, run = std::move(run) ]() mutable {
+            sortAndWrite(runIndex, std::move(run));
+        });
+    }
+
+    /**
+     * Waits for every run to be written and returns iterators over them, in hand-off order.
+     */
+    std::vector<std::shared_ptr<Iterator>> done() {
+        waitForAll();
+        checkStatus();
+        return std::move(_iters);
+    }
+
+private:
+    void waitForAll() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _runFinished.wait(lk, [&] { return _runsInFlight == 0; });
+    }
+
+    void checkStatus() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        uassertStatusOK(_status);
+    }
+
+    void sortAndWrite(size_t runIndex, std::deque<Data> run) {
+        Status status = Status::OK();
+        try {
+            std::stable_sort(run.begin(), run.end(), [this](const Data& lhs, const Data& rhs) {
+                dassertCompIsSane(_comp, lhs, rhs);
+                return _comp(lhs, rhs) < 0;
+            });
+        } catch (...) {
+            status = exceptionToStatus();
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _turnToWrite.wait(lk, [&] { return _nextRunToWrite == runIndex; });
+        if (!status.isOK()) {
+            _status = status;
+        }
+
+        // Only the run whose turn it is touches the file, so the write itself can be done without
+        // holding the mutex. Later runs are skipped once any run has failed.
+        if (_status.isOK()) {
+            const std::streampos fileOffset = _nextFileOffset;
+            lk.unlock();
+
+            std::shared_ptr<Iterator> iter;
+            std::streampos fileEndOffset;
+            try {
+                SortedFileWriter<Key, Value> writer(_opts, _fileName, fileOffset, _settings);
+                for (; !run.empty(); run.pop_front()) {
+                    writer.addAlreadySorted(run.front().first, run.front().second);
+                }
+                iter.reset(writer.done());
+                fileEndOffset = writer.getFileEndOffset();
+            } catch (...) {
+                status = exceptionToStatus();
+            }
+
+            lk.lock();
+            if (status.isOK()) {
+                _iters[runIndex] = std::move(iter);
+                _nextFileOffset = fileEndOffset;
+            } else {
+                _status = status;
+            }
+        }
+
+        _nextRunToWrite++;
+        _turnToWrite.notify_all();
+        --_runsInFlight;
+        _runFinished.notify_all();
+    }
+
+    const Comparator _comp;
+    const Settings _settings;
+    const SortOptions _opts;
+    const std::string _fileName;
+    const size_t _maxRunsInFlight;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _turnToWrite;
+    stdx::condition_variable _runFinished;
+
+    // Guarded by _mutex. The slot for each run is created on hand-off and filled in by the worker
+    // once the run has been written.
+    std::vector<std::shared_ptr<Iterator>> _iters;
+    size_t _nextRunToWrite = 0;
+    std::streampos _nextFileOffset = 0;
+    size_t _runsInFlight = 0;
+    Status _status = Status::OK();
+};
+
 template <typename Key, typename Value, typename Comparator>
 class NoLimitSorter : public Sorter<Key, Value> {
 public:
@@ -484,9 +691,19 @@ public:
         if (_opts.extSortAllowed) {
             _fileName = _opts.tempDir + "/" + nextFileName();
         }
+
+        // In parallel mode up to 'parallelism' runs are held in memory at once: the one being
+        // filled and the ones being sorted or written in the background.
+        _spillThresholdBytes = _opts.maxMemoryUsageBytes;
+        if (_opts.extSortAllowed && _opts.parallelism > 1) {
+            _spillThresholdBytes /= _opts.parallelism;
+        }
     }
 
     ~NoLimitSorter() {
+        // Background spills must finish before the file can be removed.
+        _runWriter.reset();
+
         if (!_done) {
             // If done() was never called to return a MergeIterator, then this Sorter still owns
             // file deletion.
@@ -501,20 +718,29 @@ public:
 
         _memUsed += key.memUsageForSorter();
         _memUsed += val.memUsageForSorter();
+        if (_opts.parallelism > 1) {
+            // parallelSort() merges the sorted chunks through a scratch buffer of up to one Data
+            // per element.
+            _memUsed += sizeof(Data);
+        }
 
-        if (_memUsed > _opts.maxMemoryUsageBytes)
+        if (_memUsed > _spillThresholdBytes)
             spill();
     }
 
     Iterator* done() {
         invariant(!_done);
 
-        if (_iters.empty()) {
+        if (_iters.empty() && !_runWriter) {
             sort();
             return new InMemIterator<Key, Value>(_data);
         }
 
         spill();
+        if (_runWriter) {
+            _iters = _runWriter->done();
+            _runWriter.reset();
+        }
         Iterator* mergeIt = Iterator::merge(_iters, _fileName, _opts, _comp);
         _done = true;
         return mergeIt;
@@ -535,6 +761,11 @@ private:
 
     void sort() {
         STLComparator less(_comp);
+        if (_opts.parallelism > 1 && _data.size() >= 2 * kMinParallelSortChunkSize) {
+            parallelSort(less);
+            return;
+        }
+
         std::stable_sort(_data.begin(), _data.end(), less);
 
         // Does 2x more compares than stable_sort
@@ -542,6 +773,61 @@ private:
         // std::sort(_data.begin(), _data.end(), comp);
     }
 
+    /**
+     * Splits _data into up to 'parallelism' chunks, sorts them concurrently and then merges them.
+     * Both steps are stable, so the result is the same as a single stable_sort.
+     */
+    void parallelSort(const STLComparator& less) {
+        typedef typename std::deque<Data>::iterator DataIterator;
+
+        const size_t numChunks =
+            std::min(_opts.parallelism, _data.size() / kMinParallelSortChunkSize);
+        std::vector<DataIterator> bounds;
+        for (size_t i = 0; i < numChunks; i++) {
+            bounds.push_back(_data.begin() + i * _data.size() / numChunks);
+        }
+        bounds.push_back(_data.end());
+
+        std::vector<Status> statuses(numChunks, Status::OK());
+        auto sortChunk = [&](size_t chunk) {
+            try {
+                std::stable_sort(bounds[chunk], bounds[chunk + 1], less);
+            } catch (...) {
+                statuses[chunk] = exceptionToStatus();
+            }
+        };
+
+        stdx::mutex mutex;
+        stdx::condition_variable chunkSorted;
+        size_t chunksLeft = numChunks - 1;
+        for (size_t i = 1; i < numChunks; i++) {
+            scheduleSortTask([&, i] {
+                sortChunk(i);
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (--chunksLeft == 0) {
+                    chunkSorted.notify_one();
+                }
+            });
+        }
+        sortChunk(0);
+        {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            chunkSorted.wait(lk, [&] { return chunksLeft == 0; });
+        }
+        for (auto&& status : statuses) {
+            uassertStatusOK(status);
+        }
+
+        for (size_t width = 1; width < numChunks; width *= 2) {
+            for (size_t i = 0; i + width < numChunks; i += 2 * width) {
+                std::inplace_merge(bounds[i],
+                                   bounds[i + width],
+                                   bounds[std::min(i + 2 * width, numChunks)],
+                                   less);
+            }
+        }
+    }
+
     void spill() {
         invariant(!_done);
 
@@ -562,6 +848,17 @@ private:
                           << " Pass allowDiskUse:true to opt in.");
         }
 
+        if (_opts.parallelism > 1) {
+            if (!_runWriter) {
+                _runWriter = std::make_unique<ParallelRunWriter<Key, Value, Comparator>>(
+                    _opts, _fileName, _comp, _settings, _opts.parallelism - 1);
+            }
+            _runWriter->addRun(std::move(_data));
+            _data.clear();
+            _memUsed = 0;
+            return;
+        }
+
         sort();
 
         SortedFileWriter<Key, Value> writer(
@@ -584,8 +881,15 @@ private:
     std::streampos _nextSortedFileWriterOffset = 0;
     bool _done = false;
     size_t _memUsed;
+    size_t _spillThresholdBytes;
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+
+    // Sorts and spills runs in the background. Only used in parallel mode, created on first spill.
+    std::unique_ptr<ParallelRunWriter<Key, Value, Comparator>> _runWriter;
+
+    // Smaller in-memory sorts are not worth handing to other threads.
+    static constexpr size_t kMinParallelSortChunkSize = 16 * 1024;
 };
 
 template <typename Key, typename Value, typename Comparator>
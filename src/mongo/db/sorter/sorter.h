@@ -104,7 +104,16 @@ struct SortOptions {
     // extSortAllowed is true.
     std::string tempDir;
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    // The number of threads the Sorter may use to sort data. A value greater than 1 enables the
+    // parallel mode: an unlimited sort that spills hands each full run off to a background thread
+    // to be sorted and written to disk while the caller keeps adding data, and an in-memory sort
+    // is split into chunks that are sorted concurrently and then merged. The memory budget is
+    // divided evenly between the runs in flight. The comparator must be safe to call from several
+    // threads at once. Ignored by sorts with a limit.
+    size_t parallelism;
+
+    SortOptions()
+        : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false), parallelism(1) {}
 
     // Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -127,6 +136,11 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& Parallelism(size_t newParallelism) {
+        parallelism = newParallelism;
+        return *this;
+    }
 };
 
 /**
@@ -279,6 +293,7 @@ private:
     template class ::mongo::sorter::NoLimitSorter<Key, Value, Comparator>;               \
     template class ::mongo::sorter::LimitOneSorter<Key, Value, Comparator>;              \
     template class ::mongo::sorter::TopKSorter<Key, Value, Comparator>;                  \
+    template class ::mongo::sorter::ParallelRunWriter<Key, Value, Comparator>;           \
     template class ::mongo::sorter::MergeIterator<Key, Value, Comparator>;               \
     template class ::mongo::sorter::InMemIterator<Key, Value>;                           \
     template class ::mongo::sorter::FileIterator<Key, Value>;                            \
@@ -352,6 +352,25 @@ public:
             ASSERT_ITERATORS_EQUIVALENT(mergeIterators(iterators, DESC),
                                         make_shared<IntIterator>(30, 0, -1));
         }
+        {  // test a number of sources that is not a power of two, with sources running out early
+            std::shared_ptr<IWIterator> iterators[] = {
+                make_shared<IntIterator>(0, 100, 5)  // 0, 5, ... 95
+                ,
+                make_shared<EmptyIterator>(),
+                make_shared<IntIterator>(1, 100, 5)  // 1, 6, ... 96
+                ,
+                make_shared<IntIterator>(2, 100, 5)  // 2, 7, ... 97
+                ,
+                make_shared<IntIterator>(3, 100, 5)  // 3, 8, ... 98
+                ,
+                make_shared<IntIterator>(4, 100, 5)  // 4, 9, ... 99
+                ,
+                make_shared<IntIterator>(100, 103, 1)  // 100, 101, 102
+            };
+
+            ASSERT_ITERATORS_EQUIVALENT(mergeIterators(iterators, ASC),
+                                        make_shared<IntIterator>(0, 103, 1));
+        }
         {  // test Limit
             std::shared_ptr<IWIterator> iterators[] = {
                 make_shared<IntIterator>(1, 20, 2)  // 1, 3, ... 19
@@ -546,6 +565,22 @@ public:
 };
 
 
+template <bool Random = true>
+class LotsOfDataLittleMemoryParallel : public LotsOfDataLittleMemory<Random> {
+    typedef LotsOfDataLittleMemory<Random> Parent;
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return Parent::adjustSortOptions(opts).Parallelism(4);
+    }
+};
+
+// Everything fits in memory, so the in-memory sort is split across threads instead of spilling.
+template <bool Random = true>
+class LotsOfDataParallelInMemory : public LotsOfDataLittleMemory<Random> {
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return opts.Parallelism(4);
+    }
+};
+
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     typedef LotsOfDataLittleMemory<Random> Parent;
@@ -584,6 +619,10 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataLittleMemoryParallel</*random=*/false>>();
+        add<SorterTests::LotsOfDataLittleMemoryParallel</*random=*/true>>();
+        add<SorterTests::LotsOfDataParallelInMemory</*random=*/false>>();
+        add<SorterTests::LotsOfDataParallelInMemory</*random=*/true>>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
@@ -542,6 +542,16 @@ boost::optional<Record> RecordStore::Cursor::seekExact(const RecordId& id) {
     return Record{id, RecordData(it->second.c_str(), it->second.length())};
 }
 
+boost::optional<Record> RecordStore::Cursor::seekNear(const RecordId& start) {
+    StringStore* workingCopy(RecoveryUnit::get(opCtx)->getHead());
+    it = workingCopy->lower_bound(createKey(_ident, start.repr()));
+
+    // Have next() return the record we landed on rather than advance past it.
+    _needFirstSeek = false;
+    _lastMoveWasRestore = true;
+    return next();
+}
+
 // Positions are saved as we go.
 void RecordStore::Cursor::save() {}
 void RecordStore::Cursor::saveUnpositioned() {}
@@ -624,6 +634,17 @@ boost::optional<Record> RecordStore::ReverseCursor::seekExact(const RecordId& id
     return Record{id, RecordData(it->second.c_str(), it->second.length())};
 }
 
+boost::optional<Record> RecordStore::ReverseCursor::seekNear(const RecordId& start) {
+    StringStore* workingCopy(RecoveryUnit::get(opCtx)->getHead());
+    it = StringStore::const_reverse_iterator(
+        workingCopy->upper_bound(createKey(_ident, start.repr())));
+
+    // Have next() return the record we landed on rather than advance past it.
+    _needFirstSeek = false;
+    _lastMoveWasRestore = true;
+    return next();
+}
+
 void RecordStore::ReverseCursor::save() {}
 void RecordStore::ReverseCursor::saveUnpositioned() {}
 
@@ -201,6 +201,7 @@ private:
                VisibilityManager* visibilityManager);
         boost::optional<Record> next() final;
         boost::optional<Record> seekExact(const RecordId& id) final override;
+        boost::optional<Record> seekNear(const RecordId& start) final override;
         void save() final;
         void saveUnpositioned() final override;
         bool restore() final;
@@ -230,6 +231,7 @@ private:
                       VisibilityManager* visibilityManager);
         boost::optional<Record> next() final;
         boost::optional<Record> seekExact(const RecordId& id) final override;
+        boost::optional<Record> seekNear(const RecordId& start) final override;
         void save() final;
         void saveUnpositioned() final override;
         bool restore() final;
@@ -149,6 +149,15 @@ public:
         return {{_it->first, _it->second.toRecordData()}};
     }
 
+    boost::optional<Record> seekNear(const RecordId& start) final {
+        _lastMoveWasRestore = false;
+        _needFirstSeek = false;
+        _it = _records.lower_bound(start);
+        if (_it == _records.end())
+            return {};
+        return {{_it->first, _it->second.toRecordData()}};
+    }
+
     void save() final {
         if (!_needFirstSeek && !_lastMoveWasRestore)
             _savedId = _it == _records.end() ? RecordId() : _it->first;
@@ -222,6 +231,18 @@ public:
         return {{_it->first, _it->second.toRecordData()}};
     }
 
+    boost::optional<Record> seekNear(const RecordId& start) final {
+        _lastMoveWasRestore = false;
+        _needFirstSeek = false;
+
+        // The reverse_iterator points at the element preceding upper_bound(), which is the last
+        // record at or before 'start'.
+        _it = Records::const_reverse_iterator(_records.upper_bound(start));
+        if (_it == _records.rend())
+            return {};
+        return {{_it->first, _it->second.toRecordData()}};
+    }
+
     void save() final {
         if (!_needFirstSeek && !_lastMoveWasRestore)
             _savedId = _it == _records.rend() ? RecordId() : _it->first;
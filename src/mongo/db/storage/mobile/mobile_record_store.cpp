@@ -121,6 +121,19 @@ public:
         return rec;
     }
 
+    boost::optional<Record> seekNear(const RecordId& start) final {
+        // Restart the statement just before 'start', as seekExact() does, and take whatever record
+        // comes first.
+        int decr = (_forward ? -1 : 1);
+        _savedId = RecordId(start.repr() + decr);
+        _eof = false;
+
+        save();
+        restore();
+
+        return next();
+    }
+
     void save() final {
         // SQLite acquires implicit locks over the snapshot this cursor is using. It is important
         // to finalize the corresponding statement to release these locks.
@@ -29,7 +29,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/mutable/damage_vector.h"
@@ -143,6 +145,15 @@ public:
      */
     virtual boost::optional<Record> next() = 0;
 
+    /**
+     * Asks the cursor to keep up to 'depth' batches of 'batchSize' records beyond its position warm
+     * in the storage engine's cache, reading them in the background while the caller works through
+     * the current ones. Passing zero for either turns read-ahead off.
+     *
+     * This is a hint that never changes what the cursor returns.
+     */
+    virtual void setReadAhead(size_t batchSize, size_t depth) {}
+
     //
     // Saving and restoring state
     //
@@ -209,6 +220,13 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Seeks to the first Record at or after 'start' in the cursor's direction, which need not
+     * exist, and returns it. Returns boost::none if there is no such Record, after which the
+     * cursor is at EOF.
+     */
+    virtual boost::optional<Record> seekNear(const RecordId& start) = 0;
+
     /**
      * Prepares for state changes in underlying data without necessarily saving the current
      * state.
@@ -456,6 +474,40 @@ public:
         return {};
     }
 
+    /**
+     * Samples the RecordIds of this record store with a random cursor and returns up to
+     * 'numRanges' - 1 ascending RecordIds which split it into ranges holding roughly the same
+     * number of records. Used to divide a scan of the record store between several threads.
+     * Returns an empty vector if there is no random cursor support or the record store is empty.
+     */
+    std::vector<RecordId> sampleRangeBoundaries(OperationContext* opCtx, size_t numRanges) const {
+        const size_t kSamplesPerRange = 16;
+
+        auto cursor = getRandomCursor(opCtx);
+        if (!cursor) {
+            return {};
+        }
+
+        std::vector<RecordId> samples;
+        while (samples.size() < numRanges * kSamplesPerRange) {
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            samples.push_back(record->id);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        std::vector<RecordId> boundaries;
+        for (size_t i = 1; i < numRanges && !samples.empty(); ++i) {
+            const auto& boundary = samples[i * samples.size() / numRanges];
+            if (boundaries.empty() || boundaries.back() < boundary) {
+                boundaries.push_back(boundary);
+            }
+        }
+        return boundaries;
+    }
+
     // higher level
 
 
@@ -483,5 +483,58 @@ TEST(RecordStoreTestHarness, SeekExactForMissingRecordReturnsNone) {
     ASSERT_FALSE(recordStore->findRecord(opCtx.get(), recordIds[1], &outputData));
 }
 
+// seekNear() must land on the nearest record in the cursor's direction when the RecordId does not
+// exist, and continue iterating from there.
+TEST(RecordStoreTestHarness, SeekNearForMissingRecordReturnsNextRecord) {
+    const auto harnessHelper{newRecordStoreHarnessHelper()};
+    auto recordStore = harnessHelper->newNonCappedRecordStore();
+    ServiceContext::UniqueOperationContext opCtx{harnessHelper->newOperationContext()};
+
+    const int nToInsert = 3;
+    RecordId recordIds[nToInsert];
+    for (int i = 0; i < nToInsert; ++i) {
+        StringBuilder sb;
+        sb << "record " << i;
+        string data = sb.str();
+
+        WriteUnitOfWork uow{opCtx.get()};
+        auto res =
+            recordStore->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp{});
+        ASSERT_OK(res.getStatus());
+        recordIds[i] = res.getValue();
+        uow.commit();
+    }
+    std::sort(recordIds, recordIds + nToInsert);
+
+    {
+        WriteUnitOfWork uow{opCtx.get()};
+        recordStore->deleteRecord(opCtx.get(), recordIds[1]);
+        uow.commit();
+    }
+
+    auto forward = recordStore->getCursor(opCtx.get(), true);
+    auto record = forward->seekNear(recordIds[1]);
+    ASSERT(record);
+    ASSERT_EQ(recordIds[2], record->id);
+    ASSERT(!forward->next());
+
+    record = forward->seekNear(recordIds[0]);
+    ASSERT(record);
+    ASSERT_EQ(recordIds[0], record->id);
+    record = forward->next();
+    ASSERT(record);
+    ASSERT_EQ(recordIds[2], record->id);
+
+    ASSERT(!forward->seekNear(RecordId(recordIds[2].repr() + 1)));
+
+    auto reverse = recordStore->getCursor(opCtx.get(), false);
+    record = reverse->seekNear(recordIds[1]);
+    ASSERT(record);
+    ASSERT_EQ(recordIds[0], record->id);
+    ASSERT(!reverse->next());
+
+    ASSERT(!reverse->seekNear(RecordId(recordIds[0].repr() - 1)));
+}
+
 }  // namespace
 }  // namespace mongo
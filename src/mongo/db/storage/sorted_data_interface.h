@@ -35,6 +35,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/stdx/memory.h"
 
 #pragma once
 
@@ -43,6 +44,7 @@ namespace mongo {
 class BSONObjBuilder;
 class BucketDeletionNotification;
 class SortedDataBuilderInterface;
+class SortedDataInserter;
 struct ValidateResults;
 
 /**
@@ -100,6 +102,15 @@ public:
                                                      const RecordId& loc,
                                                      bool dupsAllowed) = 0;
 
+    /**
+     * Returns an object which inserts entries into the index like insert(), for callers inserting
+     * many entries at once. Storage engines may keep resources such as a cursor open between the
+     * insertions, which is most effective when the entries are inserted in index order.
+     *
+     * The returned object must not outlive the current WriteUnitOfWork.
+     */
+    virtual std::unique_ptr<SortedDataInserter> makeInserter(OperationContext* opCtx);
+
     /**
      * Remove the entry from the index with the specified key and RecordId.
      *
@@ -366,6 +377,40 @@ public:
     virtual Status initAsEmpty(OperationContext* opCtx) = 0;
 };
 
+/**
+ * Inserts entries into an index one at a time, on behalf of a single operation. See
+ * SortedDataInterface::makeInserter().
+ *
+ * The default implementation forwards every insertion to SortedDataInterface::insert().
+ */
+class SortedDataInserter {
+public:
+    SortedDataInserter(OperationContext* opCtx, SortedDataInterface* index)
+        : _opCtx(opCtx), _index(index) {}
+
+    virtual ~SortedDataInserter() {}
+
+    /**
+     * Behaves like SortedDataInterface::insert().
+     */
+    virtual StatusWith<SpecialFormatInserted> insert(const BSONObj& key,
+                                                     const RecordId& loc,
+                                                     bool dupsAllowed) {
+        return _index->insert(_opCtx, key, loc, dupsAllowed);
+    }
+
+protected:
+    OperationContext* const _opCtx;
+
+private:
+    SortedDataInterface* const _index;
+};
+
+inline std::unique_ptr<SortedDataInserter> SortedDataInterface::makeInserter(
+    OperationContext* opCtx) {
+    return stdx::make_unique<SortedDataInserter>(opCtx, this);
+}
+
 /**
  * A version-hiding wrapper around the bulk builder for the Btree.
  */
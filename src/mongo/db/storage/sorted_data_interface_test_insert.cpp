@@ -385,5 +385,37 @@ TEST(SortedDataInterface, InsertReservedRecordId) {
     ASSERT_EQUALS(1, sorted->numEntries(opCtx.get()));
 }
 
+// Insert several keys through one inserter and verify that they all end up in the index in order,
+// and that a duplicate is still rejected by a unique index.
+TEST(SortedDataInterface, InsertManyThroughInserter) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/true, /*partial=*/false));
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            auto inserter = sorted->makeInserter(opCtx.get());
+            ASSERT_OK(inserter->insert(key1, loc1, false));
+            ASSERT_OK(inserter->insert(key2, loc2, false));
+            ASSERT_OK(inserter->insert(key3, loc3, false));
+            ASSERT_EQUALS(ErrorCodes::DuplicateKey, inserter->insert(key2, loc4, false));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(3, sorted->numEntries(opCtx.get()));
+
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        ASSERT_EQ(cursor->seek(key1, true), IndexKeyEntry(key1, loc1));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key2, loc2));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key3, loc3));
+        ASSERT_EQ(cursor->next(), boost::none);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
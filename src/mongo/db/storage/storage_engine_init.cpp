@@ -51,14 +51,6 @@
 
 namespace mongo {
 
-namespace {
-/**
- * Creates the lock file used to prevent concurrent processes from accessing the data files,
- * as appropriate.
- */
-void createLockFile(ServiceContext* service);
-}  // namespace
-
 extern bool _supportsDocLocking;
 
 void initializeStorageEngine(ServiceContext* service, const StorageEngineInitFlags initFlags) {
@@ -214,10 +206,11 @@ void shutdownGlobalStorageEngineCleanly(ServiceContext* service) {
     }
 }
 
-namespace {
-
 void createLockFile(ServiceContext* service) {
     auto& lockFile = StorageEngineLockFile::get(service);
+    if (lockFile) {
+        return;
+    }
     try {
         lockFile.emplace(storageGlobalParams.dbpath);
     } catch (const std::exception& ex) {
@@ -247,6 +240,8 @@ void createLockFile(ServiceContext* service) {
     }
 }
 
+namespace {
+
 using FactoryMap = std::map<std::string, std::unique_ptr<StorageEngine::Factory>>;
 
 auto storageFactories = ServiceContext::declareDecoration<FactoryMap>();
@@ -51,6 +51,13 @@ enum StorageEngineInitFlags {
  */
 void initializeStorageEngine(ServiceContext* service, StorageEngineInitFlags initFlags);
 
+/**
+ * Creates and locks mongod.lock in the dbpath to keep other processes from using the data files,
+ * unless it is already held. initializeStorageEngine() calls this; startup code that writes to the
+ * dbpath before the storage engine starts calls it first.
+ */
+void createLockFile(ServiceContext* service);
+
 /**
  * Shuts down storage engine cleanly and releases any locks on mongod.lock.
  */
@@ -0,0 +1,196 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_group_commit.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+namespace {
+
+// The longest a flush may be held open for more durable-write waiters to join it. 0 disables the
+// window; concurrent waiters still share flushes.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerGroupCommitMaxWindowMicros, int, 500)
+    ->withValidator([](const int& value) {
+        return (value >= 0 && value <= 100 * 1000)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream()
+                         << "wiredTigerGroupCommitMaxWindowMicros must be between 0 and 100000. '"
+                         << value
+                         << "' is an invalid setting.");
+    });
+
+// Weight of the newest sample in the moving averages.
+const double kSampleWeight = 0.125;
+
+void updateAverage(double* average, double sample) {
+    *average = *average == 0 ? sample : *average + kSampleWeight * (sample - *average);
+}
+
+}  // namespace
+
+void WiredTigerGroupCommit::waitForFlush(const FlushFn& flush) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    const uint64_t now = curTimeMicros64();
+    if (_lastArrivalMicros != 0 && now >= _lastArrivalMicros) {
+        updateAverage(&_avgInterarrivalMicros, static_cast<double>(now - _lastArrivalMicros));
+    }
+    _lastArrivalMicros = now;
+    ++_callers;
+
+    Waiter self(_flushesStarted + 1);
+    _waiters.push_back(&self);
+    if (_windowLeader && _waiters.size() >= _windowTarget) {
+        _windowLeader->cv.notify_one();
+    }
+
+    while (!self.done) {
+        if (_flushing) {
+            self.cv.wait(lk);
+            continue;
+        }
+        _leadFlush(lk, &self, flush);
+    }
+}
+
+void WiredTigerGroupCommit::_leadFlush(stdx::unique_lock<stdx::mutex>& lk,
+                                       Waiter* leader,
+                                       const FlushFn& flush) {
+    _flushing = true;
+
+    const auto window = _computeWindow_inlock();
+    if (window.first > Microseconds(0)) {
+        ++_flushesHeldOpen;
+        _windowLeader = leader;
+        _windowTarget = window.second;
+        leader->cv.wait_for(lk, window.first.toSystemDuration(), [&] {
+            return _waiters.size() >= _windowTarget;
+        });
+        _windowLeader = nullptr;
+    }
+
+    // Everyone queued so far arrived before this flush starts, so it covers them.
+    const uint64_t flushNumber = ++_flushesStarted;
+    lk.unlock();
+    const uint64_t start = curTimeMicros64();
+    try {
+        flush();
+    } catch (...) {
+        // The leader leaves with the error; the remaining waiters elect another leader to retry.
+        lk.lock();
+        _flushing = false;
+        _waiters.erase(std::find(_waiters.begin(), _waiters.end(), leader));
+        if (!_waiters.empty()) {
+            _waiters.front()->cv.notify_one();
+        }
+        throw;
+    }
+    const uint64_t elapsed = curTimeMicros64() - start;
+    lk.lock();
+
+    _flushing = false;
+    updateAverage(&_avgFlushMicros, static_cast<double>(elapsed));
+    _flushLatencyMicros.increment(elapsed);
+
+    size_t covered = 0;
+    while (!_waiters.empty() && _waiters.front()->flushNumber <= flushNumber) {
+        auto waiter = _waiters.front();
+        _waiters.pop_front();
+        waiter->done = true;
+        waiter->cv.notify_one();
+        ++covered;
+    }
+    _waitersPerFlush.increment(covered);
+
+    // Callers that arrived during the flush need another one; hand it to the first of them.
+    if (!_waiters.empty()) {
+        _waiters.front()->cv.notify_one();
+    }
+}
+
+std::pair<Microseconds, size_t> WiredTigerGroupCommit::_computeWindow_inlock() const {
+    const int maxWindowMicros = wiredTigerGroupCommitMaxWindowMicros.load();
+    // Unless other callers usually arrive while a flush runs, waiting for them only adds latency.
+    if (maxWindowMicros <= 0 || _avgInterarrivalMicros <= 0 ||
+        _avgFlushMicros < _avgInterarrivalMicros) {
+        return {Microseconds(0), 0};
+    }
+
+    const double windowMicros = std::min<double>(maxWindowMicros, _avgFlushMicros / 2);
+    const size_t expectedArrivals = static_cast<size_t>(windowMicros / _avgInterarrivalMicros);
+    if (expectedArrivals == 0) {
+        return {Microseconds(0), 0};
+    }
+    return {Microseconds(static_cast<long long>(windowMicros)), _waiters.size() + expectedArrivals};
+}
+
+void WiredTigerGroupCommit::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->append("flushes", static_cast<long long>(_flushesStarted));
+    builder->append("callers", static_cast<long long>(_callers));
+    builder->append("flushesHeldOpen", static_cast<long long>(_flushesHeldOpen));
+    _waitersPerFlush.append("waitersPerFlush", "waiters", builder);
+    _flushLatencyMicros.append("flushLatency", "micros", builder);
+}
+
+void WiredTigerGroupCommit::Histogram::increment(uint64_t value) {
+    const int bucket = value == 0 ? 0 : 64 - countLeadingZeros64(value);
+    ++_buckets[std::min(bucket, kBuckets - 1)];
+    _sum += value;
+    ++_entries;
+}
+
+void WiredTigerGroupCommit::Histogram::append(StringData name,
+                                              StringData boundName,
+                                              BSONObjBuilder* builder) const {
+    BSONObjBuilder histogramBuilder(builder->subobjStart(name));
+    BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
+    for (int i = 0; i < kBuckets; i++) {
+        if (_buckets[i] == 0)
+            continue;
+        BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+        entryBuilder.append(boundName, static_cast<long long>(i == 0 ? 0 : 1ULL << (i - 1)));
+        entryBuilder.append("count", static_cast<long long>(_buckets[i]));
+        entryBuilder.doneFast();
+    }
+    arrayBuilder.doneFast();
+    histogramBuilder.append("total", static_cast<long long>(_sum));
+    histogramBuilder.append("entries", static_cast<long long>(_entries));
+    histogramBuilder.doneFast();
+}
+
+}  // namespace mongo
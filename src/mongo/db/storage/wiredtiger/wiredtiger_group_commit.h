@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Coalesces callers waiting for their writes to become durable into shared flushes.
+ *
+ * A caller of waitForFlush() is satisfied by any flush that starts after it arrives. Callers that
+ * arrive while a flush is running queue up, and once it completes one of them leads a single flush
+ * on behalf of all of them. A leader may hold its flush open for a short window so that more
+ * callers can join it. The window adapts to the observed flush latency and arrival rate: it is
+ * only used when other callers usually arrive during a flush, is at most half the average flush
+ * latency and never exceeds wiredTigerGroupCommitMaxWindowMicros, and ends early once the
+ * expected number of callers has joined. Each caller is woken individually when the flush
+ * covering it completes.
+ */
+class WiredTigerGroupCommit {
+    MONGO_DISALLOW_COPYING(WiredTigerGroupCommit);
+
+public:
+    using FlushFn = stdx::function<void()>;
+
+    WiredTigerGroupCommit() = default;
+
+    /**
+     * Returns once a call to 'flush' that started after this call began has completed. 'flush'
+     * runs on the calling thread if the caller leads the flush, and never concurrently with
+     * another 'flush' passed to this object.
+     */
+    void waitForFlush(const FlushFn& flush);
+
+    /**
+     * Appends the number of flushes and callers, and histograms of the callers covered by each
+     * flush and of flush latency.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct Waiter {
+        explicit Waiter(uint64_t flushNumber) : flushNumber(flushNumber) {}
+
+        // The first flush that starts after this caller arrived, which is the one that covers it.
+        const uint64_t flushNumber;
+        bool done = false;
+        stdx::condition_variable cv;
+    };
+
+    /**
+     * Counts values in buckets whose lower bounds are 0 and the powers of two.
+     */
+    class Histogram {
+    public:
+        void increment(uint64_t value);
+        void append(StringData name, StringData boundName, BSONObjBuilder* builder) const;
+
+    private:
+        static constexpr int kBuckets = 32;
+        std::array<uint64_t, kBuckets> _buckets{};
+        uint64_t _sum = 0;
+        uint64_t _entries = 0;
+    };
+
+    /**
+     * Runs 'flush' on behalf of every queued waiter, after holding it open for the adaptive
+     * window, and wakes the waiters it covered.
+     */
+    void _leadFlush(stdx::unique_lock<stdx::mutex>& lk, Waiter* leader, const FlushFn& flush);
+
+    /**
+     * Returns how long a leader should hold its flush open, and the number of queued waiters
+     * after which it should stop waiting.
+     */
+    std::pair<Microseconds, size_t> _computeWindow_inlock() const;
+
+    mutable stdx::mutex _mutex;
+
+    // Callers waiting for a flush, in arrival order, so their flush numbers never decrease.
+    std::deque<Waiter*> _waiters;
+    bool _flushing = false;
+    uint64_t _flushesStarted = 0;
+
+    // While a leader holds its flush open, arrivals wake it once the queue reaches the target.
+    Waiter* _windowLeader = nullptr;
+    size_t _windowTarget = 0;
+
+    // Exponentially weighted moving averages, in microseconds, used to size the window.
+    double _avgFlushMicros = 0;
+    double _avgInterarrivalMicros = 0;
+    uint64_t _lastArrivalMicros = 0;
+
+    uint64_t _callers = 0;
+    uint64_t _flushesHeldOpen = 0;
+    Histogram _waitersPerFlush;
+    Histogram _flushLatencyMicros;
+};
+
+}  // namespace mongo
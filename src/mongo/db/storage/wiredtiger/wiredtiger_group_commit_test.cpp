@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_group_commit.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+TEST(WiredTigerGroupCommitTest, SingleCallerRunsItsOwnFlush) {
+    WiredTigerGroupCommit groupCommit;
+    int flushes = 0;
+    groupCommit.waitForFlush([&] { ++flushes; });
+    groupCommit.waitForFlush([&] { ++flushes; });
+    ASSERT_EQ(2, flushes);
+
+    BSONObjBuilder builder;
+    groupCommit.appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(2, stats["flushes"].numberLong());
+    ASSERT_EQ(2, stats["callers"].numberLong());
+    ASSERT_EQ(2, stats["waitersPerFlush"]["entries"].numberLong());
+}
+
+TEST(WiredTigerGroupCommitTest, ConcurrentCallersShareFlushes) {
+    const int kThreads = 16;
+    const int kCallsPerThread = 50;
+    WiredTigerGroupCommit groupCommit;
+
+    AtomicWord<int> flushesStarted{0};
+    AtomicWord<int> flushesCompleted{0};
+    AtomicWord<bool> flushRunning{false};
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kCallsPerThread; i++) {
+                const int startedBeforeCall = flushesStarted.load();
+                groupCommit.waitForFlush([&] {
+                    ASSERT_FALSE(flushRunning.swap(true));
+                    flushesStarted.fetchAndAdd(1);
+                    sleepmicros(200);
+                    flushesCompleted.fetchAndAdd(1);
+                    flushRunning.store(false);
+                });
+                // Flushes run one at a time, so a flush that started after this call began must
+                // have completed.
+                ASSERT_GT(flushesCompleted.load(), startedBeforeCall);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    BSONObjBuilder builder;
+    groupCommit.appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(kThreads * kCallsPerThread, stats["callers"].numberLong());
+    ASSERT_EQ(flushesStarted.load(), stats["flushes"].numberLong());
+    ASSERT_LT(flushesStarted.load(), kThreads * kCallsPerThread);
+}
+
+TEST(WiredTigerGroupCommitTest, FlushCoversOnlyCallersThatArrivedBeforeItStarted) {
+    WiredTigerGroupCommit groupCommit;
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    bool firstFlushStarted = false;
+    bool releaseFirstFlush = false;
+    int flushes = 0;
+
+    stdx::thread leader([&] {
+        groupCommit.waitForFlush([&] {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            ++flushes;
+            firstFlushStarted = true;
+            cv.notify_all();
+            cv.wait(lk, [&] { return releaseFirstFlush; });
+        });
+    });
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return firstFlushStarted; });
+    }
+
+    // This caller arrives while the first flush runs, so it must wait for a second one.
+    int flushesSeen = 0;
+    stdx::thread follower([&] {
+        groupCommit.waitForFlush([&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ++flushes;
+        });
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        flushesSeen = flushes;
+    });
+
+    sleepmillis(50);
+    {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        releaseFirstFlush = true;
+        cv.notify_all();
+    }
+    leader.join();
+    follower.join();
+    ASSERT_EQ(2, flushesSeen);
+}
+
+TEST(WiredTigerGroupCommitTest, FailedFlushIsRetriedByAnotherWaiter) {
+    WiredTigerGroupCommit groupCommit;
+    ASSERT_THROWS_CODE(
+        groupCommit.waitForFlush([] { uasserted(ErrorCodes::InternalError, "flush failed"); }),
+        AssertionException,
+        ErrorCodes::InternalError);
+
+    int flushes = 0;
+    groupCommit.waitForFlush([&] { ++flushes; });
+    ASSERT_EQ(1, flushes);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -96,6 +96,8 @@ public:
                                                      const RecordId& id,
                                                      bool dupsAllowed);
 
+    std::unique_ptr<SortedDataInserter> makeInserter(OperationContext* opCtx) override;
+
     virtual void unindex(OperationContext* opCtx,
                          const BSONObj& key,
                          const RecordId& id,
@@ -176,6 +178,7 @@ protected:
     class BulkBuilder;
     class StandardBulkBuilder;
     class UniqueBulkBuilder;
+    class Inserter;
 
     const Ordering _ordering;
     // The keystring and data format version are effectively const after the WiredTigerIndex
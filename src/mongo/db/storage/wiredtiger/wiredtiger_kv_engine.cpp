@@ -76,6 +76,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_prefetcher.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -652,6 +653,10 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sessionSweeper = stdx::make_unique<WiredTigerSessionSweeper>(_sessionCache.get());
     _sessionSweeper->go();
 
+    if (!_ephemeral) {
+        _prefetcher = stdx::make_unique<WiredTigerPrefetcher>(_sessionCache.get());
+    }
+
     if (_durable && !_ephemeral) {
         _journalFlusher = stdx::make_unique<WiredTigerJournalFlusher>(_sessionCache.get());
         _journalFlusher->go();
@@ -712,6 +717,14 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     bb.done();
 }
 
+void WiredTigerKVEngine::appendGroupCommitStats(BSONObjBuilder* builder) const {
+    _sessionCache->getGroupCommit().appendStats(builder);
+}
+
+void WiredTigerKVEngine::appendCursorCacheStats(BSONObjBuilder* builder) const {
+    _sessionCache->appendCursorCacheStats(builder);
+}
+
 void WiredTigerKVEngine::_openWiredTiger(const std::string& path, const std::string& wtOpenConfig) {
     std::string configStr = wtOpenConfig + ",compatibility=(require_min=\"3.1.0\")";
 
@@ -798,6 +811,11 @@ void WiredTigerKVEngine::cleanShutdown() {
         _checkpointThread->shutdown();
         log() << "Finished shutting down checkpoint thread";
     }
+    if (_prefetcher) {
+        log() << "Shutting down prefetcher";
+        _prefetcher->shutdown();
+        log() << "Finished shutting down prefetcher";
+    }
     LOG_FOR_RECOVERY(2) << "Shutdown timestamps. StableTimestamp: " << _stableTimestamp.load()
                         << " Initial data timestamp: " << _initialDataTimestamp.load();
 
@@ -1323,6 +1341,8 @@ Status WiredTigerKVEngine::dropIdent(OperationContext* opCtx, StringData ident)
     WiredTigerRecoveryUnit* ru = WiredTigerRecoveryUnit::get(opCtx);
     ru->getSessionNoTxn()->closeAllCursors(uri);
     _sessionCache->closeAllCursors(uri);
+    ru->getSessionNoTxn()->dropCursorCacheStats(uri);
+    _sessionCache->dropCursorCacheStats(uri);
 
     WiredTigerSession session(_conn);
 
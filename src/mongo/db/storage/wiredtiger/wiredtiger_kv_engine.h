@@ -50,6 +50,7 @@ namespace mongo {
 
 class ClockSource;
 class JournalListener;
+class WiredTigerPrefetcher;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
@@ -289,6 +290,14 @@ public:
         return _oplogManager.get();
     }
 
+    /**
+     * Returns the prefetcher that warms the cache for scans that asked for read-ahead, or null if
+     * the engine keeps all data in memory.
+     */
+    WiredTigerPrefetcher* getPrefetcher() const {
+        return _prefetcher.get();
+    }
+
     /**
      * Sets the implementation for `initRsOplogBackgroundThread` (allowing tests to skip the
      * background job, for example). Intended to be called from a MONGO_INITIALIZER and therefore in
@@ -306,6 +315,17 @@ public:
 
     static void appendGlobalStats(BSONObjBuilder& b);
 
+    /**
+     * Appends the statistics of the group commit shared by callers waiting for durability.
+     */
+    void appendGroupCommitStats(BSONObjBuilder* builder) const;
+
+    /**
+     * Appends the cursor cache hits and misses of sessions, in total and for the tables with the
+     * most misses.
+     */
+    void appendCursorCacheStats(BSONObjBuilder* builder) const;
+
     Timestamp getStableTimestamp() const override;
     Timestamp getOldestTimestamp() const override;
     Timestamp getCheckpointTimestamp() const override;
@@ -439,6 +459,7 @@ private:
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerPrefetcher> _prefetcher;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_prefetcher.h"
+
+#include <wiredtiger.h>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+ThreadPool::Options makePoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "WTPrefetcher";
+    options.minThreads = 0;
+    options.maxThreads = 4;
+    return options;
+}
+
+}  // namespace
+
+WiredTigerPrefetcher::WiredTigerPrefetcher(WiredTigerSessionCache* sessionCache)
+    : _sessionCache(sessionCache), _pool(makePoolOptions()) {
+    _pool.startup();
+}
+
+WiredTigerPrefetcher::~WiredTigerPrefetcher() {
+    shutdown();
+}
+
+bool WiredTigerPrefetcher::schedule(Request request) {
+    invariant(request.state);
+    if (_shuttingDown.load() || request.numRecords <= 0) {
+        return false;
+    }
+    if (_numPending.fetchAndAdd(1) >= kMaxPendingRequests) {
+        _numPending.subtractAndFetch(1);
+        return false;
+    }
+
+    auto state = request.state;
+    state->inFlight.store(true);
+    Status status = _pool.schedule([ this, request = std::move(request) ] {
+        ON_BLOCK_EXIT([&] {
+            request.state->inFlight.store(false);
+            _numPending.subtractAndFetch(1);
+        });
+        if (!_shuttingDown.load()) {
+            _warm(request);
+        }
+    });
+    if (!status.isOK()) {
+        state->inFlight.store(false);
+        _numPending.subtractAndFetch(1);
+        return false;
+    }
+    return true;
+}
+
+void WiredTigerPrefetcher::shutdown() {
+    if (_shuttingDown.swap(true)) {
+        return;
+    }
+    _pool.shutdown();
+    _pool.join();
+}
+
+void WiredTigerPrefetcher::waitForIdle() {
+    _pool.waitForIdle();
+}
+
+void WiredTigerPrefetcher::_warm(const Request& request) {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    WT_SESSION* s = session->getSession();
+
+    // Use a fresh cursor rather than one from the session's cache: the collection may have been
+    // dropped since the request was made, in which case there is nothing to warm.
+    WT_CURSOR* c;
+    if (s->open_cursor(s, request.uri.c_str(), nullptr, nullptr, &c) != 0) {
+        return;
+    }
+    ON_BLOCK_EXIT([c] { c->close(c); });
+
+    const bool prefixed = request.prefix.isPrefixed();
+    if (prefixed) {
+        c->set_key(c, request.prefix.repr(), request.start.repr());
+    } else {
+        c->set_key(c, request.start.repr());
+    }
+
+    int cmp;
+    int ret = c->search_near(c, &cmp);
+    auto advance = [&] { ret = request.forward ? c->next(c) : c->prev(c); };
+
+    // Land on the first record at or past 'start' in scan order.
+    if (ret == 0 && (request.forward ? cmp < 0 : cmp > 0)) {
+        advance();
+    }
+
+    long long numWarmed = 0;
+    bool first = true;
+    while (ret == 0 && numWarmed < request.numRecords) {
+        std::int64_t prefix = 0;
+        std::int64_t id;
+        if (prefixed) {
+            ret = c->get_key(c, &prefix, &id);
+        } else {
+            ret = c->get_key(c, &id);
+        }
+        if (ret != 0 || prefix != (prefixed ? request.prefix.repr() : 0)) {
+            break;
+        }
+
+        const bool skip = first && !request.inclusive && RecordId(id) == request.start;
+        first = false;
+        if (!skip) {
+            // Reading the value is what brings it, and any overflow pages, into the cache.
+            WT_ITEM value;
+            ret = c->get_value(c, &value);
+            if (ret != 0) {
+                break;
+            }
+            ++numWarmed;
+            request.state->horizon.store(id);
+            request.state->numWarmed.fetchAndAdd(1);
+        }
+        advance();
+    }
+
+    // Prepare conflicts, cache pressure and the like simply end the warming early.
+    if (ret != 0 && ret != WT_NOTFOUND) {
+        LOG(3) << "Stopped prefetching " << request.uri << " after " << numWarmed
+               << " records: " << wiredtiger_strerror(ret);
+    }
+}
+
+}  // namespace mongo
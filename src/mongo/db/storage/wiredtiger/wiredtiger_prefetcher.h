@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+class WiredTigerSessionCache;
+
+/**
+ * Warms the WiredTiger cache ahead of forward or backward record store scans. A scan that asked for
+ * read-ahead hands the prefetcher the range it is about to read, and a background thread reads that
+ * range through its own session so that the pages are in cache by the time the scan gets there.
+ *
+ * The prefetcher never hands records back to the scan: the scan still reads every record itself,
+ * from its own snapshot, so read-ahead changes neither the results nor the yielding rules of a
+ * query. Requests are best effort and are dropped when too many are already queued.
+ */
+class WiredTigerPrefetcher {
+    MONGO_DISALLOW_COPYING(WiredTigerPrefetcher);
+
+public:
+    /**
+     * Progress of the read-ahead for one cursor, shared between the cursor and the requests it
+     * schedules so that a request may outlive the cursor that made it.
+     */
+    struct ReadAheadState {
+        // The last record warmed so far, or null if nothing has been warmed yet.
+        AtomicWord<long long> horizon{0};
+
+        // How many records have been warmed since the cursor last reset this state.
+        AtomicWord<long long> numWarmed{0};
+
+        // Whether a request for this cursor is queued or running.
+        AtomicWord<bool> inFlight{false};
+    };
+
+    struct Request {
+        std::string uri;
+        KVPrefix prefix = KVPrefix::kNotPrefixed;
+        bool forward = true;
+
+        // Warming starts with the first record after 'start' in scan order, or with the record at
+        // 'start' if 'inclusive' is set.
+        RecordId start;
+        bool inclusive = false;
+
+        long long numRecords = 0;
+        std::shared_ptr<ReadAheadState> state;
+    };
+
+    explicit WiredTigerPrefetcher(WiredTigerSessionCache* sessionCache);
+    ~WiredTigerPrefetcher();
+
+    /**
+     * Queues 'request' and returns true, or returns false without queueing it if the prefetcher is
+     * busy or shut down. The request's state is marked in flight until it completes.
+     */
+    bool schedule(Request request);
+
+    /**
+     * Stops accepting requests and waits for the running ones to finish. Must be called before the
+     * session cache shuts down.
+     */
+    void shutdown();
+
+    /**
+     * Blocks until every queued request has completed. For tests.
+     */
+    void waitForIdle();
+
+private:
+    void _warm(const Request& request);
+
+    // The most requests that may be queued or running at once, across all cursors.
+    static constexpr int kMaxPendingRequests = 64;
+
+    WiredTigerSessionCache* const _sessionCache;
+
+    AtomicWord<bool> _shuttingDown{false};
+    AtomicWord<int> _numPending{0};
+
+    ThreadPool _pool;
+};
+
+}  // namespace mongo
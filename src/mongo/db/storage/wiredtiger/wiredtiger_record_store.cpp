@@ -1914,6 +1914,9 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     invariantWTOK(c->get_value(c, &value));
 
     _lastReturnedId = id;
+    if (_readAheadState) {
+        readAhead(id);
+    }
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
@@ -1940,9 +1943,90 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
 
     _lastReturnedId = id;
     _eof = false;
+    if (_readAheadState) {
+        // Whatever was warmed belongs to the old position, so start over from here.
+        _readAheadState = std::make_shared<WiredTigerPrefetcher::ReadAheadState>();
+        _numReturnedSinceReadAheadReset = 0;
+    }
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+boost::optional<Record> WiredTigerRecordStoreCursorBase::seekNear(const RecordId& start) {
+    _skipNextAdvance = false;
+    _eof = false;
+    WT_CURSOR* c = _cursor->get();
+    setKey(c, start);
+    int cmp;
+    // Nothing after the next line can throw WCEs.
+    int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search_near(c, &cmp); });
+    if (ret == WT_NOTFOUND) {
+        _eof = true;
+        return {};
+    }
+    invariantWTOK(ret);
+
+    // search_near() lands on either side of 'start'. If it landed on the side we are scanning
+    // towards, next() must return that record instead of advancing past it.
+    RecordId id;
+    _skipNextAdvance = _forward ? cmp >= 0 : cmp <= 0;
+    if (_skipNextAdvance && hasWrongPrefix(c, &id)) {
+        _skipNextAdvance = false;
+        _eof = true;
+        return {};
+    }
+
+    _lastReturnedId = RecordId();
+    if (_readAheadState) {
+        _readAheadState = std::make_shared<WiredTigerPrefetcher::ReadAheadState>();
+        _numReturnedSinceReadAheadReset = 0;
+    }
+    return next();
+}
+
+void WiredTigerRecordStoreCursorBase::setReadAhead(size_t batchSize, size_t depth) {
+    if (batchSize == 0 || depth == 0 || !_rs._kvEngine || !_rs._kvEngine->getPrefetcher()) {
+        _readAheadState.reset();
+        return;
+    }
+
+    _readAheadBatchSize = batchSize;
+    _readAheadDepth = depth;
+    _numReturnedSinceReadAheadReset = 0;
+    _readAheadState = std::make_shared<WiredTigerPrefetcher::ReadAheadState>();
+}
+
+void WiredTigerRecordStoreCursorBase::readAhead(const RecordId& id) {
+    // Only look at the prefetcher's progress once per batch, and never while it is still working
+    // for us, so that 'horizon' and 'numWarmed' are stable.
+    if (_numReturnedSinceReadAheadReset++ % _readAheadBatchSize != 0 ||
+        _readAheadState->inFlight.load()) {
+        return;
+    }
+
+    const long long target = _readAheadBatchSize * _readAheadDepth;
+    const long long ahead = _readAheadState->numWarmed.load() - _numReturnedSinceReadAheadReset;
+    if (ahead > target - _readAheadBatchSize) {
+        return;
+    }
+
+    WiredTigerPrefetcher::Request request;
+    request.uri = _rs.getURI();
+    request.prefix = getKeyPrefix();
+    request.forward = _forward;
+    request.state = _readAheadState;
+    if (ahead > 0) {
+        // Carry on from the last record warmed.
+        request.start = RecordId(_readAheadState->horizon.load());
+        request.numRecords = target - ahead;
+    } else {
+        // The scan caught up with the prefetcher, or this is the first batch.
+        _readAheadState->numWarmed.store(_numReturnedSinceReadAheadReset);
+        _readAheadState->horizon.store(id.repr());
+        request.start = id;
+        request.numRecords = target;
+    }
+    _rs._kvEngine->getPrefetcher()->schedule(std::move(request));
+}
 
 void WiredTigerRecordStoreCursorBase::save() {
     try {
@@ -40,6 +40,7 @@
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_prefetcher.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/platform/atomic_word.h"
@@ -421,6 +422,10 @@ public:
 
     boost::optional<Record> seekExact(const RecordId& id);
 
+    boost::optional<Record> seekNear(const RecordId& start);
+
+    void setReadAhead(size_t batchSize, size_t depth);
+
     void save();
 
     void saveUnpositioned();
@@ -450,6 +455,13 @@ protected:
      */
     virtual void initCursorToBeginning() = 0;
 
+    /**
+     * Returns the prefix of this cursor's keys, if the table is shared with other collections.
+     */
+    virtual KVPrefix getKeyPrefix() const {
+        return KVPrefix::kNotPrefixed;
+    }
+
     const WiredTigerRecordStore& _rs;
     OperationContext* _opCtx;
     const bool _forward;
@@ -461,6 +473,19 @@ protected:
 private:
     bool isVisible(const RecordId& id);
 
+    /**
+     * Called after returning record 'id' while read-ahead is on. Asks the prefetcher for more
+     * records once fewer than 'depth - 1' batches beyond the position are known to be warm.
+     */
+    void readAhead(const RecordId& id);
+
+    // Read-ahead settings from setReadAhead(), and how far this cursor has got since the
+    // prefetcher's progress was last reset. '_readAheadState' is null while read-ahead is off.
+    long long _readAheadBatchSize = 0;
+    long long _readAheadDepth = 0;
+    long long _numReturnedSinceReadAheadReset = 0;
+    std::shared_ptr<WiredTigerPrefetcher::ReadAheadState> _readAheadState;
+
     /**
      * This value is used for visibility calculations on what oplog entries can be returned to a
      * client. This value *must* be initialized/updated *before* a WiredTiger snapshot is
@@ -515,6 +540,10 @@ protected:
 
     virtual void initCursorToBeginning() override;
 
+    KVPrefix getKeyPrefix() const override {
+        return _prefix;
+    }
+
 private:
     KVPrefix _prefix;
 };
@@ -29,10 +29,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <time.h>
+#include <vector>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
@@ -403,6 +405,53 @@ TEST(WiredTigerRecordStoreTest, CappedCursorYieldFirst) {
     ASSERT(!cursor->next());
 }
 
+TEST(WiredTigerRecordStoreTest, CursorReadAheadReturnsEveryRecord) {
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int numRecords = 100;
+    std::vector<RecordId> ids;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < numRecords; ++i) {
+            const BSONObj doc = BSON("_id" << i);
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), doc.objdata(), doc.objsize(), Timestamp());
+            ASSERT_OK(res.getStatus());
+            ids.push_back(res.getValue());
+        }
+        uow.commit();
+    }
+
+    for (bool forward : {true, false}) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get(), forward);
+        cursor->setReadAhead(4, 3);
+
+        std::vector<RecordId> seen;
+        while (auto record = cursor->next()) {
+            seen.push_back(record->id);
+
+            // Yielding and seeking must not disturb the scan.
+            if (seen.size() == 10) {
+                cursor->save();
+                opCtx->recoveryUnit()->abandonSnapshot();
+                ASSERT_TRUE(cursor->restore());
+            }
+            if (seen.size() == 50) {
+                ASSERT(cursor->seekExact(record->id));
+            }
+        }
+
+        std::vector<RecordId> expected = ids;
+        if (!forward) {
+            std::reverse(expected.begin(), expected.end());
+        }
+        ASSERT(seen == expected);
+    }
+}
+
 BSONObj makeBSONObjWithSize(const Timestamp& opTime, int size, char fill = 'x') {
     BSONObj objTemplate = BSON("ts" << opTime << "str"
                                     << "");
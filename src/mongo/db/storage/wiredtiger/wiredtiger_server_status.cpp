@@ -76,6 +76,16 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    {
+        BSONObjBuilder groupCommitBuilder(bob.subobjStart("groupCommit"));
+        _engine->appendGroupCommitStats(&groupCommitBuilder);
+    }
+
+    {
+        BSONObjBuilder cursorCacheBuilder(bob.subobjStart("cursorCache"));
+        _engine->appendCursorCacheStats(&cursorCacheBuilder);
+    }
+
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
     return bob.obj();
@@ -33,7 +33,10 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -44,6 +47,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -73,6 +77,15 @@ namespace mongo {
 // will be cached in WiredTiger. Exclusive operations should only be blocked
 // for a short time, except if a cursor is held by a long running session. This
 // is a good compromise for most workloads.
+//
+// "wiredTigerCursorCacheEvictionPolicy" picks which cursors above the storage
+// engine are closed. "generation", the default, closes those not used within
+// the last |wiredTigerCursorCacheSize| cursor releases. "lru" instead keeps up
+// to |wiredTigerCursorCacheSize| cursors open per session, however long ago
+// they were used.
+//
+// With hybrid caching, "wiredTigerCursorCacheResidentCursors" is the number of
+// most recently used cursors a released session keeps open rather than closing.
 AtomicWord<int> kWiredTigerCursorCacheSize(-100);
 
 const std::string kWTRepairMsg =
@@ -84,9 +97,100 @@ ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
                                      "wiredTigerCursorCacheSize",
                                      &kWiredTigerCursorCacheSize);
 
+namespace {
+
+// The number of pools idle sessions are spread across. 0 uses one per core, up to 64.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerSessionCacheShards, int, 0)
+    ->withValidator([](const int& value) {
+        return (value >= 0 && value <= 1024)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream() << "wiredTigerSessionCacheShards must be between 0 and 1024. '"
+                                   << value
+                                   << "' is an invalid setting.");
+    });
+
+const char kGenerationEvictionPolicy[] = "generation";
+const char kLRUEvictionPolicy[] = "lru";
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerCursorCacheEvictionPolicy,
+                                      std::string,
+                                      kGenerationEvictionPolicy)
+    ->withValidator([](const std::string& value) {
+        return (value == kGenerationEvictionPolicy || value == kLRUEvictionPolicy)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream() << "wiredTigerCursorCacheEvictionPolicy must be '"
+                                   << kGenerationEvictionPolicy
+                                   << "' or '"
+                                   << kLRUEvictionPolicy
+                                   << "'. '"
+                                   << value
+                                   << "' is an invalid setting.");
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerCursorCacheResidentCursors, int, 0)
+    ->withValidator([](const int& value) {
+        return (value >= 0 && value <= 10000)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream()
+                         << "wiredTigerCursorCacheResidentCursors must be between 0 and 10000. '"
+                         << value
+                         << "' is an invalid setting.");
+    });
+
+// Tables beyond these many, across idle and closed sessions, only count towards the total cursor
+// cache hits and misses.
+const size_t kMaxCursorCacheStatsTables = 10000;
+
+// The number of tables, with the most misses, reported by serverStatus.
+const size_t kReportedCursorCacheStatsTables = 20;
+
+bool useLRUCursorEviction() {
+    static const bool useLRU = wiredTigerCursorCacheEvictionPolicy == kLRUEvictionPolicy;
+    return useLRU;
+}
+
+size_t numSessionCacheShards(size_t requested) {
+    if (requested == 0) {
+        requested = wiredTigerSessionCacheShards;
+    }
+    if (requested == 0) {
+        requested = std::min<size_t>(std::max(ProcessInfo::getNumAvailableCores(), 1ul), 64);
+    }
+    return requested;
+}
+
+}  // namespace
+
+void WiredTigerCursorCacheStats::addTable(const std::string& uri,
+                                          const WiredTigerCursorCacheCounts& counts,
+                                          size_t maxTables) {
+    auto it = byUri.find(uri);
+    if (it == byUri.end()) {
+        if (byUri.size() >= maxTables) {
+            return;
+        }
+        it = byUri.emplace(uri, WiredTigerCursorCacheCounts()).first;
+    }
+    it->second.hits += counts.hits;
+    it->second.misses += counts.misses;
+}
+
+void WiredTigerCursorCacheStats::merge(const WiredTigerCursorCacheStats& other,
+                                       size_t maxTables) {
+    total.hits += other.total.hits;
+    total.misses += other.total.misses;
+    for (auto&& entry : other.byUri) {
+        addTable(entry.first, entry.second, maxTables);
+    }
+}
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, uint64_t epoch, uint64_t cursorEpoch)
     : _epoch(epoch),
       _cursorEpoch(cursorEpoch),
+      _cache(nullptr),
       _session(NULL),
       _cursorGen(0),
       _cursorsOut(0),
@@ -112,6 +216,9 @@ WiredTigerSession::~WiredTigerSession() {
     if (_session) {
         invariantWTOK(_session->close(_session, NULL));
     }
+    if (_cache) {
+        _cache->_retireCursorCacheStats(*this);
+    }
 }
 
 namespace {
@@ -138,14 +245,25 @@ void _openCursor(WT_SESSION* session,
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool allowOverwrite) {
     // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        if (i->_id == id) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            return c;
-        }
+    auto table = _tablesById.find(id);
+    if (table != _tablesById.end() && !table->second.cursors.empty()) {
+        auto& entries = table->second.cursors;
+        const auto i = entries.back();
+        WT_CURSOR* c = i->_cursor;
+        entries.pop_back();
+        _cursors.erase(i);
+        _cursorsOut++;
+        table->second.counts.hits++;
+        _cursorCacheCounts.hits++;
+        return c;
+    }
+
+    // Opening a cursor costs far more than adding the table's entry.
+    if (table == _tablesById.end()) {
+        table = _tablesById.emplace(id, CachedTable{uri, {}, {}}).first;
     }
+    table->second.counts.misses++;
+    _cursorCacheCounts.misses++;
 
     WT_CURSOR* cursor = NULL;
     _openCursor(_session, uri, allowOverwrite ? "" : "overwrite=false", &cursor);
@@ -171,14 +289,74 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
 
     // Cursors are pushed to the front of the list and removed from the back
     _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    auto& table = _tablesById[id];
+    if (table.uri.empty()) {
+        table.uri = cursor->uri;
+    }
+    table.cursors.push_back(_cursors.begin());
 
     // A negative value for wiredTigercursorCacheSize means to use hybrid caching.
     std::uint32_t cacheSize = abs(kWiredTigerCursorCacheSize.load());
 
+    if (useLRUCursorEviction()) {
+        trimCursorCache(cacheSize);
+        return;
+    }
+
     while (!_cursors.empty() && _cursorGen - _cursors.back()._gen > cacheSize) {
-        cursor = _cursors.back()._cursor;
-        _cursors.pop_back();
+        _closeCachedCursor(std::prev(_cursors.end()));
+    }
+}
+
+void WiredTigerSession::trimCursorCache(size_t maxCursors) {
+    invariant(_session);
+
+    while (_cursors.size() > maxCursors) {
+        _closeCachedCursor(std::prev(_cursors.end()));
+    }
+}
+
+void WiredTigerSession::dropCursorCacheStats(const std::string& uri) {
+    for (auto it = _tablesById.begin(); it != _tablesById.end();) {
+        if (it->second.uri != uri) {
+            ++it;
+        } else if (it->second.cursors.empty()) {
+            _tablesById.erase(it++);
+        } else {
+            it->second.counts = {};
+            ++it;
+        }
+    }
+}
+
+void WiredTigerSession::_mergeCursorCacheStatsInto(WiredTigerCursorCacheStats* stats,
+                                                   size_t maxTables) const {
+    stats->total.hits += _cursorCacheCounts.hits;
+    stats->total.misses += _cursorCacheCounts.misses;
+    for (auto&& entry : _tablesById) {
+        stats->addTable(entry.second.uri, entry.second.counts, maxTables);
+    }
+}
+
+void WiredTigerSession::_closeCachedCursor(CursorCache::iterator it) {
+    auto table = _tablesById.find(it->_id);
+    invariant(table != _tablesById.end());
+    auto& entries = table->second.cursors;
+    entries.erase(std::find(entries.begin(), entries.end(), it));
+
+    WT_CURSOR* cursor = it->_cursor;
+    _cursors.erase(it);
+    if (cursor)
         invariantWTOK(cursor->close(cursor));
+}
+
+void WiredTigerSession::_rebuildCursorIndex() {
+    for (auto&& entry : _tablesById) {
+        entry.second.cursors.clear();
+    }
+    for (auto i = _cursors.end(); i != _cursors.begin();) {
+        --i;
+        _tablesById[i->_id].cursors.push_back(i);
     }
 }
 
@@ -197,8 +375,7 @@ void WiredTigerSession::closeAllCursors(const std::string& uri) {
     for (auto i = _cursors.begin(); i != _cursors.end();) {
         WT_CURSOR* cursor = i->_cursor;
         if (cursor && (all || uri == cursor->uri)) {
-            invariantWTOK(cursor->close(cursor));
-            i = _cursors.erase(i);
+            _closeCachedCursor(i++);
         } else
             ++i;
     }
@@ -209,6 +386,8 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
     _cursorEpoch = _cache->getCursorEpoch();
     auto toDrop = engine->filterCursorsWithQueuedDrops(&_cursors);
+    if (!toDrop.empty())
+        _rebuildCursorIndex();
 
     for (auto i = toDrop.begin(); i != toDrop.end(); i++) {
         WT_CURSOR* cursor = i->_cursor;
@@ -233,13 +412,17 @@ WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
       _conn(engine->getConnection()),
       _clockSource(_engine->getClockSource()),
       _shuttingDown(0),
+      _shards(numSessionCacheShards(0)),
       _prepareCommitOrAbortCounter(0) {}
 
-WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs)
+WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn,
+                                               ClockSource* cs,
+                                               size_t numShards)
     : _engine(nullptr),
       _conn(conn),
       _clockSource(cs),
       _shuttingDown(0),
+      _shards(numSessionCacheShards(numShards)),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
@@ -305,39 +488,31 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
-    uint32_t start = _lastSyncTime.load();
-    // Do the remainder in a critical section that ensures only a single thread at a time
-    // will attempt to synchronize.
-    stdx::unique_lock<stdx::mutex> lk(_lastSyncMutex);
-    uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
-    if (current != start) {
-        // Someone else synced already since we read lastSyncTime, so we're done!
-        return;
-    }
-    _lastSyncTime.store(current + 1);
-
-    // Nobody has synched yet, so we have to sync ourselves.
-
-    // This gets the token (OpTime) from the last write, before flushing (either the journal, or a
-    // checkpoint), and then reports that token (OpTime) as a durable write.
-    stdx::unique_lock<stdx::mutex> jlk(_journalListenerMutex);
-    JournalListener::Token token = _journalListener->getToken();
-
-    // Initialize on first use.
-    if (!_waitUntilDurableSession) {
-        invariantWTOK(
-            _conn->open_session(_conn, NULL, "isolation=snapshot", &_waitUntilDurableSession));
-    }
+    // Concurrent callers share flushes: any flush that starts after this call began covers the
+    // writes this caller is waiting on.
+    _groupCommit.waitForFlush([this] {
+        // This gets the token (OpTime) from the last write, before flushing (either the journal,
+        // or a checkpoint), and then reports that token (OpTime) as a durable write.
+        stdx::unique_lock<stdx::mutex> jlk(_journalListenerMutex);
+        JournalListener::Token token = _journalListener->getToken();
+
+        // Initialize on first use.
+        if (!_waitUntilDurableSession) {
+            invariantWTOK(
+                _conn->open_session(_conn, NULL, "isolation=snapshot", &_waitUntilDurableSession));
+        }
 
-    // Use the journal when available, or a checkpoint otherwise.
-    if (_engine && _engine->isDurable()) {
-        invariantWTOK(_waitUntilDurableSession->log_flush(_waitUntilDurableSession, "sync=on"));
-        LOG(4) << "flushed journal";
-    } else {
-        invariantWTOK(_waitUntilDurableSession->checkpoint(_waitUntilDurableSession, NULL));
-        LOG(4) << "created checkpoint";
-    }
-    _journalListener->onDurable(token);
+        // Use the journal when available, or a checkpoint otherwise.
+        if (_engine && _engine->isDurable()) {
+            invariantWTOK(
+                _waitUntilDurableSession->log_flush(_waitUntilDurableSession, "sync=on"));
+            LOG(4) << "flushed journal";
+        } else {
+            invariantWTOK(_waitUntilDurableSession->checkpoint(_waitUntilDurableSession, NULL));
+            LOG(4) << "created checkpoint";
+        }
+        _journalListener->onDurable(token);
+    });
 }
 
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
@@ -359,9 +534,11 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.mutex);
+        for (auto&& session : shard.sessions) {
+            session->closeAllCursors(uri);
+        }
     }
 }
 
@@ -369,15 +546,21 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.mutex);
+        for (auto&& session : shard.sessions) {
+            session->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    return _sessions.size();
+    size_t count = 0;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.mutex);
+        count += shard.sessions.size();
+    }
+    return count;
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -387,19 +570,20 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     }
 
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.mutex);
         // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
+        for (auto it = shard.sessions.begin(); it != shard.sessions.end();) {
             auto session = *it;
             invariant(session->getIdleExpireTime() != Date_t::min());
             if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
+                it = shard.sessions.erase(it);
                 delete (session);
             } else {
                 ++it;
             }
         }
+        shard.numSessions.store(shard.sessions.size());
     }
 }
 
@@ -408,9 +592,17 @@ void WiredTigerSessionCache::closeAll() {
     SessionCache swap;
 
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        std::vector<stdx::unique_lock<stdx::mutex>> locks;
+        locks.reserve(_shards.size());
+        for (auto&& shard : _shards) {
+            locks.emplace_back(shard.mutex);
+        }
         _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+        for (auto&& shard : _shards) {
+            swap.insert(swap.end(), shard.sessions.begin(), shard.sessions.end());
+            shard.sessions.clear();
+            shard.numSessions.store(0);
+        }
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -427,18 +619,20 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
-            // Reset the idle time
-            cachedSession->setIdleExpireTime(Date_t::min());
-            return UniqueWiredTigerSession(cachedSession);
+    // Prefer this thread's shard, then steal from the others.
+    SessionShard& homeShard = _homeShard();
+    WiredTigerSession* cachedSession = _popSession(homeShard);
+    for (size_t i = 0; !cachedSession && i < _shards.size(); i++) {
+        SessionShard& shard = _shards[i];
+        if (&shard != &homeShard && shard.numSessions.loadRelaxed() > 0) {
+            cachedSession = _popSession(shard);
         }
     }
+    if (cachedSession) {
+        // Reset the idle time
+        cachedSession->setIdleExpireTime(Date_t::min());
+        return UniqueWiredTigerSession(cachedSession);
+    }
 
     // Outside of the cache partition lock, but on release will be put back on the cache
     return UniqueWiredTigerSession(
@@ -473,9 +667,9 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 
         // Release resources in the session we're about to cache.
         // If we are using hybrid caching, then close cursors now and let them
-        // be cached at the WiredTiger level.
+        // be cached at the WiredTiger level, apart from any kept resident.
         if (kWiredTigerCursorCacheSize.load() < 0) {
-            session->closeAllCursors("");
+            session->trimCursorCache(wiredTigerCursorCacheResidentCursors.load());
         }
         invariantWTOK(ss->reset(ss));
     }
@@ -495,10 +689,12 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        SessionShard& shard = _homeShard();
+        stdx::lock_guard<stdx::mutex> lock(shard.mutex);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            shard.sessions.push_back(session);
+            shard.numSessions.store(shard.sessions.size());
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -510,6 +706,82 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         _engine->dropSomeQueuedIdents();
 }
 
+void WiredTigerSessionCache::_retireCursorCacheStats(const WiredTigerSession& session) {
+    stdx::lock_guard<stdx::mutex> lock(_retiredCursorCacheStatsMutex);
+    session._mergeCursorCacheStatsInto(&_retiredCursorCacheStats, kMaxCursorCacheStatsTables);
+}
+
+void WiredTigerSessionCache::appendCursorCacheStats(BSONObjBuilder* builder) {
+    // Sessions in use are counted once they are released. Holding every shard's mutex ensures a
+    // session is not counted both while idle and once destroyed.
+    WiredTigerCursorCacheStats stats;
+    {
+        std::vector<stdx::unique_lock<stdx::mutex>> locks;
+        locks.reserve(_shards.size());
+        for (auto&& shard : _shards) {
+            locks.emplace_back(shard.mutex);
+        }
+        for (auto&& shard : _shards) {
+            for (auto&& session : shard.sessions) {
+                session->_mergeCursorCacheStatsInto(&stats, kMaxCursorCacheStatsTables);
+            }
+        }
+        stdx::lock_guard<stdx::mutex> lock(_retiredCursorCacheStatsMutex);
+        stats.merge(_retiredCursorCacheStats, kMaxCursorCacheStatsTables);
+    }
+
+    builder->append("hits", stats.total.hits);
+    builder->append("misses", stats.total.misses);
+
+    using TableCounts = std::pair<std::string, WiredTigerCursorCacheCounts>;
+    std::vector<TableCounts> tables(stats.byUri.begin(), stats.byUri.end());
+    const auto byMisses = [](const TableCounts& lhs, const TableCounts& rhs) {
+        return lhs.second.misses > rhs.second.misses;
+    };
+    const size_t reported = std::min(tables.size(), kReportedCursorCacheStatsTables);
+    std::partial_sort(tables.begin(), tables.begin() + reported, tables.end(), byMisses);
+
+    BSONArrayBuilder tablesBuilder(builder->subarrayStart("tables"));
+    for (size_t i = 0; i < reported; i++) {
+        BSONObjBuilder tableBuilder(tablesBuilder.subobjStart());
+        tableBuilder.append("uri", tables[i].first);
+        tableBuilder.append("hits", tables[i].second.hits);
+        tableBuilder.append("misses", tables[i].second.misses);
+        tableBuilder.doneFast();
+    }
+    tablesBuilder.doneFast();
+}
+
+void WiredTigerSessionCache::dropCursorCacheStats(const std::string& uri) {
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.mutex);
+        for (auto&& session : shard.sessions) {
+            session->dropCursorCacheStats(uri);
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_retiredCursorCacheStatsMutex);
+    _retiredCursorCacheStats.byUri.erase(uri);
+}
+
+WiredTigerSessionCache::SessionShard& WiredTigerSessionCache::_homeShard() {
+    static AtomicWord<unsigned> nextThreadShard{0};
+    static thread_local unsigned threadShard = nextThreadShard.fetchAndAdd(1);
+    return _shards[threadShard % _shards.size()];
+}
+
+WiredTigerSession* WiredTigerSessionCache::_popSession(SessionShard& shard) {
+    stdx::lock_guard<stdx::mutex> lock(shard.mutex);
+    if (shard.sessions.empty()) {
+        return nullptr;
+    }
+    // Get the most recently used session so that if we discard sessions, we're discarding older
+    // ones
+    WiredTigerSession* session = shard.sessions.back();
+    shard.sessions.pop_back();
+    shard.numSessions.store(shard.sessions.size());
+    return session;
+}
 
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
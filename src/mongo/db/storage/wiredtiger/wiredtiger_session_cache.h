@@ -29,19 +29,25 @@
 
 #pragma once
 
+#include <boost/align/aligned_allocator.hpp>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_group_commit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -55,6 +61,35 @@ public:
     WT_CURSOR* _cursor;
 };
 
+/**
+ * Cursor cache hits and misses of one table, or of all tables.
+ */
+struct WiredTigerCursorCacheCounts {
+    long long hits = 0;
+    long long misses = 0;
+};
+
+/**
+ * Cursor cache hits and misses, in total and per table URI.
+ */
+struct WiredTigerCursorCacheStats {
+    /**
+     * Adds 'counts' to the table 'uri'. Once 'maxTables' tables are tracked, the counts of other
+     * tables are dropped. Does not change the totals.
+     */
+    void addTable(const std::string& uri,
+                  const WiredTigerCursorCacheCounts& counts,
+                  size_t maxTables);
+
+    /**
+     * Adds the counts in 'other', tracking at most 'maxTables' tables.
+     */
+    void merge(const WiredTigerCursorCacheStats& other, size_t maxTables);
+
+    WiredTigerCursorCacheCounts total;
+    stdx::unordered_map<std::string, WiredTigerCursorCacheCounts> byUri;
+};
+
 /**
  * This is a structure that caches 1 cursor for each uri.
  * The idea is that there is a pool of these somewhere.
@@ -130,6 +165,16 @@ public:
      */
     void closeAllCursors(const std::string& uri);
 
+    /**
+     * Closes the least recently used cached cursors until at most 'maxCursors' remain.
+     */
+    void trimCursorCache(size_t maxCursors);
+
+    /**
+     * Forgets the cursor cache hits and misses counted for the table 'uri', which is being dropped.
+     */
+    void dropCursorCacheStats(const std::string& uri);
+
     int cursorsOut() const {
         return _cursorsOut;
     }
@@ -177,11 +222,42 @@ private:
         return _cursorEpoch;
     }
 
+    /**
+     * Removes 'it' from the cursor cache and closes its cursor.
+     */
+    void _closeCachedCursor(CursorCache::iterator it);
+
+    /**
+     * Rebuilds the cursor lists of _tablesById after _cursors was modified directly.
+     */
+    void _rebuildCursorIndex();
+
+    /**
+     * Adds the cursor cache hits and misses of this session to 'stats'.
+     */
+    void _mergeCursorCacheStatsInto(WiredTigerCursorCacheStats* stats, size_t maxTables) const;
+
+    // A table this session opened a cursor on. Entries are kept after their last cursor is closed
+    // so that getCursor() finds the table's counts with the lookup it needs for the cursors.
+    struct CachedTable {
+        std::string uri;
+        // The cached cursors of the table, in _cursors, most recently used last.
+        std::vector<CursorCache::iterator> cursors;
+        // Cursor cache hits and misses on the table since the session was opened.
+        WiredTigerCursorCacheCounts counts;
+    };
+
     const uint64_t _epoch;
     uint64_t _cursorEpoch;
     WiredTigerSessionCache* _cache;  // not owned
     WT_SESSION* _session;            // owned
-    CursorCache _cursors;            // owned
+    CursorCache _cursors;            // owned, most recently used first
+    // Only the owning thread updates the cursor cache counts, here and in _tablesById. The session
+    // cache reads them while the session is idle or being destroyed.
+    stdx::unordered_map<uint64_t, CachedTable> _tablesById;
+    // Cursor cache hits and misses on all tables, including dropped ones, since the session was
+    // opened.
+    WiredTigerCursorCacheCounts _cursorCacheCounts;
     uint64_t _cursorGen;
     int _cursorsOut;
     bool _dropQueuedIdentsAtSessionEnd = true;
@@ -195,7 +271,12 @@ private:
 class WiredTigerSessionCache {
 public:
     WiredTigerSessionCache(WiredTigerKVEngine* engine);
-    WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs);
+
+    /**
+     * 'numShards' is the number of idle session pools, or 0 to size them from the
+     * wiredTigerSessionCacheShards parameter.
+     */
+    WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs, size_t numShards = 0);
     ~WiredTigerSessionCache();
 
     /**
@@ -234,6 +315,18 @@ public:
      */
     void closeAll();
 
+    /**
+     * Appends the cursor cache hits and misses of idle and closed sessions, in total and for the
+     * tables with the most misses.
+     */
+    void appendCursorCacheStats(BSONObjBuilder* builder);
+
+    /**
+     * Forgets the cursor cache hits and misses counted for the table 'uri' by idle and closed
+     * sessions.
+     */
+    void dropCursorCacheStats(const std::string& uri);
+
     /**
      * Closes cached cursors for tables that are queued to be dropped.
      */
@@ -301,11 +394,17 @@ public:
         return _engine;
     }
 
+    const WiredTigerGroupCommit& getGroupCommit() const {
+        return _groupCommit;
+    }
+
     std::uint64_t getPrepareCommitOrAbortCount() const {
         return _prepareCommitOrAbortCounter.loadRelaxed();
     }
 
 private:
+    friend class WiredTigerSession;
+
     WiredTigerKVEngine* _engine;      // not owned, might be NULL
     WT_CONNECTION* _conn;             // not owned
     ClockSource* const _clockSource;  // not owned
@@ -317,9 +416,46 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    /**
+     * A pool of idle sessions. Each thread returns sessions to and takes them from its home
+     * shard, and steals from the other shards when its own is empty, so threads rarely contend
+     * on the same mutex.
+     */
+    struct SessionShard {
+        stdx::mutex mutex;
+        SessionCache sessions;
+        // Mirrors sessions.size() so that stealing can skip empty shards without locking them.
+        AtomicWord<size_t> numSessions{0};
+    };
+
+    /**
+     * Returns the shard the calling thread uses. Threads are assigned shards round-robin on first
+     * use.
+     */
+    SessionShard& _homeShard();
+
+    /**
+     * Pops the most recently released session from 'shard', or returns nullptr if it is empty.
+     */
+    static WiredTigerSession* _popSession(SessionShard& shard);
+
+    /**
+     * Adds the cursor cache statistics of 'session', which is being destroyed.
+     */
+    void _retireCursorCacheStats(const WiredTigerSession& session);
+
+    // Cursor cache hits and misses of destroyed sessions. May be locked while holding a shard's
+    // mutex, but not the other way around.
+    stdx::mutex _retiredCursorCacheStatsMutex;
+    WiredTigerCursorCacheStats _retiredCursorCacheStats;
+
+    // Closing all sessions holds every shard's mutex while bumping _epoch, so a session released
+    // in an older epoch can never be cached afterwards.
+    std::vector<CacheAligned<SessionShard>,
+                boost::alignment::aligned_allocator<CacheAligned<SessionShard>>>
+        _shards;
 
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
@@ -327,9 +463,8 @@ private:
     // Bumped when all open cursors need to be closed
     AtomicWord<unsigned long long> _cursorEpoch;  // atomic so we can check it outside of the lock
 
-    // Counter and critical section mutex for waitUntilDurable
-    AtomicWord<unsigned> _lastSyncTime;
-    stdx::mutex _lastSyncMutex;
+    // Coalesces concurrent non-forced waitUntilDurable calls into shared flushes.
+    WiredTigerGroupCommit _groupCommit;
 
     // Mutex and cond var for waiting on prepare commit or abort.
     stdx::mutex _prepareCommittedOrAbortedMutex;
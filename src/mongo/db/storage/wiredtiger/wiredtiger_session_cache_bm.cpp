@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <wiredtiger.h>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/system_clock_source.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxThreads = 128;
+
+/**
+ * A WiredTiger connection shared by all benchmarks, with one session cache that has a single pool
+ * of idle sessions, as before sharding, and one that uses the default number of shards.
+ */
+class SessionCacheFixture {
+public:
+    SessionCacheFixture() : _dbpath("wiredtiger_session_cache_bm") {
+        invariantWTOK(wiredtiger_open(_dbpath.path().c_str(),
+                                      nullptr,
+                                      "create,cache_size=100MB,session_max=1000",
+                                      &_conn));
+        _singleShardCache = stdx::make_unique<WiredTigerSessionCache>(_conn, &_clockSource, 1);
+        _shardedCache = stdx::make_unique<WiredTigerSessionCache>(_conn, &_clockSource);
+    }
+
+    WiredTigerSessionCache* getSessionCache(bool sharded) {
+        return sharded ? _shardedCache.get() : _singleShardCache.get();
+    }
+
+    static SessionCacheFixture& get() {
+        // Never destroyed, since benchmark threads may still be releasing sessions at exit.
+        static SessionCacheFixture* fixture = new SessionCacheFixture();
+        return *fixture;
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    SystemClockSource _clockSource;
+    WT_CONNECTION* _conn = nullptr;
+    std::unique_ptr<WiredTigerSessionCache> _singleShardCache;
+    std::unique_ptr<WiredTigerSessionCache> _shardedCache;
+};
+
+// A short operation: take a session, use it and give it back.
+void BM_GetAndReleaseSession(benchmark::State& state, bool sharded) {
+    WiredTigerSessionCache* sessionCache = SessionCacheFixture::get().getSessionCache(sharded);
+    for (auto _ : state) {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        benchmark::DoNotOptimize(session->getSession());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_GetAndReleaseSession, SingleShard, false)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_GetAndReleaseSession, Sharded, true)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
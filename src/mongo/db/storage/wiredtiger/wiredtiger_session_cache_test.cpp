@@ -33,10 +33,14 @@
 #include <string>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/system_clock_source.h"
 
 namespace mongo {
@@ -73,10 +77,10 @@ private:
 
 class WiredTigerSessionCacheHarnessHelper {
 public:
-    WiredTigerSessionCacheHarnessHelper(StringData extraStrings)
+    WiredTigerSessionCacheHarnessHelper(StringData extraStrings, size_t numShards = 0)
         : _dbpath("wt_test"),
           _connection(_dbpath.path(), extraStrings),
-          _sessionCache(_connection.getConnection(), _connection.getClockSource()) {}
+          _sessionCache(_connection.getConnection(), _connection.getClockSource(), numShards) {}
 
 
     WiredTigerSessionCache* getSessionCache() {
@@ -113,4 +117,214 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, ThreadStealsSessionReleasedOnAnotherShard) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("", 4);
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Each thread has its own home shard, so the session released by the second thread lands in
+    // a shard this thread must steal from.
+    { UniqueWiredTigerSession session = sessionCache->getSession(); }
+    WiredTigerSession* released = nullptr;
+    stdx::thread([&] {
+        UniqueWiredTigerSession first = sessionCache->getSession();
+        UniqueWiredTigerSession second = sessionCache->getSession();
+        released = second.get();
+    }).join();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 2U);
+
+    UniqueWiredTigerSession mine = sessionCache->getSession();
+    UniqueWiredTigerSession stolen = sessionCache->getSession();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    ASSERT(mine.get() == released || stolen.get() == released);
+}
+
+TEST(WiredTigerSessionCacheTest, CloseAllEmptiesEveryShard) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("", 4);
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&] { UniqueWiredTigerSession session = sessionCache->getSession(); });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 4U);
+
+    UniqueWiredTigerSession outstanding = sessionCache->getSession();
+    sessionCache->closeAll();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+
+    // A session from before closeAll() is not cached when released.
+    outstanding.reset();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
+void createTable(WiredTigerSession* session, const std::string& uri) {
+    WT_SESSION* wtSession = session->getSession();
+    ASSERT_OK(wtRCToStatus(
+        wtSession->create(wtSession, uri.c_str(), "key_format=q,value_format=u")));
+}
+
+TEST(WiredTigerSessionCacheTest, CountsCursorCacheHitsAndMissesPerTable) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    const std::string uri = "table:cursor_cache_stats";
+    const uint64_t tableId = WiredTigerSession::genTableId();
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        createTable(session.get(), uri);
+        for (int i = 0; i < 3; i++) {
+            WT_CURSOR* cursor = session->getCursor(uri, tableId, true);
+            session->releaseCursor(tableId, cursor);
+        }
+    }
+
+    // Statistics are gathered from the idle session.
+    BSONObjBuilder builder;
+    sessionCache->appendCursorCacheStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["hits"].numberLong(), 2);
+    ASSERT_EQ(stats["misses"].numberLong(), 1);
+
+    std::vector<BSONElement> tables = stats["tables"].Array();
+    ASSERT_EQ(tables.size(), 1U);
+    ASSERT_EQ(tables[0]["uri"].String(), uri);
+    ASSERT_EQ(tables[0]["hits"].numberLong(), 2);
+    ASSERT_EQ(tables[0]["misses"].numberLong(), 1);
+
+    // Closing the session keeps its statistics.
+    sessionCache->closeAll();
+    BSONObjBuilder afterCloseBuilder;
+    sessionCache->appendCursorCacheStats(&afterCloseBuilder);
+    BSONObj afterClose = afterCloseBuilder.obj();
+    ASSERT_EQ(afterClose["hits"].numberLong(), 2);
+    ASSERT_EQ(afterClose["misses"].numberLong(), 1);
+    std::vector<BSONElement> afterCloseTables = afterClose["tables"].Array();
+    ASSERT_EQ(afterCloseTables.size(), 1U);
+    ASSERT_EQ(afterCloseTables[0]["hits"].numberLong(), 2);
+    ASSERT_EQ(afterCloseTables[0]["misses"].numberLong(), 1);
+}
+
+TEST(WiredTigerSessionCacheTest, KeepsTableCountsWhenItsCursorsAreClosed) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    const std::string uriA = "table:cursor_cache_closed_a";
+    const std::string uriB = "table:cursor_cache_closed_b";
+    const uint64_t idA = WiredTigerSession::genTableId();
+    const uint64_t idB = WiredTigerSession::genTableId();
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        createTable(session.get(), uriA);
+        createTable(session.get(), uriB);
+        session->releaseCursor(idA, session->getCursor(uriA, idA, true));
+        session->releaseCursor(idA, session->getCursor(uriA, idA, true));
+        session->releaseCursor(idB, session->getCursor(uriB, idB, true));
+
+        // Closing the cached cursors makes the next lookups on the table misses.
+        session->closeAllCursors(uriA);
+        session->releaseCursor(idA, session->getCursor(uriA, idA, true));
+    }
+
+    BSONObjBuilder builder;
+    sessionCache->appendCursorCacheStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["hits"].numberLong(), 1);
+    ASSERT_EQ(stats["misses"].numberLong(), 3);
+
+    // Tables are reported with the most misses first.
+    std::vector<BSONElement> tables = stats["tables"].Array();
+    ASSERT_EQ(tables.size(), 2U);
+    ASSERT_EQ(tables[0]["uri"].String(), uriA);
+    ASSERT_EQ(tables[0]["hits"].numberLong(), 1);
+    ASSERT_EQ(tables[0]["misses"].numberLong(), 2);
+    ASSERT_EQ(tables[1]["uri"].String(), uriB);
+    ASSERT_EQ(tables[1]["hits"].numberLong(), 0);
+    ASSERT_EQ(tables[1]["misses"].numberLong(), 1);
+}
+
+TEST(WiredTigerSessionCacheTest, DroppingTableForgetsItsCursorCacheStats) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    const std::string uriA = "table:cursor_cache_drop_a";
+    const std::string uriB = "table:cursor_cache_drop_b";
+    {
+        // The session from before closeAll() is destroyed on release and the other stays idle.
+        UniqueWiredTigerSession closedSession = sessionCache->getSession();
+        sessionCache->closeAll();
+        UniqueWiredTigerSession idleSession = sessionCache->getSession();
+        createTable(idleSession.get(), uriA);
+        createTable(idleSession.get(), uriB);
+
+        const uint64_t idA = WiredTigerSession::genTableId();
+        const uint64_t idB = WiredTigerSession::genTableId();
+        closedSession->releaseCursor(idA, closedSession->getCursor(uriA, idA, true));
+        idleSession->releaseCursor(idA, idleSession->getCursor(uriA, idA, true));
+        idleSession->releaseCursor(idB, idleSession->getCursor(uriB, idB, true));
+    }
+
+    sessionCache->dropCursorCacheStats(uriA);
+
+    BSONObjBuilder builder;
+    sessionCache->appendCursorCacheStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["misses"].numberLong(), 3);
+    std::vector<BSONElement> tables = stats["tables"].Array();
+    ASSERT_EQ(tables.size(), 1U);
+    ASSERT_EQ(tables[0]["uri"].String(), uriB);
+}
+
+TEST(WiredTigerSessionCacheTest, TrimCursorCacheClosesLeastRecentlyUsedCursors) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    UniqueWiredTigerSession session = sessionCache->getSession();
+
+    const std::string uriA = "table:cursor_cache_trim_a";
+    const std::string uriB = "table:cursor_cache_trim_b";
+    const uint64_t idA = WiredTigerSession::genTableId();
+    const uint64_t idB = WiredTigerSession::genTableId();
+    createTable(session.get(), uriA);
+    createTable(session.get(), uriB);
+
+    WT_CURSOR* cursorA = session->getCursor(uriA, idA, true);
+    WT_CURSOR* cursorB = session->getCursor(uriB, idB, true);
+    session->releaseCursor(idA, cursorA);
+    session->releaseCursor(idB, cursorB);
+    ASSERT_EQ(session->cachedCursors(), 2);
+
+    session->trimCursorCache(1);
+    ASSERT_EQ(session->cachedCursors(), 1);
+
+    // The cursor on B, released last, is the one kept.
+    ASSERT_EQ(session->getCursor(uriB, idB, true), cursorB);
+    session->releaseCursor(idB, cursorB);
+}
+
+TEST(WiredTigerSessionCacheTest, HybridCachingKeepsResidentCursorsOpen) {
+    auto& parameters = ServerParameterSet::getGlobal()->getMap();
+    ASSERT_OK(parameters.find("wiredTigerCursorCacheResidentCursors")->second->setFromString("1"));
+    ON_BLOCK_EXIT([&] {
+        ASSERT_OK(
+            parameters.find("wiredTigerCursorCacheResidentCursors")->second->setFromString("0"));
+    });
+
+    // Run on one shard so the released session is the one handed out next.
+    WiredTigerSessionCacheHarnessHelper harnessHelper("", 1);
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    const std::string uri = "table:cursor_cache_resident";
+    const uint64_t tableId = WiredTigerSession::genTableId();
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        createTable(session.get(), uri);
+        WT_CURSOR* first = session->getCursor(uri, tableId, true);
+        WT_CURSOR* second = session->getCursor(uri, tableId, true);
+        session->releaseCursor(tableId, first);
+        session->releaseCursor(tableId, second);
+        ASSERT_EQ(session->cachedCursors(), 2);
+    }
+
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    ASSERT_EQ(session->cachedCursors(), 1);
+}
+
 }  // namespace mongo
@@ -51,6 +51,7 @@
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/message.h"
 #include "mongo/rpc/op_msg.h"
+#include "mongo/transport/message_compressor_zstd.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/errno_util.h"
 #include "mongo/util/scopeguard.h"
@@ -249,4 +250,37 @@ void trafficRecordingFileToMongoReplayFile(int inputFd, std::ostream& outputStre
     }
 }
 
+void trafficRecordingFileToZstdDictionary(int inputFd,
+                                          std::ostream& outputStream,
+                                          size_t dictionarySize) {
+    // Training works best on about 100 times as much data as the dictionary it produces, and
+    // takes about ten times the samples' size in memory, so stop sampling there.
+    const size_t maxSampleBytes = dictionarySize * 100;
+
+    // Samples are what the message compressors compress: each message without its header.
+    std::string samples;
+    std::vector<size_t> sampleSizes;
+    auto buf = SharedBuffer::allocate(MaxMessageSizeBytes);
+    while (auto packet = readPacket(buf.get(), inputFd)) {
+        if (packet->message.getNetworkOp() == dbCompressed || packet->message.dataLen() <= 0)
+            continue;
+        samples.append(packet->message.data(), packet->message.dataLen());
+        sampleSizes.push_back(packet->message.dataLen());
+        if (samples.size() >= maxSampleBytes)
+            break;
+    }
+
+    std::vector<ConstDataRange> sampleRanges;
+    sampleRanges.reserve(sampleSizes.size());
+    const char* sample = samples.data();
+    for (auto size : sampleSizes) {
+        sampleRanges.emplace_back(sample, sample + size);
+        sample += size;
+    }
+
+    auto dictionary =
+        uassertStatusOK(ZstdMessageCompressor::trainDictionary(sampleRanges, dictionarySize));
+    outputStream.write(dictionary.data(), dictionary.size());
+}
+
 }  // namespace mongo
@@ -38,4 +38,8 @@ BSONArray trafficRecordingFileToBSONArr(const std::string& inputFile);
 
 // This is the function that traffic_reader_main.cpp calls
 void trafficRecordingFileToMongoReplayFile(int inFile, std::ostream& outFile);
+
+// Trains a zstd dictionary of at most 'dictionarySize' bytes from the recorded messages, for use
+// with the zstdCompressionDictionaryFile server parameter.
+void trafficRecordingFileToZstdDictionary(int inFile, std::ostream& outFile, size_t dictionarySize);
 }  // namespace mongo
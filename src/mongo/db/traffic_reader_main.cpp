@@ -72,10 +72,17 @@ int main(int argc, char* argv[], char** envp) {
         auto inputStr = "Path to file input file (defaults to stdin)";
         auto outputStr =
             "Path to file that mongotrafficreader will place its output (defaults to stdout)";
+        auto zstdDictionaryStr =
+            "Output a zstd compression dictionary trained on the recorded messages instead";
+        auto zstdDictionarySizeStr = "Maximum size in bytes of the trained zstd dictionary";
         boost::program_options::options_description desc{"Options"};
         desc.add_options()("help,h", "help")(
             "input,i", boost::program_options::value<std::string>(), inputStr)(
-            "output,o", boost::program_options::value<std::string>(), outputStr);
+            "output,o", boost::program_options::value<std::string>(), outputStr)(
+            "zstdDictionary", zstdDictionaryStr)(
+            "zstdDictionarySize",
+            boost::program_options::value<size_t>()->default_value(112640),
+            zstdDictionarySizeStr);
 
         // Parse the program options
         store(parse_command_line(argc, argv, desc), vm);
@@ -127,7 +134,12 @@ int main(int argc, char* argv[], char** envp) {
         return EXIT_FAILURE;
     }
 
-    mongo::trafficRecordingFileToMongoReplayFile(inputFd, outputStream);
+    if (vm.count("zstdDictionary")) {
+        mongo::trafficRecordingFileToZstdDictionary(
+            inputFd, outputStream, vm["zstdDictionarySize"].as<size_t>());
+    } else {
+        mongo::trafficRecordingFileToMongoReplayFile(inputFd, outputStream);
+    }
 
     return 0;
 }
@@ -34,6 +34,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/multi_index_block.h"
+#include "mongo/db/catalog/multi_index_block_gen.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
@@ -566,6 +567,68 @@ protected:
     }
 };
 
+/** A foreground build which splits its collection scan across threads indexes every document. */
+class ParallelScanBuild : public IndexBuildBase {
+public:
+    void run() {
+        const int oldScanThreads = maxIndexBuildScanThreads.load();
+        maxIndexBuildScanThreads.store(4);
+        ON_BLOCK_EXIT([&] { maxIndexBuildScanThreads.store(oldScanThreads); });
+
+        const int numDocs = 20000;
+        Collection* coll = collection();
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < numDocs; ++i) {
+                // Only a few documents make the index multikey, so that most ranges do not.
+                const BSONObj doc = i % 1000 == 0
+                    ? BSON("_id" << i << "a" << BSON_ARRAY(numDocs + i << -i))
+                    : BSON("_id" << i << "a" << numDocs - i);
+                ASSERT_OK(coll->insertDocument(&_opCtx, InsertStatement(doc), nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+
+        const BSONObj spec = BSON("name"
+                                  << "a_1"
+                                  << "ns"
+                                  << _ns
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion)
+                                  << "background"
+                                  << false);
+
+        MultiIndexBlock indexer;
+        ON_BLOCK_EXIT([&] { indexer.cleanUpAfterBuild(&_opCtx, coll); });
+
+        ASSERT_OK(indexer.init(&_opCtx, coll, spec, MultiIndexBlock::kNoopOnInitFn).getStatus());
+        ASSERT_OK(indexer.insertAllDocumentsInCollection(&_opCtx, coll));
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            ASSERT_OK(indexer.commit(&_opCtx,
+                                     coll,
+                                     MultiIndexBlock::kNoopOnCreateEachFn,
+                                     MultiIndexBlock::kNoopOnCommitFn));
+            wunit.commit();
+        }
+
+        auto desc = coll->getIndexCatalog()->findIndexByName(&_opCtx, "a_1");
+        ASSERT(desc);
+        ASSERT(coll->getIndexCatalog()->getEntry(desc)->isMultikey(&_opCtx));
+
+        auto cursor = _client.query(NamespaceString(_ns), Query().hint(BSON("a" << 1)));
+        int count = 0;
+        while (cursor->more()) {
+            cursor->next();
+            ++count;
+        }
+        ASSERT_EQUALS(numDocs, count);
+    }
+};
+
 class IndexCatatalogFixIndexKey : public IndexBuildBase {
 public:
     void run() {
@@ -710,6 +773,7 @@ public:
         add<SameSpecDifferentSparse>();
         add<SameSpecDifferentTTL>();
         add<StorageEngineOptions>();
+        add<ParallelScanBuild>();
 
         add<IndexCatatalogFixIndexKey>();
 
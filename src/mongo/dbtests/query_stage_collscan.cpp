@@ -390,6 +390,45 @@ public:
     }
 };
 
+//
+// Scan only the records in a range of RecordIds, whose lower bound need not exist.
+//
+class QueryStageCollscanRecordIdRange : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        Collection* collection = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        getRecordIds(collection, CollectionScanParams::FORWARD, &recordIds);
+
+        // Delete the record at the lower bound, so that the scan has to start at the one after.
+        remove(BSON("foo" << 10));
+
+        CollectionScanParams params;
+        params.direction = CollectionScanParams::FORWARD;
+        params.minRecord = recordIds[10];
+        params.maxRecord = recordIds[20];
+
+        WorkingSet ws;
+        unique_ptr<CollectionScan> scan(
+            new CollectionScan(&_opCtx, collection, params, &ws, nullptr));
+
+        vector<RecordId> scanned;
+        while (!scan->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            if (PlanStage::ADVANCED == scan->work(&id)) {
+                scanned.push_back(ws.get(id)->recordId);
+            }
+        }
+
+        ASSERT_EQUALS(9U, scanned.size());
+        for (size_t i = 0; i < scanned.size(); ++i) {
+            ASSERT_EQUALS(recordIds[11 + i], scanned[i]);
+        }
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("QueryStageCollectionScan") {}
@@ -404,6 +443,7 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanDeleteUpcomingObject>();
         add<QueryStageCollscanDeleteUpcomingObjectBackward>();
+        add<QueryStageCollscanRecordIdRange>();
     }
 };
 
@@ -46,6 +46,8 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/global_settings.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_access_method_gen.h"
 #include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/logical_clock.h"
@@ -578,6 +580,30 @@ public:
             << "Ident: " << indexIdent << " Timestamp: " << timestamp;
     }
 
+    /**
+     * Asserts that reading the index 'indexName' at 'ts' returns exactly 'expectedKeys', in order.
+     */
+    void assertIndexKeysAtTimestamp(Collection* coll,
+                                    StringData indexName,
+                                    const Timestamp& ts,
+                                    const std::vector<BSONObj>& expectedKeys) {
+        OneOffRead oor(_opCtx, ts);
+
+        auto indexCatalog = coll->getIndexCatalog();
+        auto descriptor = indexCatalog->findIndexByName(_opCtx, indexName);
+        ASSERT(descriptor) << "Index not found: " << indexName;
+        auto cursor = indexCatalog->getEntry(descriptor)->accessMethod()->newCursor(_opCtx);
+
+        std::vector<BSONObj> keys;
+        for (auto entry = cursor->seek(kMinBSONKey, true); entry; entry = cursor->next()) {
+            keys.push_back(entry->key.getOwned());
+        }
+        ASSERT_EQ(expectedKeys.size(), keys.size()) << "Wrong number of keys at ts: " << ts;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            ASSERT_BSONOBJ_EQ(expectedKeys[i], keys[i]);
+        }
+    }
+
     std::string dumpMultikeyPaths(const MultikeyPaths& multikeyPaths) {
         std::stringstream ss;
 
@@ -1505,6 +1531,165 @@ public:
     }
 };
 
+/**
+ * Inserts a batch of documents with one Collection::insertDocuments() call, as secondaries apply
+ * grouped inserts, so that the index keys go through IndexAccessMethod::insertRecords(). With
+ * 'inKeyOrder' false the indexGroupedInsertsInKeyOrder parameter turns that off, and the results
+ * must be the same.
+ */
+class GroupedInsertTest : public StorageTimestampTest {
+public:
+    explicit GroupedInsertTest(bool inKeyOrder)
+        : _originalInKeyOrder(indexGroupedInsertsInKeyOrder.load()) {
+        indexGroupedInsertsInKeyOrder.store(inKeyOrder);
+    }
+
+    ~GroupedInsertTest() {
+        indexGroupedInsertsInKeyOrder.store(_originalInKeyOrder);
+    }
+
+protected:
+    Status insertBatch(Collection* coll, const std::vector<InsertStatement>& stmts) {
+        WriteUnitOfWork wuow(_opCtx);
+        Status status = coll->insertDocuments(_opCtx, stmts.begin(), stmts.end(), nullptr);
+        if (status.isOK()) {
+            wuow.commit();
+        }
+        return status;
+    }
+
+private:
+    const bool _originalInKeyOrder;
+};
+
+template <bool InKeyOrder>
+class GroupedInsertIndexKeyTimes : public GroupedInsertTest {
+public:
+    GroupedInsertIndexKeyTimes() : GroupedInsertTest(InKeyOrder) {}
+
+    void run() {
+        // Pretend to be a secondary.
+        repl::UnreplicatedWritesBlock uwb(_opCtx);
+
+        NamespaceString nss("unittests.GroupedInsertIndexKeyTimes");
+        reset(nss);
+        auto indexName = "a_1";
+        auto indexSpec =
+            BSON("name" << indexName << "ns" << nss.ns() << "key" << BSON("a" << 1) << "v"
+                        << static_cast<int>(kIndexVersion));
+        ASSERT_OK(dbtests::createIndexFromSpec(_opCtx, nss.ns(), indexSpec));
+
+        const LogicalTime pastTime = _clock->reserveTicks(1);
+        const LogicalTime firstInsertTime = _clock->reserveTicks(3);
+
+        // The documents are inserted in the reverse of their index order, so the keys are written
+        // in a different order than their timestamps.
+        std::vector<InsertStatement> stmts;
+        for (int i = 0; i < 3; ++i) {
+            stmts.emplace_back(BSON("_id" << i << "a" << 3 - i),
+                               firstInsertTime.addTicks(i).asTimestamp(),
+                               presentTerm);
+        }
+
+        AutoGetCollection autoColl(_opCtx, nss, LockMode::MODE_X, LockMode::MODE_IX);
+        Collection* coll = autoColl.getCollection();
+        ASSERT_OK(insertBatch(coll, stmts));
+
+        assertIndexKeysAtTimestamp(coll, indexName, pastTime.asTimestamp(), {});
+        assertIndexKeysAtTimestamp(coll, indexName, firstInsertTime.asTimestamp(), {BSON("" << 3)});
+        assertIndexKeysAtTimestamp(coll,
+                                   indexName,
+                                   firstInsertTime.addTicks(1).asTimestamp(),
+                                   {BSON("" << 2), BSON("" << 3)});
+        assertIndexKeysAtTimestamp(coll,
+                                   indexName,
+                                   firstInsertTime.addTicks(2).asTimestamp(),
+                                   {BSON("" << 1), BSON("" << 2), BSON("" << 3)});
+    }
+};
+
+template <bool InKeyOrder>
+class GroupedInsertSetIndexMultikey : public GroupedInsertTest {
+public:
+    GroupedInsertSetIndexMultikey() : GroupedInsertTest(InKeyOrder) {}
+
+    void run() {
+        // Pretend to be a secondary.
+        repl::UnreplicatedWritesBlock uwb(_opCtx);
+
+        NamespaceString nss("unittests.GroupedInsertSetIndexMultikey");
+        reset(nss);
+        auto indexName = "a_1_b_1";
+        auto indexSpec = BSON("name" << indexName << "ns" << nss.ns() << "key"
+                                     << BSON("a" << 1 << "b" << 1)
+                                     << "v"
+                                     << static_cast<int>(kIndexVersion));
+        ASSERT_OK(dbtests::createIndexFromSpec(_opCtx, nss.ns(), indexSpec));
+
+        const LogicalTime pastTime = _clock->reserveTicks(1);
+        const LogicalTime insertTime0 = _clock->reserveTicks(1);
+        const LogicalTime insertTime1 = _clock->reserveTicks(1);
+        const LogicalTime insertTime2 = _clock->reserveTicks(1);
+
+        // The index becomes multikey on "a" with the second document and on "b" with the third.
+        std::vector<InsertStatement> stmts;
+        stmts.emplace_back(
+            BSON("_id" << 0 << "a" << 3 << "b" << 1), insertTime0.asTimestamp(), presentTerm);
+        stmts.emplace_back(BSON("_id" << 1 << "a" << BSON_ARRAY(1 << 2) << "b" << 1),
+                           insertTime1.asTimestamp(),
+                           presentTerm);
+        stmts.emplace_back(BSON("_id" << 2 << "a" << 1 << "b" << BSON_ARRAY(1 << 2)),
+                           insertTime2.asTimestamp(),
+                           presentTerm);
+
+        AutoGetCollection autoColl(_opCtx, nss, LockMode::MODE_X, LockMode::MODE_IX);
+        Collection* coll = autoColl.getCollection();
+        ASSERT_OK(insertBatch(coll, stmts));
+
+        // Marking the index multikey early is allowed, so the paths of the whole batch may be
+        // visible as soon as the index is multikey, but never before a document made it multikey.
+        assertMultikeyPaths(_opCtx, coll, indexName, pastTime.asTimestamp(), false, {{}, {}});
+        assertMultikeyPaths(_opCtx, coll, indexName, insertTime0.asTimestamp(), false, {{}, {}});
+        assertMultikeyPaths(_opCtx, coll, indexName, insertTime2.asTimestamp(), true, {{0}, {0}});
+    }
+};
+
+template <bool InKeyOrder>
+class GroupedInsertDuplicateKey : public GroupedInsertTest {
+public:
+    GroupedInsertDuplicateKey() : GroupedInsertTest(InKeyOrder) {}
+
+    void run() {
+        NamespaceString nss("unittests.GroupedInsertDuplicateKey");
+        reset(nss);
+        auto indexName = "a_1";
+        auto indexSpec =
+            BSON("name" << indexName << "ns" << nss.ns() << "key" << BSON("a" << 1) << "unique"
+                        << true
+                        << "v"
+                        << static_cast<int>(kIndexVersion));
+        ASSERT_OK(dbtests::createIndexFromSpec(_opCtx, nss.ns(), indexSpec));
+
+        AutoGetCollection autoColl(_opCtx, nss, LockMode::MODE_X, LockMode::MODE_IX);
+        Collection* coll = autoColl.getCollection();
+
+        // The duplicate is detected even though the keys are sorted before they are inserted.
+        std::vector<InsertStatement> stmts;
+        stmts.emplace_back(BSON("_id" << 0 << "a" << 2));
+        stmts.emplace_back(BSON("_id" << 1 << "a" << 1));
+        stmts.emplace_back(BSON("_id" << 2 << "a" << 2));
+        ASSERT_EQ(ErrorCodes::DuplicateKey, insertBatch(coll, stmts).code());
+        ASSERT_EQ(0, itCount(coll));
+
+        // A batch without duplicates is indexed in full.
+        stmts.pop_back();
+        stmts.emplace_back(BSON("_id" << 2 << "a" << 3));
+        ASSERT_OK(insertBatch(coll, stmts));
+        assertIndexKeysAtTimestamp(
+            coll, indexName, Timestamp::min(), {BSON("" << 1), BSON("" << 2), BSON("" << 3)});
+    }
+};
+
 class InitializeMinValid : public StorageTimestampTest {
 public:
     void run() {
@@ -2846,6 +3031,12 @@ public:
         add<InitialSyncSetIndexMultikeyOnInsert>();
         add<PrimarySetIndexMultikeyOnInsert>();
         add<PrimarySetIndexMultikeyOnInsertUnreplicated>();
+        add<GroupedInsertIndexKeyTimes<false>>();
+        add<GroupedInsertIndexKeyTimes<true>>();
+        add<GroupedInsertSetIndexMultikey<false>>();
+        add<GroupedInsertSetIndexMultikey<true>>();
+        add<GroupedInsertDuplicateKey<false>>();
+        add<GroupedInsertDuplicateKey<true>>();
         add<InitializeMinValid>();
         add<SetMinValidInitialSyncFlag>();
         add<SetMinValidToAtLeast>();
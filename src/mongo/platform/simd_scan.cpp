@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/platform/simd_scan.h"
+
+#include "mongo/base/init.h"
+
+#if defined(MONGO_SIMD_SCAN_SSE2) && defined(__GNUC__)
+#include <immintrin.h>
+#define MONGO_SIMD_SCAN_AVX2
+#endif
+
+namespace mongo {
+namespace simd_scan {
+
+#if defined(MONGO_SIMD_SCAN_SSE2)
+namespace {
+
+const char* findNonAsciiTail(const char* begin, const char* end) {
+    for (; end - begin >= 16; begin += 16) {
+        const unsigned mask =
+            _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)));
+        if (mask) {
+            return begin + countTrailingZeros64(mask);
+        }
+    }
+    for (; begin != end; ++begin) {
+        if (static_cast<unsigned char>(*begin) & 0x80) {
+            break;
+        }
+    }
+    return begin;
+}
+
+const char* findNonAsciiLongSSE2(const char* begin, const char* end) {
+    // Test 64 bytes per iteration, and only look for the exact position once a block has a hit.
+    for (; end - begin >= 64; begin += 64) {
+        const auto p = reinterpret_cast<const __m128i*>(begin);
+        const __m128i lo = _mm_or_si128(_mm_loadu_si128(p), _mm_loadu_si128(p + 1));
+        const __m128i hi = _mm_or_si128(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3));
+        if (_mm_movemask_epi8(_mm_or_si128(lo, hi))) {
+            return findNonAsciiTail(begin, begin + 64);
+        }
+    }
+    return findNonAsciiTail(begin, end);
+}
+
+#if defined(MONGO_SIMD_SCAN_AVX2)
+__attribute__((target("avx2"))) const char* findNonAsciiLongAVX2(const char* begin,
+                                                                 const char* end) {
+    for (; end - begin >= 64; begin += 64) {
+        const auto p = reinterpret_cast<const __m256i*>(begin);
+        const __m256i lo = _mm256_loadu_si256(p);
+        const __m256i hi = _mm256_loadu_si256(p + 1);
+        if (_mm256_movemask_epi8(_mm256_or_si256(lo, hi))) {
+            const unsigned loMask = _mm256_movemask_epi8(lo);
+            if (loMask) {
+                return begin + countTrailingZeros64(loMask);
+            }
+            const unsigned hiMask = _mm256_movemask_epi8(hi);
+            return begin + 32 + countTrailingZeros64(hiMask);
+        }
+    }
+    return findNonAsciiTail(begin, end);
+}
+#endif
+
+}  // namespace
+
+namespace detail {
+// Constant-initialized, so scans which run before the initializers do still work.
+const char* (*findNonAsciiLong)(const char* begin, const char* end) = findNonAsciiLongSSE2;
+}  // namespace detail
+
+#if defined(MONGO_SIMD_SCAN_AVX2)
+MONGO_INITIALIZER(SimdScanSelectImplementation)(InitializerContext*) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        detail::findNonAsciiLong = findNonAsciiLongAVX2;
+    }
+    return Status::OK();
+}
+#endif
+#endif
+
+}  // namespace simd_scan
+}  // namespace mongo
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "mongo/platform/bits.h"
+
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#define MONGO_SIMD_SCAN_SSE2
+#endif
+
+// cstringLength() reads the whole aligned block around the start of the string, which the
+// sanitizers would report as an out of bounds access.
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer)
+#define MONGO_SIMD_SCAN_SANITIZED
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+#define MONGO_SIMD_SCAN_SANITIZED
+#endif
+
+namespace mongo {
+namespace simd_scan {
+
+/**
+ * Byte scanning primitives for the hot paths which walk BSON: finding the end of field names and
+ * C strings, and skipping over ASCII text when checking UTF-8. On x86-64 they process 16 bytes at a
+ * time with SSE2, which every x86-64 CPU supports, and scans of long runs of ASCII switch to AVX2
+ * when the CPU has it. Other platforms use the portable byte-at-a-time versions.
+ */
+
+#if defined(MONGO_SIMD_SCAN_SSE2)
+namespace detail {
+
+inline unsigned zeroByteMask(const char* p, bool aligned) {
+    const __m128i block = aligned ? _mm_load_si128(reinterpret_cast<const __m128i*>(p))
+                                  : _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128()));
+}
+
+/**
+ * Returns the first byte of [begin, end) with its high bit set, or 'end' if there is none. Only
+ * used for ranges of at least 64 bytes. Resolved to an AVX2 version at startup when available.
+ */
+extern const char* (*findNonAsciiLong)(const char* begin, const char* end);
+
+}  // namespace detail
+#endif
+
+/**
+ * Returns the length of the NUL-terminated string 'str', like strlen(). Intended for short strings
+ * such as BSON field names, where an out of line call to strlen() costs more than the scan itself.
+ */
+inline size_t cstringLength(const char* str) {
+#if defined(MONGO_SIMD_SCAN_SSE2) && !defined(MONGO_SIMD_SCAN_SANITIZED)
+    // An aligned 16 byte load never crosses a page boundary, so it is safe to read the whole block
+    // which holds the start of the string and ignore the bytes before it.
+    const auto offset = reinterpret_cast<uintptr_t>(str) & 15;
+    const char* block = str - offset;
+    unsigned mask = detail::zeroByteMask(block, true) >> offset;
+    if (mask) {
+        return countTrailingZeros64(mask);
+    }
+
+    for (block += 16;; block += 16) {
+        mask = detail::zeroByteMask(block, true);
+        if (mask) {
+            return (block - str) + countTrailingZeros64(mask);
+        }
+    }
+#else
+    return std::strlen(str);
+#endif
+}
+
+/**
+ * Returns a pointer to the first NUL byte in [begin, end), or nullptr if there is none. Never reads
+ * outside of the range.
+ */
+inline const char* findNul(const char* begin, const char* end) {
+#if defined(MONGO_SIMD_SCAN_SSE2)
+    for (; end - begin >= 16; begin += 16) {
+        const unsigned mask = detail::zeroByteMask(begin, false);
+        if (mask) {
+            return begin + countTrailingZeros64(mask);
+        }
+    }
+#endif
+    return static_cast<const char*>(std::memchr(begin, 0, end - begin));
+}
+
+/**
+ * Returns a pointer to the first byte in [begin, end) which is not ASCII, that is, which has its
+ * high bit set, or 'end' if all of the bytes are ASCII.
+ */
+inline const char* findNonAscii(const char* begin, const char* end) {
+#if defined(MONGO_SIMD_SCAN_SSE2)
+    if (end - begin >= 64) {
+        return detail::findNonAsciiLong(begin, end);
+    }
+
+    for (; end - begin >= 16; begin += 16) {
+        const unsigned mask =
+            _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)));
+        if (mask) {
+            return begin + countTrailingZeros64(mask);
+        }
+    }
+#endif
+    for (; begin != end; ++begin) {
+        if (static_cast<unsigned char>(*begin) & 0x80) {
+            break;
+        }
+    }
+    return begin;
+}
+
+}  // namespace simd_scan
+}  // namespace mongo
@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/platform/simd_scan.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/text.h"
+
+namespace mongo {
+namespace {
+
+// Long enough to cover the 64 byte blocks of findNonAscii() with some tail left over.
+const size_t kBufferSize = 200;
+
+const char* referenceFindNonAscii(const char* begin, const char* end) {
+    while (begin != end && !(static_cast<unsigned char>(*begin) & 0x80))
+        ++begin;
+    return begin;
+}
+
+TEST(SimdScanTest, CStringLengthMatchesStrlen) {
+    std::vector<char> buffer(kBufferSize + 16, 'a');
+    for (size_t start = 0; start < 16; start++) {
+        for (size_t len = 0; len < kBufferSize - start; len++) {
+            buffer[start + len] = '\0';
+            ASSERT_EQUALS(simd_scan::cstringLength(&buffer[start]), len);
+            ASSERT_EQUALS(simd_scan::cstringLength(&buffer[start]), std::strlen(&buffer[start]));
+            buffer[start + len] = 'a';
+        }
+    }
+}
+
+TEST(SimdScanTest, FindNulMatchesMemchr) {
+    std::vector<char> buffer(kBufferSize, 'a');
+    for (size_t start = 0; start < 16; start++) {
+        for (size_t nul = start; nul < kBufferSize; nul++) {
+            buffer[nul] = '\0';
+            const char* begin = &buffer[start];
+            const char* end = buffer.data() + buffer.size();
+            ASSERT_EQUALS(simd_scan::findNul(begin, end), &buffer[nul]);
+            ASSERT_EQUALS(simd_scan::findNul(begin, end), std::memchr(begin, 0, end - begin));
+
+            // The NUL is only found if it is inside the range.
+            ASSERT(!simd_scan::findNul(begin, &buffer[nul]));
+            buffer[nul] = 'a';
+        }
+    }
+}
+
+TEST(SimdScanTest, FindNulEmptyRange) {
+    const char str[] = "";
+    ASSERT(!simd_scan::findNul(str, str));
+}
+
+TEST(SimdScanTest, FindNonAsciiAllAscii) {
+    std::vector<char> buffer(kBufferSize, 'a');
+    for (size_t start = 0; start < 16; start++) {
+        for (size_t end = start; end <= kBufferSize; end++) {
+            ASSERT_EQUALS(simd_scan::findNonAscii(&buffer[start], buffer.data() + end),
+                          buffer.data() + end);
+        }
+    }
+}
+
+TEST(SimdScanTest, FindNonAsciiMatchesReference) {
+    std::vector<char> buffer(kBufferSize, 'a');
+    for (size_t start = 0; start < 16; start++) {
+        for (size_t pos = start; pos < kBufferSize; pos++) {
+            // Try both a lone high byte and a run of them, so the first one has to be picked out of
+            // a block with several hits.
+            for (size_t run : {1, 40}) {
+                const size_t runEnd = std::min(pos + run, kBufferSize);
+                std::fill(buffer.begin() + pos, buffer.begin() + runEnd, '\xC3');
+                const char* begin = &buffer[start];
+                const char* end = buffer.data() + buffer.size();
+                ASSERT_EQUALS(simd_scan::findNonAscii(begin, end), &buffer[pos]);
+                ASSERT_EQUALS(simd_scan::findNonAscii(begin, end),
+                              referenceFindNonAscii(begin, end));
+                std::fill(buffer.begin() + pos, buffer.begin() + runEnd, 'a');
+            }
+        }
+    }
+}
+
+TEST(SimdScanTest, IsValidUTF8AroundAsciiRuns) {
+    // isValidUTF8() skips over ASCII with findNonAscii(), so put multi-byte sequences at every
+    // offset of a long ASCII string, including ones which are cut off by the end of the string.
+    const std::string ascii(100, 'a');
+    const std::string twoByte = "\xC3\xA9";
+    for (size_t pos = 0; pos <= ascii.size(); pos++) {
+        std::string str = ascii;
+        str.insert(pos, twoByte);
+        ASSERT(isValidUTF8(str));
+
+        ASSERT_FALSE(isValidUTF8(ascii.substr(0, pos) + twoByte.substr(0, 1)));
+        ASSERT_FALSE(isValidUTF8(ascii.substr(0, pos) + "\x80" + ascii));
+        ASSERT_FALSE(isValidUTF8(ascii.substr(0, pos) + "\xC3" "a" + ascii));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
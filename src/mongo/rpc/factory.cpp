@@ -84,7 +84,8 @@ OpMsgRequest opMsgRequestFromAnyProtocol(const Message& unownedMessage) {
 std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol) {
     switch (protocol) {
         case Protocol::kOpMsg:
-            return stdx::make_unique<OpMsgReplyBuilder>();
+            // These replies are sent as they are, so they may reference large documents.
+            return stdx::make_unique<OpMsgReplyBuilder>(OpMsgReplyBuilder::SharedObjects::kAllow);
         case Protocol::kOpQuery:
             return stdx::make_unique<LegacyReplyBuilder>();
     }
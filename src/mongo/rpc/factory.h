@@ -67,7 +67,8 @@ inline Message messageFromOpMsgRequest(ProtocolSet clientProtos,
 OpMsgRequest opMsgRequestFromAnyProtocol(const Message& unownedMessage);
 
 /**
- * Returns the appropriate concrete ReplyBuilder.
+ * Returns the appropriate concrete ReplyBuilder for a reply that will be sent back over the
+ * network.
  */
 std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol);
 
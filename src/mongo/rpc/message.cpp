@@ -39,6 +39,18 @@ namespace {
 AtomicWord<int32_t> NextMsgId;
 }  // namespace
 
+void Message::_flatten() const {
+    auto flattened = SharedBuffer::allocate(size());
+    char* out = flattened.get();
+    for (const auto& segment : _segments) {
+        memcpy(out, segment.data, segment.size);
+        out += segment.size;
+    }
+    invariant(out == flattened.get() + size());
+    _buf = std::move(flattened);
+    _segments.clear();
+}
+
 int32_t nextMessageId() {
     return NextMsgId.fetchAndAdd(1);
 }
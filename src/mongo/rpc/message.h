@@ -30,12 +30,16 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/encoded_value_storage.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -390,11 +394,36 @@ inline int ConstView::dataLen() const {
 
 }  // namespace MsgData
 
+/**
+ * A message to or from the network. A message is normally a single contiguous buffer, but it may
+ * instead be made of segments that live in several buffers, such as a reply that references
+ * documents rather than copying them (see OpMsgBuilder::appendSharedObject()). The header is
+ * always in the first segment, so header() never copies, while buf(), sharedBuffer() and
+ * singleData() copy a segmented message into a single buffer the first time they are called.
+ */
 class Message {
 public:
+    /**
+     * A contiguous run of bytes of a segmented message, kept alive by 'owner'.
+     */
+    struct Segment {
+        ConstSharedBuffer owner;
+        const char* data;
+        size_t size;
+    };
+
     Message() = default;
     explicit Message(SharedBuffer data) : _buf(std::move(data)) {}
 
+    /**
+     * Builds a segmented message. The first segment must start at 'data', which holds the header,
+     * and the header's length must be the total size of 'segments'.
+     */
+    Message(SharedBuffer data, std::vector<Segment> segments)
+        : _buf(std::move(data)), _segments(std::move(segments)) {
+        invariant(!_segments.empty() && _segments.front().data == _buf.get());
+    }
+
     MsgData::View header() const {
         verify(!empty());
         return _buf.get();
@@ -406,9 +435,21 @@ public:
 
     MsgData::View singleData() const {
         massert(13273, "single data buffer expected", _buf);
+        _flattenIfSegmented();
         return header();
     }
 
+    bool isSegmented() const {
+        return !_segments.empty();
+    }
+
+    /**
+     * The segments of a segmented message, in order. Empty if the message is contiguous.
+     */
+    const std::vector<Segment>& segments() const {
+        return _segments;
+    }
+
     bool empty() const {
         return !_buf;
     }
@@ -426,6 +467,7 @@ public:
 
     void reset() {
         _buf = {};
+        _segments.clear();
     }
 
     // use to set first buffer if empty
@@ -448,23 +490,37 @@ public:
     }
 
     char* buf() {
+        _flattenIfSegmented();
         return _buf.get();
     }
 
     const char* buf() const {
+        _flattenIfSegmented();
         return _buf.get();
     }
 
     SharedBuffer sharedBuffer() {
+        _flattenIfSegmented();
         return _buf;
     }
 
     ConstSharedBuffer sharedBuffer() const {
+        _flattenIfSegmented();
         return _buf;
     }
 
 private:
-    SharedBuffer _buf;
+    void _flattenIfSegmented() const {
+        if (MONGO_unlikely(!_segments.empty()))
+            _flatten();
+    }
+
+    void _flatten() const;
+
+    // Flattening a segmented message replaces both of these, which doesn't change the bytes of
+    // the message.
+    mutable SharedBuffer _buf;
+    mutable std::vector<Segment> _segments;
 };
 
 /**
@@ -58,14 +58,109 @@ enum class Section : uint8_t {
     kDocSequence = 1,
 };
 
+/**
+ * Reads the bytes of a segmented message in order. Only documents referenced by the message start
+ * a segment part way through the message, so every other BSON element and every size lies within
+ * one segment.
+ */
+class SegmentReader {
+public:
+    explicit SegmentReader(const std::vector<Message::Segment>& segments) : _segments(segments) {}
+
+    /**
+     * The next byte, followed by leftInSegment() - 1 more in the same segment.
+     */
+    const char* pos() const {
+        return _segments[_index].data + _offset;
+    }
+
+    size_t leftInSegment() const {
+        return _index < _segments.size() ? _segments[_index].size - _offset : 0;
+    }
+
+    /**
+     * Whether the next bytes are a document the message references rather than holds a copy of.
+     */
+    bool atSharedObject() const {
+        return _offset == 0 && _index > 0 &&
+            _segments[_index].owner.get() != _segments.front().owner.get();
+    }
+
+    /**
+     * Reads a little-endian integer.
+     */
+    template <typename T>
+    T read() {
+        uassert(ErrorCodes::InvalidBSON, "Truncated OP_MSG segment", leftInSegment() >= sizeof(T));
+        const T value = ConstDataView(pos()).read<LittleEndian<T>>();
+        skip(sizeof(T));
+        return value;
+    }
+
+    void skip(size_t bytes) {
+        while (bytes > 0) {
+            uassert(ErrorCodes::InvalidBSON, "Truncated OP_MSG", leftInSegment() > 0);
+            const size_t skipped = std::min(bytes, leftInSegment());
+            _offset += skipped;
+            bytes -= skipped;
+            if (_offset == _segments[_index].size) {
+                _index++;
+                _offset = 0;
+            }
+        }
+    }
+
+private:
+    const std::vector<Message::Segment>& _segments;
+    size_t _index = 0;
+    size_t _offset = 0;
+};
+
+/**
+ * Copies the object 'reader' is at into 'builder', with each referenced document replaced by an
+ * empty one.
+ */
+void appendWithoutSharedObjects(SegmentReader* reader, BSONObjBuilder* builder) {
+    reader->read<int32_t>();  // The object's size.
+    while (true) {
+        uassert(ErrorCodes::InvalidBSON, "Truncated OP_MSG body", reader->leftInSegment() > 0);
+        const auto type = static_cast<BSONType>(*reader->pos());
+        if (type == EOO) {
+            reader->skip(1);
+            return;
+        }
+
+        if (type != Object && type != Array) {
+            BSONElement elem(reader->pos());
+            uassert(ErrorCodes::InvalidBSON,
+                    "Truncated OP_MSG body",
+                    static_cast<size_t>(elem.size()) <= reader->leftInSegment());
+            builder->append(elem);
+            reader->skip(elem.size());
+            continue;
+        }
+
+        const StringData fieldName(reader->pos() + 1);
+        reader->skip(1 + fieldName.size() + 1);
+        BSONObjBuilder subBuilder(type == Array ? builder->subarrayStart(fieldName)
+                                                : builder->subobjStart(fieldName));
+        if (reader->atSharedObject()) {
+            reader->skip(ConstDataView(reader->pos()).read<LittleEndian<int32_t>>());
+        } else {
+            appendWithoutSharedObjects(reader, &subBuilder);
+        }
+        subBuilder.doneFast();
+    }
+}
+
 }  // namespace
 
 uint32_t OpMsg::flags(const Message& message) {
     if (message.operation() != dbMsg)
         return 0;  // Other command protocols are the same as no flags set.
 
-    return BufReader(message.singleData().data(), message.dataSize())
-        .read<LittleEndian<uint32_t>>();
+    // The flags are in the first segment of a segmented message, along with the header.
+    return BufReader(message.header().data(), message.dataSize()).read<LittleEndian<uint32_t>>();
 }
 
 void OpMsg::replaceFlags(Message* message, uint32_t flags) {
@@ -73,7 +168,36 @@ void OpMsg::replaceFlags(Message* message, uint32_t flags) {
     invariant(message->operation() == dbMsg);
     invariant(message->dataSize() >= static_cast<int>(sizeof(uint32_t)));
 
-    DataView(message->singleData().data()).write<LittleEndian<uint32_t>>(flags);
+    DataView(message->header().data()).write<LittleEndian<uint32_t>>(flags);
+}
+
+BSONObj OpMsg::bodyWithoutSharedObjects(const Message& message) {
+    if (!message.isSegmented()) {
+        return parse(message).body;
+    }
+
+    invariant(message.operation() == dbMsg);
+    SegmentReader reader(message.segments());
+    reader.skip(sizeof(MSGHEADER::Value));
+    const uint32_t flags = reader.read<uint32_t>();
+    uassert(ErrorCodes::IllegalOpMsgFlag,
+            str::stream() << "Message contains illegal flags value: Ob"
+                          << std::bitset<32>(flags).to_string(),
+            !containsUnknownRequiredFlags(flags));
+
+    // OpMsgBuilder writes any document sequences before the body.
+    while (true) {
+        const auto sectionKind = static_cast<Section>(reader.read<uint8_t>());
+        if (sectionKind == Section::kBody) {
+            BSONObjBuilder builder;
+            appendWithoutSharedObjects(&reader, &builder);
+            return builder.obj();
+        }
+        uassert(ErrorCodes::InvalidBSON,
+                str::stream() << "Unknown section kind " << static_cast<int>(sectionKind),
+                sectionKind == Section::kDocSequence);
+        reader.skip(reader.read<int32_t>() - sizeof(int32_t));
+    }
 }
 
 OpMsg OpMsg::parse(const Message& message) try {
@@ -238,14 +362,69 @@ Message OpMsgBuilder::finish() {
     invariant(_bodyStart);
     invariant(!_openBuilder);
     _state = kDone;
+    return finishMessage();
+}
+
+void OpMsgBuilder::appendSharedObject(const BSONObj& obj) {
+    invariant(_state == kDocSequence || _state == kBody);
+    invariant(obj.isOwned());
+    const BSONObj placeholder;
+    _sharedObjects.push_back({_buf.len(), obj});
+    _buf.appendBuf(placeholder.objdata(), placeholder.objsize());
+}
+
+Message OpMsgBuilder::finishMessage() {
+    const int placeholderSize = BSONObj().objsize();
+
+    // The sizes written into the buffer so far only count the placeholders. Each container
+    // still has that size, so it tells which placeholders the container holds.
+    int sharedBytes = 0;
+    if (!_sharedObjects.empty()) {
+        _sharedObjectContainers.push_back(_bodyStart);
+        DataView view(_buf.buf());
+        for (int sizeOffset : _sharedObjectContainers) {
+            const int32_t bufferedSize = view.read<LittleEndian<int32_t>>(sizeOffset);
+            int32_t extra = 0;
+            for (const auto& shared : _sharedObjects) {
+                if (shared.placeholderOffset > sizeOffset &&
+                    shared.placeholderOffset < sizeOffset + bufferedSize) {
+                    extra += shared.obj.objsize() - placeholderSize;
+                }
+            }
+            view.write<LittleEndian<int32_t>>(bufferedSize + extra, sizeOffset);
+        }
+        for (const auto& shared : _sharedObjects) {
+            sharedBytes += shared.obj.objsize() - placeholderSize;
+        }
+    }
 
     const auto size = _buf.len();
     MSGHEADER::View header(_buf.buf());
-    header.setMessageLength(size);
+    header.setMessageLength(size + sharedBytes);
     // header.setRequestMsgId(...); // These are currently filled in by the networking layer.
     // header.setResponseToMsgId(...);
     header.setOpCode(dbMsg);
-    return Message(_buf.release());
+    if (_sharedObjects.empty()) {
+        return Message(_buf.release());
+    }
+
+    auto buffer = _buf.release();
+    std::vector<Message::Segment> segments;
+    segments.reserve(_sharedObjects.size() * 2 + 1);
+    int copiedUpTo = 0;
+    for (const auto& shared : _sharedObjects) {
+        if (shared.placeholderOffset > copiedUpTo) {
+            segments.push_back({buffer,
+                                buffer.get() + copiedUpTo,
+                                size_t(shared.placeholderOffset - copiedUpTo)});
+        }
+        segments.push_back(
+            {shared.obj.sharedBuffer(), shared.obj.objdata(), size_t(shared.obj.objsize())});
+        copiedUpTo = shared.placeholderOffset + placeholderSize;
+    }
+    invariant(copiedUpTo < size);  // The body always follows the last shared object.
+    segments.push_back({buffer, buffer.get() + copiedUpTo, size_t(size - copiedUpTo)});
+    return Message(std::move(buffer), std::move(segments));
 }
 
 BSONObj OpMsgBuilder::releaseBody() {
@@ -255,6 +434,12 @@ BSONObj OpMsgBuilder::releaseBody() {
     invariant(!_openBuilder);
     _state = kDone;
 
+    if (!_sharedObjects.empty()) {
+        // The body has to be contiguous, so copy the shared objects in.
+        auto buffer = finishMessage().sharedBuffer();
+        return BSONObj(buffer.get() + _bodyStart).shareOwnershipWith(buffer);
+    }
+
     auto bson = BSONObj(_buf.buf() + _bodyStart);
     return bson.shareOwnershipWith(_buf.release());
 }
@@ -47,6 +47,8 @@ struct OpMsg {
 
     static constexpr uint32_t kChecksumPresent = 1 << 0;
     static constexpr uint32_t kMoreToCome = 1 << 1;
+    // Set on a getMore request to have its results streamed back as a series of replies, all but
+    // the last of which have kMoreToCome set. The server splits large batches across them.
     static constexpr uint32_t kExhaustSupported = 1 << 16;
 
     /**
@@ -78,6 +80,14 @@ struct OpMsg {
      */
     static OpMsg parse(const Message& message);
 
+    /**
+     * Returns an owned copy of the body of an OP_MSG message, with each document a segmented
+     * message references (see OpMsgBuilder::appendSharedObject()) replaced by an empty one. Unlike
+     * parse(), this doesn't copy a segmented message into a single buffer. The body of a contiguous
+     * message is returned unowned.
+     */
+    static BSONObj bodyWithoutSharedObjects(const Message& message);
+
     /**
      * Parses and returns an OpMsg containing owned BSON.
      */
@@ -196,6 +206,28 @@ public:
         resumeBody().appendElements(body);
     }
 
+    /**
+     * Appends an object to the buffer that stands for 'obj' without copying its bytes. The
+     * buffer only gets an empty placeholder object; finish() returns a segmented Message that
+     * references obj's buffer in its place, and releaseBody() copies it in. 'obj' must be owned.
+     *
+     * The caller must already have written the element's type and field name, or be appending to
+     * a document sequence. Every object enclosing the placeholder except the body must be passed
+     * to addSharedObjectContainer() so that finish() can add the referenced bytes to its size.
+     * Until then, the buffer is still valid BSON, so the body may be read back with the
+     * placeholders in place of the shared objects.
+     */
+    void appendSharedObject(const BSONObj& obj);
+
+    /**
+     * Registers the object or document sequence whose int32 size is at 'sizeOffset' in the buffer
+     * as possibly enclosing shared objects.
+     */
+    void addSharedObjectContainer(int sizeOffset) {
+        if (_sharedObjectContainers.empty() || _sharedObjectContainers.back() != sizeOffset)
+            _sharedObjectContainers.push_back(sizeOffset);
+    }
+
     /**
      * Finish building and return a Message ready to give to the networking layer for transmission.
      * It is illegal to call any methods on this object after calling this.
@@ -213,6 +245,8 @@ public:
         _bodyStart = 0;
         _state = kEmpty;
         _openBuilder = false;
+        _sharedObjects.clear();
+        _sharedObjectContainers.clear();
     }
 
     /**
@@ -254,16 +288,28 @@ private:
 
     void finishDocumentStream(DocSequenceBuilder* docSequenceBuilder);
 
+    /**
+     * Fills in the header and builds the Message, splicing in any shared objects.
+     */
+    Message finishMessage();
+
     void skipHeaderAndFlags() {
         _buf.skip(sizeof(MSGHEADER::Layout));  // This is filled in by finish().
         _buf.appendNum(uint32_t(0));           // flags (currently always 0).
     }
 
+    struct SharedObject {
+        int placeholderOffset;
+        BSONObj obj;
+    };
+
     // When adding members, remember to update reset().
     BufBuilder _buf;
     int _bodyStart = 0;
     State _state = kEmpty;
     bool _openBuilder = false;
+    std::vector<SharedObject> _sharedObjects;  // In buffer order.
+    std::vector<int> _sharedObjectContainers;
 };
 
 /**
@@ -312,6 +358,15 @@ public:
         _buf->appendBuf(obj.objdata(), obj.objsize());
     }
 
+    /**
+     * Appends a single document to this sequence without copying it. See
+     * OpMsgBuilder::appendSharedObject().
+     */
+    void appendShared(const BSONObj& obj) {
+        _msgBuilder->addSharedObjectContainer(_sizeOffset);
+        _msgBuilder->appendSharedObject(obj);
+    }
+
     /**
      * Returns a BSONObjBuilder that appends a single document to this sequence in place.
      * It is illegal to call any methods on this DocSequenceBuilder until the returned builder
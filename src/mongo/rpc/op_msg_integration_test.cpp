@@ -400,4 +400,76 @@ TEST(OpMsg, ExhaustWithDBClientCursorBehavesCorrectly) {
     ASSERT(!cursor->more());
     ASSERT(cursor->isDead());
 }
+
+TEST(OpMsg, ServerSplitsLargeExhaustBatches) {
+    std::string errMsg;
+    auto conn = std::unique_ptr<DBClientBase>(
+        unittest::getFixtureConnectionString().connect("integration_test", errMsg));
+    uassert(ErrorCodes::SocketException, errMsg, conn);
+
+    // Only test exhaust against a single server.
+    if (conn->isReplicaSetMember() || conn->isMongos()) {
+        return;
+    }
+
+    const int chunkSizeBytes = 4 * 1024;
+    BSONObj res;
+    ASSERT(conn->runCommand("admin",
+                            BSON("setParameter" << 1 << "streamedReplyChunkSizeBytes"
+                                                << chunkSizeBytes),
+                            res));
+    ON_BLOCK_EXIT([&] {
+        conn->runCommand("admin",
+                         BSON("setParameter" << 1 << "streamedReplyChunkSizeBytes" << 1024 * 1024),
+                         res);
+    });
+
+    NamespaceString nss("test", "coll");
+    conn->dropCollection(nss.toString());
+
+    // Insert enough documents that one batch spans many chunks.
+    const int nDocs = 50;
+    const std::string padding(1024, 'x');
+    for (int i = 0; i < nDocs; i++) {
+        conn->insert(nss.toString(), BSON("_id" << i << "padding" << padding), 0);
+    }
+
+    auto findCmd = BSON("find" << nss.coll() << "batchSize" << 0 << "sort" << BSON("_id" << 1));
+    auto request = OpMsgRequest::fromDBAndBody(nss.db(), findCmd).serialize();
+    Message reply;
+    ASSERT(conn->call(request, reply));
+    res = OpMsg::parse(reply).body;
+    const long long cursorId = res["cursor"]["id"].numberLong();
+
+    // Without a batch size, a getMore outside of an exhaust stream would return every document.
+    GetMoreRequest gmr(nss, cursorId, boost::none, boost::none, boost::none, boost::none);
+    request = OpMsgRequest::fromDBAndBody(nss.db(), gmr.toBSON()).serialize();
+    OpMsg::setFlag(&request, OpMsg::kExhaustSupported);
+    ASSERT(conn->call(request, reply));
+
+    int nextId = 0;
+    int replies = 1;
+    while (true) {
+        res = OpMsg::parse(reply).body;
+        ASSERT_OK(getStatusFromCommandResult(res));
+        auto nextBatch = res["cursor"]["nextBatch"].Array();
+        ASSERT_FALSE(nextBatch.empty());
+        ASSERT_LTE(nextBatch.size(), chunkSizeBytes / padding.size());
+        for (auto&& doc : nextBatch) {
+            ASSERT_EQ(doc["_id"].numberInt(), nextId++);
+        }
+
+        if (!OpMsg::isFlagSet(reply, OpMsg::kMoreToCome)) {
+            ASSERT_EQ(res["cursor"]["id"].numberLong(), 0);
+            break;
+        }
+        ASSERT_EQ(res["cursor"]["id"].numberLong(), cursorId);
+        const auto lastRequestId = reply.header().getId();
+        ASSERT(conn->recv(reply, lastRequestId));
+        ++replies;
+    }
+
+    ASSERT_EQ(nextId, nDocs);
+    ASSERT_GT(replies, 1);
+}
 }  // namespace mongo
@@ -53,6 +53,17 @@ private:
 
 class OpMsgReplyBuilder final : public rpc::ReplyBuilderInterface {
 public:
+    enum class SharedObjects { kCopy, kAllow };
+
+    /**
+     * With SharedObjects::kAllow, large owned documents in the reply may be referenced rather than
+     * copied (see getSharedObjectBuilder()). The body built in place then holds empty placeholder
+     * objects for them until done() or releaseBody(), so only allow this for replies that are not
+     * read back through getBodyBuilder() beyond their top-level fields.
+     */
+    explicit OpMsgReplyBuilder(SharedObjects sharedObjects = SharedObjects::kCopy)
+        : _sharedObjects(sharedObjects) {}
+
     ReplyBuilderInterface& setRawCommandReply(const BSONObj& reply) override {
         _builder.beginBody().appendElements(reply);
         return *this;
@@ -66,6 +77,9 @@ public:
     OpMsgBuilder::DocSequenceBuilder getDocSequenceBuilder(StringData name) override {
         return _builder.beginDocSequence(name);
     }
+    OpMsgBuilder* getSharedObjectBuilder() override {
+        return _sharedObjects == SharedObjects::kAllow ? &_builder : nullptr;
+    }
     rpc::Protocol getProtocol() const override {
         return rpc::Protocol::kOpMsg;
     }
@@ -83,6 +97,7 @@ public:
     }
 
 private:
+    const SharedObjects _sharedObjects;
     OpMsgBuilder _builder;
 };
 
@@ -772,6 +772,119 @@ TEST(OpMsgSerializer, BodyAndInPlaceSequenceInPlaceWithReset) {
                    });
 }
 
+TEST(OpMsgSerializer, SharedObjectsAreReferencedInPlace) {
+    const BSONObj shared = fromjson("{a: 'shared'}");
+    OpMsgBuilder builder;
+
+    {
+        auto seq = builder.beginDocSequence("docs");
+        seq.append(fromjson("{a: 1}"));
+        seq.appendShared(shared);
+        seq.appendShared(shared);
+    }
+
+    {
+        auto body = builder.beginBody();
+        body.append("ping", 1);
+        BSONObjBuilder sub(body.subobjStart("sub"));
+        builder.addSharedObjectContainer(sub.offset());
+        sub.subobjStart("shared");
+        builder.appendSharedObject(shared);
+        sub.append("after", 1);
+    }
+
+    // Until the message is finished, the body holds a placeholder for the shared object.
+    ASSERT_BSONOBJ_EQ(builder.resumeBody().asTempObj(),
+                      fromjson("{ping: 1, sub: {shared: {}, after: 1}}"));
+
+    auto msg = builder.finish();
+    ASSERT(msg.isSegmented());
+    ASSERT_EQ(std::count_if(msg.segments().begin(),
+                            msg.segments().end(),
+                            [&](const Message::Segment& segment) {
+                                return segment.data == shared.objdata();
+                            }),
+              3);
+
+    testSerializer(msg,
+                   OpMsgBytes{
+                       kNoFlags,  //
+                       kDocSequenceSection,
+                       Sized{
+                           "docs",  //
+                           fromjson("{a: 1}"),
+                           shared,
+                           shared,
+                       },
+
+                       kBodySection,
+                       fromjson("{ping: 1, sub: {shared: {a: 'shared'}, after: 1}}"),
+                   });
+    ASSERT_FALSE(msg.isSegmented());
+}
+
+TEST(OpMsgSerializer, ReleaseBodyCopiesInSharedObjects) {
+    const BSONObj shared = fromjson("{a: 'shared'}");
+    OpMsgBuilder builder;
+
+    {
+        auto body = builder.beginBody();
+        body.append("ping", 1);
+        body.subobjStart("shared");
+        builder.appendSharedObject(shared);
+    }
+
+    ASSERT_BSONOBJ_EQ(builder.releaseBody(), fromjson("{ping: 1, shared: {a: 'shared'}}"));
+}
+
+TEST(OpMsgSerializer, SegmentedMessageIsReadWithoutCopyingSharedObjects) {
+    const BSONObj shared = fromjson("{a: 'shared'}");
+    OpMsgBuilder builder;
+
+    {
+        auto seq = builder.beginDocSequence("docs");
+        seq.appendShared(shared);
+    }
+
+    {
+        auto body = builder.beginBody();
+        BSONObjBuilder cursor(body.subobjStart("cursor"));
+        builder.addSharedObjectContainer(cursor.offset());
+        {
+            // The array's size follows its type byte and NUL-terminated field name.
+            const int batchSizeOffset = cursor.bb().len() + 1 + StringData("nextBatch").size() + 1;
+            BSONArrayBuilder batch(cursor.subarrayStart("nextBatch"));
+            builder.addSharedObjectContainer(batchSizeOffset);
+            batch.append(fromjson("{b: 1}"));
+            batch.subobjStart();
+            builder.appendSharedObject(shared);
+            batch.subobjStart();
+            builder.appendSharedObject(shared);
+        }
+        cursor.append("id", 123LL);
+        cursor.append("ns", "test.coll");
+        cursor.doneFast();
+        body.append("ok", 1.0);
+    }
+
+    auto msg = builder.finish();
+    ASSERT(msg.isSegmented());
+
+    OpMsg::setFlag(&msg, OpMsg::kMoreToCome);
+    ASSERT(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT_BSONOBJ_EQ(
+        OpMsg::bodyWithoutSharedObjects(msg),
+        fromjson("{cursor: {nextBatch: [{b: 1}, {}, {}], id: 123, ns: 'test.coll'}, ok: 1.0}"));
+    ASSERT(msg.isSegmented());
+
+    // The flags set on the segmented message are sent with it.
+    ASSERT_EQ(OpMsg::flags(msg), OpMsg::kMoreToCome);
+    ASSERT_BSONOBJ_EQ(OpMsg::parse(msg).body,
+                      fromjson("{cursor: {nextBatch: [{b: 1}, {a: 'shared'}, {a: 'shared'}], "
+                               "id: 123, ns: 'test.coll'}, ok: 1.0}"));
+    ASSERT_FALSE(msg.isSegmented());
+}
+
 TEST(OpMsgSerializer, ReplaceFlagsWorks) {
     {
         auto msg = OpMsgBytes{~0u}.done();
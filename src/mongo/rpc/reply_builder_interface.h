@@ -76,6 +76,14 @@ public:
         uasserted(50875, "Only OpMsg may use document sequences");
     }
 
+    /**
+     * Returns the OpMsgBuilder that large owned documents may be appended to by reference with
+     * OpMsgBuilder::appendSharedObject(), or nullptr if this reply must copy them.
+     */
+    virtual OpMsgBuilder* getSharedObjectBuilder() {
+        return nullptr;
+    }
+
     /**
      * Sets the reply for this command. If an engaged StatusWith<BSONObj> is passed, the command
      * reply will be set to the contained BSONObj, augmented with the element {ok, 1.0} if it
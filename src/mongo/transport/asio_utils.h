@@ -42,6 +42,8 @@
 #include <sys/poll.h>
 #endif  // ndef _WIN32
 
+#include <vector>
+
 #include <asio.hpp>
 
 namespace mongo {
@@ -322,6 +324,45 @@ boost::optional<std::array<std::uint8_t, 7>> checkTLSRequest(const Buffer& buffe
 }
 #endif
 
+/**
+ * Returns 'buffers' without its first 'size' bytes, for resuming a write that asio::write()
+ * finished part of.
+ */
+template <typename ConstBufferSequence>
+ConstBufferSequence consumeBuffers(ConstBufferSequence buffers, std::size_t size) {
+    buffers += size;
+    return buffers;
+}
+
+inline std::vector<asio::const_buffer> consumeBuffers(
+    const std::vector<asio::const_buffer>& buffers, std::size_t size) {
+    std::vector<asio::const_buffer> remaining;
+    for (const auto& buffer : buffers) {
+        if (size >= buffer.size()) {
+            size -= buffer.size();
+            continue;
+        }
+        remaining.push_back(buffer + size);
+        size = 0;
+    }
+    return remaining;
+}
+
+/**
+ * Returns the first byte of 'buffers', or an empty buffer if 'buffers' is empty.
+ */
+template <typename ConstBufferSequence>
+asio::const_buffer firstByteOf(const ConstBufferSequence& buffers) {
+    for (auto it = asio::buffer_sequence_begin(buffers); it != asio::buffer_sequence_end(buffers);
+         ++it) {
+        asio::const_buffer buffer(*it);
+        if (buffer.size()) {
+            return asio::const_buffer(buffer.data(), 1);
+        }
+    }
+    return asio::const_buffer();
+}
+
 /**
  * Pass this to asio functions in place of a callback to have them return a Future<T>. This behaves
  * similarly to asio::use_future_t, however it returns a mongo::Future<T> rather than a
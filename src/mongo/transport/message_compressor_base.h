@@ -33,6 +33,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
 
 #include <type_traits>
 
@@ -88,6 +89,24 @@ public:
      */
     virtual StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) = 0;
 
+    /*
+     * Returns the ID of the dictionary this compressor was configured with, or 0 if it has none.
+     * Peers only compress with a dictionary once both sides have agreed on its ID while
+     * negotiating compression, so decompressData must handle input compressed either way.
+     */
+    virtual uint32_t getDictionaryId() const {
+        return 0;
+    }
+
+    /*
+     * Like compressData, but compresses with the dictionary identified by getDictionaryId(). It is
+     * only called on compressors that have a dictionary.
+     */
+    virtual StatusWith<std::size_t> compressDataWithDictionary(ConstDataRange input,
+                                                               DataRange output) {
+        MONGO_UNREACHABLE;
+    }
+
     /*
      * This returns the number of bytes passed in the input for compressData
      */
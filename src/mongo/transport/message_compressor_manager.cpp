@@ -33,6 +33,8 @@
 
 #include "mongo/transport/message_compressor_manager.h"
 
+#include <algorithm>
+
 #include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_endian.h"
 #include "mongo/bson/bsonobj.h"
@@ -82,6 +84,8 @@ private:
 
 const transport::Session::Decoration<MessageCompressorManager> getForSession =
     transport::Session::declareDecoration<MessageCompressorManager>();
+
+constexpr auto kDictionariesField = "compressionDictionaries"_sd;
 }  // namespace
 
 MessageCompressorManager::MessageCompressorManager()
@@ -130,7 +134,8 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
-    auto sws = compressor->compressData(input, output);
+    auto sws = _usesDictionary(compressor) ? compressor->compressDataWithDictionary(input, output)
+                                           : compressor->compressData(input, output);
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -196,17 +201,21 @@ void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
 
     // We're about to update the compressor list with the negotiation result from the server.
     _negotiated.clear();
+    _negotiatedDictionaries.clear();
 
     auto& compressorList = _registry->getCompressorNames();
     if (compressorList.size() == 0)
         return;
 
+    std::vector<MessageCompressorBase*> offered;
     BSONArrayBuilder sub(output->subarrayStart("compression"));
     for (const auto e : _registry->getCompressorNames()) {
         LOG(3) << "Offering " << e << " compressor to server";
         sub.append(e);
+        offered.push_back(_registry->getCompressor(e));
     }
     sub.doneFast();
+    _appendDictionaryIds(offered, output);
 }
 
 void MessageCompressorManager::clientFinish(const BSONObj& input) {
@@ -232,6 +241,7 @@ void MessageCompressorManager::clientFinish(const BSONObj& input) {
         LOG(3) << "Adding compressor " << ret->getName();
         _negotiated.push_back(ret);
     }
+    _negotiateDictionaries(input);
 }
 
 void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuilder* output) {
@@ -250,6 +260,7 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
                 sub.append(algo->getName());
             }
             sub.doneFast();
+            _appendDictionaryIds(_compressorsUsingDictionaries(), output);
         } else {
             LOG(3) << "Compression negotiation not requested by client";
         }
@@ -259,6 +270,7 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
     // If compression has already been negotiated, then this is a renegotiation, so we should
     // reset the state of the manager.
     _negotiated.clear();
+    _negotiatedDictionaries.clear();
 
     // First we go through all the compressor names that the client has requested support for
     BSONObj theirObj = elem.Obj();
@@ -289,11 +301,59 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
             sub.append(algo->getName());
         }
         sub.doneFast();
+        _negotiateDictionaries(input);
+        _appendDictionaryIds(_compressorsUsingDictionaries(), output);
     } else {
         LOG(3) << "Could not agree on compressor to use";
     }
 }
 
+void MessageCompressorManager::_appendDictionaryIds(
+    const std::vector<MessageCompressorBase*>& compressors, BSONObjBuilder* output) const {
+    BSONObjBuilder dictionaries;
+    for (const auto compressor : compressors) {
+        if (compressor->getDictionaryId() == 0)
+            continue;
+        dictionaries.append(compressor->getName(),
+                            static_cast<long long>(compressor->getDictionaryId()));
+    }
+    if (!dictionaries.asTempObj().isEmpty()) {
+        output->append(kDictionariesField, dictionaries.obj());
+    }
+}
+
+std::vector<MessageCompressorBase*> MessageCompressorManager::_compressorsUsingDictionaries()
+    const {
+    std::vector<MessageCompressorBase*> compressors;
+    for (const auto compressor : _negotiated) {
+        if (_usesDictionary(compressor))
+            compressors.push_back(compressor);
+    }
+    return compressors;
+}
+
+void MessageCompressorManager::_negotiateDictionaries(const BSONObj& peer) {
+    auto elem = peer.getField(kDictionariesField);
+    if (elem.type() != Object)
+        return;
+
+    const auto theirDictionaries = elem.Obj();
+    for (const auto compressor : _negotiated) {
+        const auto dictionaryId = compressor->getDictionaryId();
+        auto theirs = theirDictionaries[compressor->getName()];
+        if (dictionaryId == 0 || !theirs.isNumber() || theirs.safeNumberLong() != dictionaryId)
+            continue;
+        LOG(3) << "Using dictionary " << dictionaryId << " with " << compressor->getName();
+        _negotiatedDictionaries.push_back(compressor->getId());
+    }
+}
+
+bool MessageCompressorManager::_usesDictionary(const MessageCompressorBase* compressor) const {
+    return std::find(_negotiatedDictionaries.begin(),
+                     _negotiatedDictionaries.end(),
+                     compressor->getId()) != _negotiatedDictionaries.end();
+}
+
 MessageCompressorManager& MessageCompressorManager::forSession(
     const transport::SessionHandle& session) {
     return getForSession(session.get());
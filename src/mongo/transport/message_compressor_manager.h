@@ -65,6 +65,10 @@ public:
      * Called by a client constructing an isMaster request. This function will append the result
      * of _registry->getCompressorNames() to the BSONObjBuilder as a BSON array. If no compressors
      * are configured, it won't append anything.
+     *
+     * Compressors configured with a dictionary also offer its ID in a "compressionDictionaries"
+     * object that maps compressor names to dictionary IDs. Messages are only compressed with a
+     * dictionary when the server answers with the same ID for it.
      */
     void clientBegin(BSONObjBuilder* output);
 
@@ -87,6 +91,9 @@ public:
      *
      * If no compressors are configured that match those requested by the client, then it will
      * not append anything to the BSONObjBuilder output.
+     *
+     * Negotiated compressors that have the same dictionary as the client's entry in
+     * "compressionDictionaries" use it from then on, and are echoed back in the same form.
      */
     void serverNegotiate(const BSONObj& input, BSONObjBuilder* output);
 
@@ -127,7 +134,18 @@ public:
     static MessageCompressorManager& forSession(const transport::SessionHandle& session);
 
 private:
+    void _appendDictionaryIds(const std::vector<MessageCompressorBase*>& compressors,
+                              BSONObjBuilder* output) const;
+
+    std::vector<MessageCompressorBase*> _compressorsUsingDictionaries() const;
+
+    void _negotiateDictionaries(const BSONObj& peer);
+
+    bool _usesDictionary(const MessageCompressorBase* compressor) const;
+
     std::vector<MessageCompressorBase*> _negotiated;
+    // The compressors for which both sides agreed on a dictionary.
+    std::vector<MessageCompressorId> _negotiatedDictionaries;
     MessageCompressorRegistry* _registry;
 };
 
@@ -322,6 +322,130 @@ TEST(MessageCompressorManager, SERVER_28008) {
     ASSERT_EQ(compressorId, zstdId);
 }
 
+// A command like the ones drivers send, which differ only in a few values.
+BSONObj buildCommand(int i) {
+    return BSON("find"
+                << "collection"
+                << "filter"
+                << BSON("_id" << i)
+                << "lsid"
+                << BSON("id" << (i % 17))
+                << "txnNumber"
+                << static_cast<long long>(i)
+                << "$clusterTime"
+                << BSON("clusterTime" << Timestamp(1000, i) << "signature"
+                                      << BSON("keyId" << 0LL))
+                << "$db"
+                << "test");
+}
+
+Message buildCommandMessage(int i) {
+    const auto command = buildCommand(i);
+    const auto bufferSize = MsgData::MsgDataHeaderSize + command.objsize();
+    auto buf = SharedBuffer::allocate(bufferSize);
+    MsgData::View testView(buf.get());
+    testView.setId(i);
+    testView.setResponseToMsgId(0);
+    testView.setOperation(dbQuery);
+    testView.setLen(bufferSize);
+    memcpy(testView.data(), command.objdata(), command.objsize());
+    return Message{buf};
+}
+
+std::unique_ptr<ZstdMessageCompressor> makeZstdWithTrainedDictionary() {
+    std::vector<BSONObj> commands;
+    std::vector<ConstDataRange> samples;
+    for (int i = 0; i < 2000; i++) {
+        commands.push_back(buildCommand(i));
+        samples.emplace_back(commands.back().objdata(),
+                             commands.back().objdata() + commands.back().objsize());
+    }
+    auto swDictionary = ZstdMessageCompressor::trainDictionary(samples, 4096);
+    ASSERT_OK(swDictionary.getStatus());
+    const auto& dictionary = swDictionary.getValue();
+
+    auto swCompressor = ZstdMessageCompressor::makeWithDictionary(
+        ConstDataRange(dictionary.data(), dictionary.data() + dictionary.size()));
+    ASSERT_OK(swCompressor.getStatus());
+    ASSERT_NE(swCompressor.getValue()->getDictionaryId(), 0U);
+    return std::move(swCompressor.getValue());
+}
+
+MessageCompressorRegistry buildRegistry(std::unique_ptr<MessageCompressorBase> compressor) {
+    MessageCompressorRegistry registry;
+    registry.setSupportedCompressors({compressor->getName()});
+    registry.registerImplementation(std::move(compressor));
+    ASSERT_OK(registry.finalizeSupportedCompressors());
+    return registry;
+}
+
+BSONObj negotiate(MessageCompressorManager* clientManager,
+                  MessageCompressorManager* serverManager) {
+    BSONObjBuilder clientOutput;
+    clientManager->clientBegin(&clientOutput);
+    BSONObjBuilder serverOutput;
+    serverManager->serverNegotiate(clientOutput.obj(), &serverOutput);
+    auto serverObj = serverOutput.obj();
+    clientManager->clientFinish(serverObj);
+    return serverObj;
+}
+
+TEST(ZstdMessageCompressor, DictionaryIsNegotiatedAndUsed) {
+    auto registry = buildRegistry(makeZstdWithTrainedDictionary());
+    const auto dictionaryId = registry.getCompressor("zstd")->getDictionaryId();
+    MessageCompressorManager clientManager(&registry);
+    MessageCompressorManager serverManager(&registry);
+
+    auto serverObj = negotiate(&clientManager, &serverManager);
+    checkNegotiationResult(serverObj, {"zstd"});
+    ASSERT_BSONOBJ_EQ(serverObj["compressionDictionaries"].Obj(),
+                      BSON("zstd" << static_cast<long long>(dictionaryId)));
+
+    auto plainRegistry = buildRegistry(stdx::make_unique<ZstdMessageCompressor>());
+    MessageCompressorManager plainClientManager(&plainRegistry);
+    MessageCompressorManager plainServerManager(&plainRegistry);
+    negotiate(&plainClientManager, &plainServerManager);
+
+    const auto original = buildCommandMessage(5000);
+    const auto compressed = assertOk(clientManager.compressMessage(original));
+    const auto compressedPlain = assertOk(plainClientManager.compressMessage(original));
+    ASSERT_LT(compressed.size(), compressedPlain.size());
+
+    const auto decompressed = assertOk(serverManager.decompressMessage(compressed));
+    ASSERT_EQ(decompressed.size(), original.size());
+    ASSERT_EQ(memcmp(decompressed.buf(), original.buf(), original.size()), 0);
+
+    // A peer without the dictionary can't read messages compressed with it.
+    ASSERT_NOT_OK(plainServerManager.decompressMessage(compressed).getStatus());
+}
+
+TEST(ZstdMessageCompressor, DictionaryIsNotUsedUnlessBothSidesHaveIt) {
+    auto clientRegistry = buildRegistry(makeZstdWithTrainedDictionary());
+    auto serverRegistry = buildRegistry(stdx::make_unique<ZstdMessageCompressor>());
+    MessageCompressorManager clientManager(&clientRegistry);
+    MessageCompressorManager serverManager(&serverRegistry);
+
+    auto serverObj = negotiate(&clientManager, &serverManager);
+    checkNegotiationResult(serverObj, {"zstd"});
+    ASSERT_FALSE(serverObj.hasField("compressionDictionaries"));
+
+    const auto original = buildCommandMessage(1);
+    auto toSend = assertOk(clientManager.compressMessage(original));
+    auto recvd = assertOk(serverManager.decompressMessage(toSend));
+    ASSERT_EQ(memcmp(recvd.buf(), original.buf(), original.size()), 0);
+
+    toSend = assertOk(serverManager.compressMessage(recvd));
+    recvd = assertOk(clientManager.decompressMessage(toSend));
+    ASSERT_EQ(memcmp(recvd.buf(), original.buf(), original.size()), 0);
+}
+
+TEST(ZstdMessageCompressor, RejectsUntrainedDictionary) {
+    const std::string rawContent = "not a trained dictionary";
+    ASSERT_NOT_OK(ZstdMessageCompressor::makeWithDictionary(
+                      ConstDataRange(rawContent.data(), rawContent.data() + rawContent.size()))
+                      .getStatus());
+}
+
 TEST(MessageCompressorManager, MessageSizeTooLarge) {
     auto registry = buildRegistry();
     MessageCompressorManager compManager(&registry);
@@ -49,6 +49,9 @@ void appendMessageCompressionStats(BSONObjBuilder* b) {
     for (auto&& name : names) {
         auto&& compressor = registry.getCompressor(name);
         BSONObjBuilder base(compressionSection.subobjStart(name));
+        if (compressor->getDictionaryId()) {
+            base.append("dictionaryId", static_cast<long long>(compressor->getDictionaryId()));
+        }
 
         BSONObjBuilder compressorSection(base.subobjStart("compressor"));
         compressorSection << kBytesIn << compressor->getCompressorBytesIn() << kBytesOut
@@ -31,28 +31,172 @@
 
 #include "mongo/platform/basic.h"
 
+#include <fstream>
+#include <iterator>
+#include <zdict.h>
 #include <zstd.h>
 
 #include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/util/log.h"
 
 namespace mongo {
+namespace {
+
+// A zstd dictionary for compressing messages with peers that were started with the same one.
+// Dictionaries can be trained from traffic recordings with mongotrafficreader --zstdDictionary.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(zstdCompressionDictionaryFile, std::string, "");
+
+// Dictionaries much larger than this stop paying for themselves on small messages.
+const std::size_t kMaxDictionarySize = 1024 * 1024;
+
+/**
+ * Compression contexts kept for every message compressed or decompressed on a thread.
+ * ZSTD_compress() and ZSTD_decompress() allocate and free one on each call.
+ */
+class ThreadContexts {
+public:
+    ~ThreadContexts() {
+        ZSTD_freeCCtx(_compressionContext);
+        ZSTD_freeDCtx(_decompressionContext);
+    }
+
+    ZSTD_CCtx* compressionContext() {
+        if (!_compressionContext)
+            _compressionContext = ZSTD_createCCtx();
+        return _compressionContext;
+    }
+
+    ZSTD_DCtx* decompressionContext() {
+        if (!_decompressionContext)
+            _decompressionContext = ZSTD_createDCtx();
+        return _decompressionContext;
+    }
+
+private:
+    ZSTD_CCtx* _compressionContext = nullptr;
+    ZSTD_DCtx* _decompressionContext = nullptr;
+};
+
+thread_local ThreadContexts threadContexts;
+
+const Status kContextAllocationFailed{ErrorCodes::ExceededMemoryLimit,
+                                      "Could not allocate a zstd context"};
+
+StatusWith<std::string> readDictionaryFile(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return Status(ErrorCodes::FileNotOpen,
+                      str::stream() << "Could not open zstd dictionary file " << path);
+    }
+    std::string dictionary{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (file.bad() || dictionary.empty() || dictionary.size() > kMaxDictionarySize) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "zstd dictionary file " << path
+                                    << " must be readable and between 1 and "
+                                    << kMaxDictionarySize
+                                    << " bytes");
+    }
+    return {std::move(dictionary)};
+}
+
+}  // namespace
 
 ZstdMessageCompressor::ZstdMessageCompressor() : MessageCompressorBase(MessageCompressor::kZstd) {}
 
+ZstdMessageCompressor::~ZstdMessageCompressor() {
+    ZSTD_freeCDict(_compressionDictionary);
+    ZSTD_freeDDict(_decompressionDictionary);
+}
+
+StatusWith<std::unique_ptr<ZstdMessageCompressor>> ZstdMessageCompressor::makeWithDictionary(
+    ConstDataRange dictionary) {
+    const auto dictionaryId = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.length());
+    if (dictionaryId == 0) {
+        return Status(ErrorCodes::BadValue,
+                      "zstd compression dictionaries must be trained dictionaries that have an ID");
+    }
+
+    auto compressor = stdx::make_unique<ZstdMessageCompressor>();
+    compressor->_compressionDictionary =
+        ZSTD_createCDict(dictionary.data(), dictionary.length(), ZSTD_CLEVEL_DEFAULT);
+    compressor->_decompressionDictionary =
+        ZSTD_createDDict(dictionary.data(), dictionary.length());
+    if (!compressor->_compressionDictionary || !compressor->_decompressionDictionary) {
+        return Status(ErrorCodes::BadValue, "Could not load zstd compression dictionary");
+    }
+    compressor->_dictionaryId = dictionaryId;
+    return {std::move(compressor)};
+}
+
+StatusWith<std::string> ZstdMessageCompressor::trainDictionary(
+    const std::vector<ConstDataRange>& samples, std::size_t maxSize) {
+    std::string samplesBuffer;
+    std::vector<size_t> sampleSizes;
+    sampleSizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        samplesBuffer.append(sample.data(), sample.length());
+        sampleSizes.push_back(sample.length());
+    }
+
+    std::string dictionary(maxSize, '\0');
+    size_t ret = ZDICT_trainFromBuffer(&dictionary[0],
+                                       dictionary.size(),
+                                       samplesBuffer.data(),
+                                       sampleSizes.data(),
+                                       sampleSizes.size());
+    if (ZDICT_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not train zstd dictionary: "
+                                    << ZDICT_getErrorName(ret)};
+    }
+    dictionary.resize(ret);
+    return {std::move(dictionary)};
+}
+
 std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
     return ZSTD_compressBound(inputSize);
 }
 
 StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
                                                             DataRange output) {
-    size_t ret = ZSTD_compress(const_cast<char*>(output.data()),
-                               output.length(),
-                               input.data(),
-                               input.length(),
-                               ZSTD_CLEVEL_DEFAULT);
+    auto context = threadContexts.compressionContext();
+    if (!context) {
+        return kContextAllocationFailed;
+    }
+
+    size_t ret = ZSTD_compressCCtx(context,
+                                   const_cast<char*>(output.data()),
+                                   output.length(),
+                                   input.data(),
+                                   input.length(),
+                                   ZSTD_CLEVEL_DEFAULT);
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::compressDataWithDictionary(ConstDataRange input,
+                                                                          DataRange output) {
+    invariant(_compressionDictionary);
+    auto context = threadContexts.compressionContext();
+    if (!context) {
+        return kContextAllocationFailed;
+    }
+
+    size_t ret = ZSTD_compress_usingCDict(context,
+                                          const_cast<char*>(output.data()),
+                                          output.length(),
+                                          input.data(),
+                                          input.length(),
+                                          _compressionDictionary);
 
     if (ZSTD_isError(ret)) {
         return Status{ErrorCodes::BadValue,
@@ -64,8 +208,32 @@ StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input
 
 StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
                                                               DataRange output) {
-    size_t ret = ZSTD_decompress(
-        const_cast<char*>(output.data()), output.length(), input.data(), input.length());
+    auto context = threadContexts.decompressionContext();
+    if (!context) {
+        return kContextAllocationFailed;
+    }
+
+    // Frames compressed with a dictionary name it, so the peer's choice needs no other signal.
+    const auto dictionaryId = ZSTD_getDictID_fromFrame(input.data(), input.length());
+    if (dictionaryId != 0 && dictionaryId != _dictionaryId) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not decompress message: it uses zstd dictionary "
+                                    << dictionaryId
+                                    << ", which is not configured"};
+    }
+
+    size_t ret = dictionaryId == 0
+        ? ZSTD_decompressDCtx(context,
+                              const_cast<char*>(output.data()),
+                              output.length(),
+                              input.data(),
+                              input.length())
+        : ZSTD_decompress_usingDDict(context,
+                                     const_cast<char*>(output.data()),
+                                     output.length(),
+                                     input.data(),
+                                     input.length(),
+                                     _decompressionDictionary);
 
     if (ZSTD_isError(ret)) {
         return Status{ErrorCodes::BadValue,
@@ -82,7 +250,24 @@ MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
                           ("AllCompressorsRegistered"))
 (InitializerContext* context) {
     auto& compressorRegistry = MessageCompressorRegistry::get();
-    compressorRegistry.registerImplementation(stdx::make_unique<ZstdMessageCompressor>());
+    if (zstdCompressionDictionaryFile.empty()) {
+        compressorRegistry.registerImplementation(stdx::make_unique<ZstdMessageCompressor>());
+        return Status::OK();
+    }
+
+    auto swDictionary = readDictionaryFile(zstdCompressionDictionaryFile);
+    if (!swDictionary.isOK()) {
+        return swDictionary.getStatus();
+    }
+    const auto& dictionary = swDictionary.getValue();
+    auto swCompressor = ZstdMessageCompressor::makeWithDictionary(
+        ConstDataRange(dictionary.data(), dictionary.size()));
+    if (!swCompressor.isOK()) {
+        return swCompressor.getStatus();
+    }
+    log() << "Loaded zstd compression dictionary " << swCompressor.getValue()->getDictionaryId()
+          << " from " << zstdCompressionDictionaryFile;
+    compressorRegistry.registerImplementation(std::move(swCompressor.getValue()));
     return Status::OK();
 }
 }  // namespace mongo
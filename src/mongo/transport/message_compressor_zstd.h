@@ -27,18 +27,52 @@
  *    it in the license file.
  */
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "mongo/transport/message_compressor_base.h"
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
 namespace mongo {
 class ZstdMessageCompressor final : public MessageCompressorBase {
 public:
     ZstdMessageCompressor();
+    ~ZstdMessageCompressor();
+
+    /*
+     * Returns a compressor that can also compress and decompress messages with 'dictionary',
+     * which must be a trained zstd dictionary (one that has a dictionary ID).
+     */
+    static StatusWith<std::unique_ptr<ZstdMessageCompressor>> makeWithDictionary(
+        ConstDataRange dictionary);
+
+    /*
+     * Trains a dictionary of at most 'maxSize' bytes from 'samples', which should be the
+     * payloads of typical messages, such as those captured by the traffic recorder.
+     */
+    static StatusWith<std::string> trainDictionary(const std::vector<ConstDataRange>& samples,
+                                                   std::size_t maxSize);
 
     std::size_t getMaxCompressedSize(size_t inputSize) override;
 
     StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
 
     StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+    uint32_t getDictionaryId() const override {
+        return _dictionaryId;
+    }
+
+    StatusWith<std::size_t> compressDataWithDictionary(ConstDataRange input,
+                                                       DataRange output) override;
+
+private:
+    ZSTD_CDict_s* _compressionDictionary = nullptr;
+    ZSTD_DDict_s* _decompressionDictionary = nullptr;
+    uint32_t _dictionaryId = 0;
 };
 
 
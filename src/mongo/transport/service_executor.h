@@ -34,6 +34,7 @@
 #include "mongo/platform/bitwise_enum_operators.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/session_id.h"
 #include "mongo/transport/transport_mode.h"
 #include "mongo/util/duration.h"
 
@@ -82,6 +83,17 @@ public:
      */
     virtual Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) = 0;
 
+    /*
+     * Schedules a task on behalf of the session 'sessionId'. Executors that run all of a session's
+     * tasks on the same thread use 'sessionId' to pick it; others schedule the task as usual.
+     */
+    virtual Status scheduleForSession(Task task,
+                                      ScheduleFlags flags,
+                                      ServiceExecutorTaskName taskName,
+                                      SessionId sessionId) {
+        return schedule(std::move(task), flags, taskName);
+    }
+
     /*
      * Stops and joins the ServiceExecutor. Any outstanding tasks will not be executed, and any
      * associated callbacks waiting on I/O may get called with an error code.
@@ -0,0 +1,388 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_per_core.h"
+
+#include <algorithm>
+
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/transport/service_executor_gen.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
+constexpr auto kTotalStuckWorkersReplaced = "totalStuckWorkersReplaced"_sd;
+constexpr auto kTasksQueued = "tasksQueued"_sd;
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "perCore"_sd;
+
+// How long an idle worker waits before looking for tasks to steal again, if no other worker has
+// asked it to.
+const Milliseconds kIdleStealInterval{50};
+
+// How long the reactor thread runs the reactor before checking whether the executor has stopped.
+const Milliseconds kReactorRunTime{1000};
+
+size_t numWorkersToRun(size_t requested) {
+    if (requested == 0) {
+        requested = static_cast<size_t>(perCoreServiceExecutorThreads);
+    }
+    if (requested == 0) {
+        requested = static_cast<size_t>(std::max(ProcessInfo::getNumAvailableCores(), 1ul));
+    }
+    return requested;
+}
+
+}  // namespace
+
+thread_local ServiceExecutorPerCore* ServiceExecutorPerCore::_localExecutor = nullptr;
+thread_local ServiceExecutorPerCore::Worker* ServiceExecutorPerCore::_localWorker = nullptr;
+thread_local int ServiceExecutorPerCore::_localRecursionDepth = 0;
+
+ServiceExecutorPerCore::ServiceExecutorPerCore(ServiceContext* ctx,
+                                               ReactorHandle reactor,
+                                               size_t numWorkers)
+    : _tickSource(ctx->getTickSource()), _reactorHandle(std::move(reactor)) {
+    numWorkers = numWorkersToRun(numWorkers);
+    _workers.reserve(numWorkers);
+    for (size_t i = 0; i < numWorkers; i++) {
+        _workers.emplace_back(std::make_unique<Worker>());
+    }
+}
+
+ServiceExecutorPerCore::~ServiceExecutorPerCore() {
+    invariant(!_isRunning.load());
+}
+
+Status ServiceExecutorPerCore::start() {
+    invariant(!_isRunning.load());
+    _isRunning.store(true);
+
+    for (size_t i = 0; i < _workers.size(); i++) {
+        _numRunningThreads.addAndFetch(1);
+        Status status = launchServiceWorkerThread([this, i] { _workerThreadRoutine(i, 0); });
+        if (!status.isOK()) {
+            _threadExited();
+            return status;
+        }
+    }
+
+    _numRunningThreads.addAndFetch(1);
+    Status status = launchServiceWorkerThread([this] { _reactorThreadRoutine(); });
+    if (!status.isOK()) {
+        _threadExited();
+        return status;
+    }
+
+    _numRunningThreads.addAndFetch(1);
+    status = launchServiceWorkerThread([this] { _controllerThreadRoutine(); });
+    if (!status.isOK()) {
+        _threadExited();
+    }
+    return status;
+}
+
+Status ServiceExecutorPerCore::shutdown(Milliseconds timeout) {
+    if (!_isRunning.load())
+        return Status::OK();
+
+    LOG(3) << "Shutting down perCore executor";
+
+    _isRunning.store(false);
+    for (auto&& worker : _workers) {
+        stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+        worker->cv.notify_one();
+    }
+    _reactorHandle->stop();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_controllerMutex);
+        _controllerCondition.notify_one();
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_shutdownMutex);
+    bool result = _shutdownCondition.wait_for(lk, timeout.toSystemDuration(), [this] {
+        return _numRunningThreads.load() == 0;
+    });
+
+    return result
+        ? Status::OK()
+        : Status(ErrorCodes::Error::ExceededTimeLimit,
+                 "perCore executor couldn't shutdown all worker threads within time limit.");
+}
+
+Status ServiceExecutorPerCore::schedule(Task task,
+                                        ScheduleFlags flags,
+                                        ServiceExecutorTaskName taskName) {
+    // Tasks scheduled by a worker stay on it. The rest are spread across the workers.
+    Worker* worker = _localExecutor == this
+        ? _localWorker
+        : _workers[_nextWorker.fetchAndAdd(1) % _workers.size()].get();
+    return _schedule(worker, std::move(task), flags);
+}
+
+Status ServiceExecutorPerCore::scheduleForSession(Task task,
+                                                  ScheduleFlags flags,
+                                                  ServiceExecutorTaskName taskName,
+                                                  SessionId sessionId) {
+    return _schedule(_workers[sessionId % _workers.size()].get(), std::move(task), flags);
+}
+
+Status ServiceExecutorPerCore::_schedule(Worker* worker, Task task, ScheduleFlags flags) {
+    if (!_isRunning.load()) {
+        return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    _totalQueued.addAndFetch(1);
+
+    // Run the task now if it is allowed to recurse and we are already on its worker.
+    if ((flags & kMayRecurse) && _localWorker == worker &&
+        _localRecursionDepth < perCoreServiceExecutorRecursionLimit.loadRelaxed()) {
+        ++_localRecursionDepth;
+        task();
+        --_localRecursionDepth;
+        _totalExecuted.addAndFetch(1);
+        return Status::OK();
+    }
+
+    size_t numTasks;
+    {
+        stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+        worker->tasks.emplace_back(std::move(task));
+        numTasks = worker->tasks.size();
+        worker->numTasks.store(numTasks);
+        worker->cv.notify_one();
+    }
+
+    // The worker is falling behind, so have an idle worker come and take some of its tasks.
+    const Milliseconds stuckTimeout{perCoreServiceExecutorStuckTaskTimeoutMillis.loadRelaxed()};
+    if (numTasks >= static_cast<size_t>(perCoreServiceExecutorStealThreshold.loadRelaxed()) ||
+        _isStuck(*worker, stuckTimeout)) {
+        for (auto&& other : _workers) {
+            if (other.get() == worker || !other->idle.load())
+                continue;
+            stdx::lock_guard<stdx::mutex> lk(other->mutex);
+            other->stealRequested = true;
+            other->cv.notify_one();
+            break;
+        }
+    }
+
+    return Status::OK();
+}
+
+bool ServiceExecutorPerCore::_isStuck(const Worker& worker, Milliseconds timeout) {
+    const TickSource::Tick started = worker.taskStarted.load();
+    return started != 0 && _tickSource->ticksTo<Milliseconds>(_tickSource->getTicks() - started) >=
+        timeout;
+}
+
+ServiceExecutor::Task ServiceExecutorPerCore::_steal(Worker* thief) {
+    const size_t threshold = std::max(perCoreServiceExecutorStealThreshold.loadRelaxed(), 1);
+    const Milliseconds stuckTimeout{perCoreServiceExecutorStuckTaskTimeoutMillis.loadRelaxed()};
+
+    // Tasks queued behind a stuck worker may wait for it indefinitely, so they are taken however
+    // few there are.
+    Worker* victim = nullptr;
+    size_t victimTasks = 0;
+    bool victimStuck = false;
+    for (auto&& worker : _workers) {
+        const size_t numTasks = worker->numTasks.load();
+        if (worker.get() == thief || numTasks == 0 || numTasks <= victimTasks)
+            continue;
+        const bool stuck = _isStuck(*worker, stuckTimeout);
+        if (numTasks >= threshold || stuck) {
+            victim = worker.get();
+            victimTasks = numTasks;
+            victimStuck = stuck;
+        }
+    }
+    if (!victim)
+        return nullptr;
+
+    // Take the task that has waited longest, as it contributes the most to tail latency.
+    stdx::lock_guard<stdx::mutex> lk(victim->mutex);
+    if (victim->tasks.empty() || (victim->tasks.size() < threshold && !victimStuck))
+        return nullptr;
+    Task task = std::move(victim->tasks.front());
+    victim->tasks.pop_front();
+    victim->numTasks.store(victim->tasks.size());
+    _totalStolen.addAndFetch(1);
+    return task;
+}
+
+void ServiceExecutorPerCore::_workerThreadRoutine(size_t workerId, unsigned generation) {
+    setThreadName(str::stream() << "worker-" << workerId);
+    LOG(3) << "Started perCore executor worker thread " << workerId;
+
+    Worker* const worker = _workers[workerId].get();
+    _localExecutor = this;
+    _localWorker = worker;
+    const auto guard = makeGuard([this] {
+        _localExecutor = nullptr;
+        _localWorker = nullptr;
+        _threadExited();
+    });
+
+    while (_isRunning.load()) {
+        Task task;
+        {
+            stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+            if (worker->generation != generation)
+                break;
+            if (!worker->tasks.empty()) {
+                task = std::move(worker->tasks.front());
+                worker->tasks.pop_front();
+                worker->numTasks.store(worker->tasks.size());
+            }
+        }
+
+        if (!task) {
+            task = _steal(worker);
+        }
+
+        if (!task) {
+            stdx::unique_lock<stdx::mutex> lk(worker->mutex);
+            worker->idle.store(true);
+            worker->cv.wait_for(lk, kIdleStealInterval.toSystemDuration(), [&] {
+                return !worker->tasks.empty() || worker->stealRequested || !_isRunning.load();
+            });
+            worker->idle.store(false);
+            worker->stealRequested = false;
+            continue;
+        }
+
+        worker->taskStarted.store(_tickSource->getTicks());
+        _localRecursionDepth = 1;
+        task();
+        _totalExecuted.addAndFetch(1);
+
+        // If the controller gave this worker to another thread while the task ran, leave it be.
+        stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+        if (worker->generation != generation)
+            break;
+        worker->taskStarted.store(0);
+    }
+}
+
+void ServiceExecutorPerCore::_reactorThreadRoutine() {
+    setThreadName("worker-reactor"_sd);
+    const auto guard = makeGuard([this] { _threadExited(); });
+
+    while (_isRunning.load()) {
+        _reactorHandle->runFor(kReactorRunTime);
+    }
+}
+
+void ServiceExecutorPerCore::_controllerThreadRoutine() {
+    setThreadName("worker-controller"_sd);
+    const auto guard = makeGuard([this] { _threadExited(); });
+
+    while (_isRunning.load()) {
+        const Milliseconds stuckTimeout{perCoreServiceExecutorStuckTaskTimeoutMillis.load()};
+        {
+            stdx::unique_lock<stdx::mutex> lk(_controllerMutex);
+            _controllerCondition.wait_for(lk, (stuckTimeout / 2).toSystemDuration(), [this] {
+                return !_isRunning.load();
+            });
+        }
+
+        // An idle worker takes the tasks queued behind a stuck one on its own.
+        const bool anyIdle = std::any_of(_workers.begin(), _workers.end(), [](const auto& worker) {
+            return worker->idle.load();
+        });
+        if (!_isRunning.load() || anyIdle)
+            continue;
+
+        for (size_t i = 0; i < _workers.size(); i++) {
+            Worker* const worker = _workers[i].get();
+            unsigned generation;
+            {
+                stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+                if (worker->tasks.empty() || !_isStuck(*worker, stuckTimeout))
+                    continue;
+                generation = ++worker->generation;
+                worker->taskStarted.store(0);
+            }
+
+            log() << "perCore executor worker " << i << " has run one task for over "
+                  << stuckTimeout << " with tasks waiting, starting a thread to take it over";
+            _totalStuckWorkersReplaced.addAndFetch(1);
+            _numRunningThreads.addAndFetch(1);
+            Status status = launchServiceWorkerThread(
+                [this, i, generation] { _workerThreadRoutine(i, generation); });
+            if (!status.isOK()) {
+                warning() << "Failed to start a thread to take over perCore executor worker " << i
+                          << ": " << status;
+                _threadExited();
+                // Hand the worker back to the stuck thread.
+                stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+                if (worker->generation == generation)
+                    worker->generation--;
+            }
+        }
+    }
+}
+
+void ServiceExecutorPerCore::_threadExited() {
+    if (_numRunningThreads.subtractAndFetch(1) == 0) {
+        stdx::lock_guard<stdx::mutex> lk(_shutdownMutex);
+        _shutdownCondition.notify_all();
+    }
+}
+
+void ServiceExecutorPerCore::appendStats(BSONObjBuilder* bob) const {
+    long long tasksQueued = 0;
+    for (auto&& worker : _workers) {
+        tasksQueued += worker->numTasks.load();
+    }
+
+    *bob << kExecutorLabel << kExecutorName                                  //
+         << kTotalQueued << _totalQueued.load()                              //
+         << kTotalExecuted << _totalExecuted.load()                          //
+         << kTotalStolen << _totalStolen.load()                              //
+         << kTotalStuckWorkersReplaced << _totalStuckWorkersReplaced.load()  //
+         << kTasksQueued << tasksQueued                                      //
+         << kThreadsRunning << static_cast<int>(_numRunningThreads.load());
+}
+
+}  // namespace transport
+}  // namespace mongo
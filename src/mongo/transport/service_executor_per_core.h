@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * The per-core service executor runs a fixed number of worker threads, one per core by default,
+ * each with its own queue of tasks. Every session belongs to one worker, which runs all of its
+ * tasks so that the session's state stays in that core's caches. A worker with nothing to do takes
+ * tasks from the busiest other worker's queue once enough of them are waiting there, or as soon as
+ * that worker is stuck running one task.
+ *
+ * A controller thread watches for workers stuck on one task while tasks wait in their queues and
+ * no other worker is idle. It starts a new thread to take over such a worker's queue, and the stuck
+ * thread exits once its task returns.
+ *
+ * Asynchronous networking completes on a single thread running the ingress reactor, which only
+ * hands the completed I/O to the session's worker.
+ */
+class ServiceExecutorPerCore final : public ServiceExecutor {
+public:
+    ServiceExecutorPerCore(ServiceContext* ctx, ReactorHandle reactor, size_t numWorkers = 0);
+    ~ServiceExecutorPerCore();
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) override;
+    Status scheduleForSession(Task task,
+                              ScheduleFlags flags,
+                              ServiceExecutorTaskName taskName,
+                              SessionId sessionId) override;
+
+    Mode transportMode() const override {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+    size_t numWorkers() const {
+        return _workers.size();
+    }
+
+private:
+    struct Worker {
+        stdx::mutex mutex;
+        stdx::condition_variable cv;
+        std::deque<Task> tasks;
+        // Set by another worker to have this one, while idle, look for tasks to steal.
+        bool stealRequested = false;
+        // Bumped when a new thread takes over this worker from a stuck one.
+        unsigned generation = 0;
+
+        // The size of tasks and whether the worker is waiting for one, for other workers to read
+        // without taking the mutex.
+        AtomicWord<size_t> numTasks{0};
+        AtomicWord<bool> idle{false};
+        // When the task the worker is running started, or 0 if it is not running one.
+        AtomicWord<TickSource::Tick> taskStarted{0};
+    };
+
+    Status _schedule(Worker* worker, Task task, ScheduleFlags flags);
+
+    /**
+     * Runs the tasks of worker 'workerId' until the executor stops or another thread takes over
+     * the worker, that is, until its generation is no longer 'generation'.
+     */
+    void _workerThreadRoutine(size_t workerId, unsigned generation);
+    void _reactorThreadRoutine();
+    void _controllerThreadRoutine();
+
+    /**
+     * Whether 'worker' has been running one task for at least 'timeout'.
+     */
+    bool _isStuck(const Worker& worker, Milliseconds timeout);
+
+    /**
+     * Takes the oldest task from the worker with the most tasks waiting, if that is at least
+     * perCoreServiceExecutorStealThreshold or the worker is stuck.
+     */
+    Task _steal(Worker* thief);
+
+    void _threadExited();
+
+    // The executor and worker the current thread runs tasks for, if any.
+    static thread_local ServiceExecutorPerCore* _localExecutor;
+    static thread_local Worker* _localWorker;
+    static thread_local int _localRecursionDepth;
+
+    TickSource* const _tickSource;
+    ReactorHandle _reactorHandle;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    AtomicWord<size_t> _nextWorker{0};
+
+    AtomicWord<bool> _isRunning{false};
+
+    mutable stdx::mutex _shutdownMutex;
+    stdx::condition_variable _shutdownCondition;
+    AtomicWord<size_t> _numRunningThreads{0};
+
+    stdx::mutex _controllerMutex;
+    stdx::condition_variable _controllerCondition;
+
+    // These counters are only used for reporting in serverStatus.
+    AtomicWord<int64_t> _totalQueued{0};
+    AtomicWord<int64_t> _totalExecuted{0};
+    AtomicWord<int64_t> _totalStolen{0};
+    AtomicWord<int64_t> _totalStuckWorkersReplaced{0};
+};
+
+}  // namespace transport
+}  // namespace mongo
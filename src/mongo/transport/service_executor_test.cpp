@@ -35,6 +35,8 @@
 
 #include "mongo/db/service_context.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_gen.h"
+#include "mongo/transport/service_executor_per_core.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/unittest/unittest.h"
@@ -176,6 +178,19 @@ protected:
     std::unique_ptr<ServiceExecutorSynchronous> executor;
 };
 
+class ServiceExecutorPerCoreFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = ServiceContext::make();
+        setGlobalServiceContext(std::move(scOwned));
+
+        executor = stdx::make_unique<ServiceExecutorPerCore>(
+            getGlobalServiceContext(), std::make_shared<ASIOReactor>(), 2);
+    }
+
+    std::unique_ptr<ServiceExecutorPerCore> executor;
+};
+
 void scheduleBasicTask(ServiceExecutor* exec, bool expectSuccess) {
     stdx::condition_variable cond;
     stdx::mutex mutex;
@@ -217,6 +232,147 @@ TEST_F(ServiceExecutorSynchronousFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorPerCoreFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, SessionTasksRunOnOneThread) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    const auto runForSession = [&](SessionId sessionId) {
+        stdx::mutex mutex;
+        stdx::condition_variable cond;
+        boost::optional<stdx::thread::id> threadId;
+        ASSERT_OK(executor->scheduleForSession(
+            [&] {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                threadId = stdx::this_thread::get_id();
+                cond.notify_all();
+            },
+            ServiceExecutor::kEmptyFlags,
+            ServiceExecutorTaskName::kSSMProcessMessage,
+            sessionId));
+
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return threadId.is_initialized(); });
+        return *threadId;
+    };
+
+    const auto firstSessionThread = runForSession(1);
+    for (int i = 0; i < 10; i++) {
+        ASSERT(runForSession(1) == firstSessionThread);
+    }
+    ASSERT(runForSession(2) != firstSessionThread);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, IdleWorkerStealsFromBusyWorker) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    bool blocking = false;
+    bool unblock = false;
+    int stolenTasksRun = 0;
+
+    const auto schedule = [&](ServiceExecutor::Task task) {
+        ASSERT_OK(executor->scheduleForSession(std::move(task),
+                                               ServiceExecutor::kEmptyFlags,
+                                               ServiceExecutorTaskName::kSSMProcessMessage,
+                                               0));
+    };
+
+    // Occupy the worker for session 0 until the test lets it go.
+    schedule([&] {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        blocking = true;
+        cond.notify_all();
+        cond.wait(lk, [&] { return unblock; });
+    });
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return blocking; });
+    }
+
+    // These queue up behind it, so the other worker has to run them.
+    for (int i = 0; i < 2; i++) {
+        schedule([&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            stolenTasksRun++;
+            cond.notify_all();
+        });
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    cond.wait(lk, [&] { return stolenTasksRun >= 1; });
+    unblock = true;
+    cond.notify_all();
+    lk.unlock();
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_GTE(bob.obj()["totalStolen"].numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, StuckWorkersAreTakenOver) {
+    const int stuckTaskTimeoutMillis = perCoreServiceExecutorStuckTaskTimeoutMillis.load();
+    perCoreServiceExecutorStuckTaskTimeoutMillis.store(50);
+    ON_BLOCK_EXIT(
+        [&] { perCoreServiceExecutorStuckTaskTimeoutMillis.store(stuckTaskTimeoutMillis); });
+
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    // Each task blocks until all of them run at once, which needs more threads than the executor's
+    // two workers.
+    const int kNumTasks = 4;
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    int tasksStarted = 0;
+    int tasksUnblocked = 0;
+
+    for (int i = 0; i < kNumTasks; i++) {
+        ASSERT_OK(executor->scheduleForSession(
+            [&] {
+                stdx::unique_lock<stdx::mutex> lk(mutex);
+                tasksStarted++;
+                cond.notify_all();
+                if (cond.wait_for(lk, stdx::chrono::seconds(30), [&] {
+                        return tasksStarted == kNumTasks;
+                    })) {
+                    tasksUnblocked++;
+                    cond.notify_all();
+                }
+            },
+            ServiceExecutor::kEmptyFlags,
+            ServiceExecutorTaskName::kSSMProcessMessage,
+            0));
+    }
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait_for(
+            lk, stdx::chrono::seconds(30), [&] { return tasksStarted == kNumTasks; });
+        ASSERT_EQ(tasksStarted, kNumTasks);
+    }
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_GTE(bob.obj()["totalStuckWorkersReplaced"].numberLong(), 1);
+
+    // Let the tasks finish before shutting down.
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    cond.wait_for(lk, stdx::chrono::seconds(30), [&] { return tasksUnblocked == kNumTasks; });
+    ASSERT_EQ(tasksUnblocked, kNumTasks);
+}
 
 }  // namespace
 }  // namespace mongo
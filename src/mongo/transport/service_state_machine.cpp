@@ -94,6 +94,38 @@ Message makeLegacyExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return Message(b.release());
 }
 
+/**
+ * An oplog 'getMore' reports the commit point its client knows about in
+ * 'lastKnownCommittedOpTime' so that an awaitData wait ends as soon as the commit point moves past
+ * it. By the time a 'getMore' is replayed in an exhaust stream the client has been sent the commit
+ * point in the previous reply's replication metadata, so the replayed request must carry that
+ * commit point. Otherwise every replayed 'getMore' returns immediately with an empty batch.
+ *
+ * Returns true if 'request' was modified.
+ */
+bool advanceLastKnownCommittedOpTime(OpMsgRequest* request, const BSONObj& replyBody) {
+    const StringData kLastKnownCommittedOpTimeFieldName = "lastKnownCommittedOpTime"_sd;
+    if (!request->body.hasField(kLastKnownCommittedOpTimeFieldName)) {
+        return false;
+    }
+
+    auto lastOpCommitted = replyBody.getObjectField("$replData")["lastOpCommitted"];
+    if (lastOpCommitted.type() != Object) {
+        return false;
+    }
+
+    BSONObjBuilder bob;
+    for (auto&& elem : request->body) {
+        if (elem.fieldNameStringData() == kLastKnownCommittedOpTimeFieldName) {
+            bob.appendAs(lastOpCommitted, kLastKnownCommittedOpTimeFieldName);
+        } else {
+            bob.append(elem);
+        }
+    }
+    request->body = bob.obj();
+    return true;
+}
+
 /**
  * Given a request and its already generated response, checks for exhaust flags. If exhaust is
  * allowed, modifies the given request message to produce the subsequent exhaust message, and
@@ -118,16 +150,18 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
         return Message();
     }
 
-    auto reply = OpMsg::parse(dbresponse->response);
+    // Only the top-level fields of the reply are needed, so leave out the documents it
+    // references rather than copying the whole reply into one buffer.
+    const BSONObj replyBody = OpMsg::bodyWithoutSharedObjects(dbresponse->response);
 
     // Check for a non-OK response.
-    auto resOk = reply.body["ok"].number();
+    auto resOk = replyBody["ok"].number();
     if (resOk != 1.0) {
         return Message();
     }
 
     // Check the validity of the 'cursor' object in the response.
-    auto cursorObj = reply.body.getObjectField("cursor");
+    auto cursorObj = replyBody.getObjectField("cursor");
     if (cursorObj.isEmpty()) {
         return Message();
     }
@@ -143,6 +177,11 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
     // Indicate that the response is part of an exhaust stream.
     OpMsg::setFlag(&dbresponse->response, OpMsg::kMoreToCome);
 
+    if (advanceLastKnownCommittedOpTime(&request, replyBody)) {
+        requestMsg = request.serialize();
+        OpMsg::setFlag(&requestMsg, OpMsg::kExhaustSupported);
+    }
+
     // Return an augmented form of the initial request, which is to be used as the next request to
     // be processed by the database. The id of the response is used as the request id of this
     // 'synthetic' request.
@@ -557,7 +596,8 @@ void ServiceStateMachine::_scheduleNextWithGuard(ThreadGuard guard,
         ssm->_runNextInGuard(std::move(guard));
     };
     guard.release();
-    Status status = _serviceExecutor->schedule(std::move(func), flags, taskName);
+    Status status =
+        _serviceExecutor->scheduleForSession(std::move(func), flags, taskName, _session()->id());
     if (status.isOK()) {
         return;
     }
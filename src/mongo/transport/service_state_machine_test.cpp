@@ -75,6 +75,7 @@ public:
         log() << "In handleRequest";
         _ranHandler = true;
         ASSERT_TRUE(haveClient());
+        _lastRequest = request;
 
         // Build out a dummy OK response, if no custom response message was set. Otherwise, use the
         // custom response message.
@@ -115,6 +116,10 @@ public:
         _responseMessage = std::move(m);
     }
 
+    const Message& lastRequest() const {
+        return _lastRequest;
+    }
+
     bool ranHandler() {
         bool ret = _ranHandler;
         _ranHandler = false;
@@ -127,6 +132,9 @@ private:
 
     // A custom response message to return from 'handleRequest'.
     Message _responseMessage;
+
+    // The last request message passed to 'handleRequest'.
+    Message _lastRequest;
 };
 
 using namespace transport;
@@ -477,6 +485,42 @@ TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaust) {
     ASSERT_EQ(firstResponseId, msg.header().getResponseToMsgId());
 }
 
+TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustAdvancesLastKnownCommittedOpTime) {
+    // Construct an oplog 'getMore' OP_MSG request with the exhaust flag set, which reports the
+    // commit point known to the client.
+    const int32_t initRequestId = 1;
+    const long long cursorId = 42;
+    const std::string nss = "local.oplog.rs";
+    const BSONObj initialCommitPoint = BSON("ts" << Timestamp(1, 1) << "t" << 1LL);
+    const BSONObj newCommitPoint = BSON("ts" << Timestamp(2, 1) << "t" << 1LL);
+    Message getMoreWithExhaust =
+        buildOpMsg(BSON("getMore" << cursorId << "collection" << nss << "term" << 1LL
+                                  << "lastKnownCommittedOpTime"
+                                  << initialCommitPoint));
+    getMoreWithExhaust.header().setId(initRequestId);
+    OpMsg::setFlag(&getMoreWithExhaust, OpMsg::kExhaustSupported);
+
+    // Construct a 'getMore' response whose replication metadata reports a newer commit point.
+    BSONObj getMoreResBody =
+        BSON("ok" << 1 << "cursor"
+                  << BSON("id" << cursorId << "ns" << nss << "nextBatch" << BSONArray())
+                  << "$replData"
+                  << BSON("term" << 1LL << "lastOpCommitted" << newCommitPoint));
+    Message getMoreRes = buildOpMsg(getMoreResBody);
+
+    runSourceAndSinkTest(_tl, _sep, getMoreWithExhaust, getMoreRes, State::Process, State::Process);
+    ASSERT(OpMsg::isFlagSet(_tl->getLastSunk(), OpMsg::kMoreToCome));
+
+    // The synthetic 'getMore' should report the commit point the client was just sent.
+    log() << "runNext to process the synthetic exhaust request";
+    _ssm->runNext();
+    auto request = _sep->lastRequest();
+    ASSERT(OpMsg::isFlagSet(request, OpMsg::kExhaustSupported));
+    auto requestBody = OpMsgRequest::parse(request).body;
+    ASSERT_EQ(cursorId, requestBody["getMore"].numberLong());
+    ASSERT_BSONOBJ_EQ(newCommitPoint, requestBody["lastKnownCommittedOpTime"].Obj());
+}
+
 TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustAndEmptyResponseNamespace) {
     // Construct a 'getMore' OP_MSG request with the exhaust flag set.
     const int32_t initRequestId = 1;
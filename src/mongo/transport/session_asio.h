@@ -34,6 +34,7 @@
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/transport_layer_asio.h"
@@ -54,6 +55,10 @@ namespace transport {
 
 MONGO_FAIL_POINT_DEFINE(transportLayerASIOshortOpportunisticReadWrite);
 
+// Sessions read up to this many bytes at a time, so that a message this small usually arrives in
+// one read rather than one for its header and another for its body. 0 reads messages exactly.
+extern AtomicWord<int> transportLayerASIOSpeculativeReadBytes;
+
 template <typename SuccessValue>
 auto futurize(const std::error_code& ec, SuccessValue&& successValue) {
     using Result = Future<std::decay_t<SuccessValue>>;
@@ -140,7 +145,7 @@ public:
     Status sinkMessage(Message message) override {
         ensureSync();
 
-        return write(asio::buffer(message.buf(), message.size()))
+        return writeMessage(message)
             .then([this, &message] {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -151,8 +156,8 @@ public:
 
     Future<void> asyncSinkMessage(Message message, const BatonHandle& baton = nullptr) override {
         ensureAsync();
-        return write(asio::buffer(message.buf(), message.size()), baton)
-            .then([this, message /*keep the buffer alive*/]() {
+        return writeMessage(message, baton)
+            .then([this, message /*keep the buffers alive*/]() {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
                 }
@@ -340,9 +345,37 @@ private:
         return _socket;
     }
 
+    static Status checkMessageLength(size_t msgLen) {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+            StringBuilder sb;
+            sb << "recv(): message msgLen " << msgLen << " is invalid. "
+               << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+            const auto str = sb.str();
+            LOG(0) << str;
+
+            return Status(ErrorCodes::ProtocolError, str);
+        }
+        return Status::OK();
+    }
+
     Future<Message> sourceMessageImpl(const BatonHandle& baton = nullptr) {
         static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
 
+        const size_t speculativeReadBytes = transportLayerASIOSpeculativeReadBytes.load();
+        if (_readAheadSize > 0 || (speculativeReadBytes > 0 && canReadSpeculatively())) {
+            auto buffer = SharedBuffer::allocate(
+                std::max({speculativeReadBytes, size_t(kHeaderSize), _readAheadSize}));
+            const size_t filled = _readAheadSize;
+            if (_readAheadSize > 0) {
+                memcpy(buffer.get(), _readAhead.get(), _readAheadSize);
+                _readAhead = {};
+                _readAheadSize = 0;
+            }
+            return sourceMessageSpeculatively(std::move(buffer), filled, baton);
+        }
+
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
         return read(asio::buffer(ptr, kHeaderSize), baton)
@@ -352,14 +385,9 @@ private:
                 }
 
                 const auto msgLen = size_t(MSGHEADER::View(headerBuffer.get()).getMessageLength());
-                if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
-                    StringBuilder sb;
-                    sb << "recv(): message msgLen " << msgLen << " is invalid. "
-                       << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
-                    const auto str = sb.str();
-                    LOG(0) << str;
-
-                    return Future<Message>::makeReady(Status(ErrorCodes::ProtocolError, str));
+                auto status = checkMessageLength(msgLen);
+                if (!status.isOK()) {
+                    return Future<Message>::makeReady(std::move(status));
                 }
 
                 if (msgLen == kHeaderSize) {
@@ -384,6 +412,84 @@ private:
             });
     }
 
+    /**
+     * Sources a message into 'buffer', which already holds the first 'filled' bytes of it. Until
+     * the header is in, each read asks for as much as the buffer has room for, so a message that
+     * fits arrives with its header. Bytes read past the end of the message are kept for the next
+     * call to sourceMessageImpl().
+     */
+    Future<Message> sourceMessageSpeculatively(SharedBuffer buffer,
+                                               size_t filled,
+                                               const BatonHandle& baton) {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        if (filled < kHeaderSize) {
+            auto ptr = buffer.get() + filled;
+            const auto size = buffer.capacity() - filled;
+            return readSome(asio::buffer(ptr, size), baton)
+                .then([ this, buffer = std::move(buffer), filled, baton ](size_t size) mutable {
+                    return sourceMessageSpeculatively(std::move(buffer), filled + size, baton);
+                });
+        }
+
+        if (checkForHTTPRequest(asio::buffer(buffer.get(), kHeaderSize))) {
+            return sendHTTPResponse(baton);
+        }
+
+        const auto msgLen = size_t(MSGHEADER::View(buffer.get()).getMessageLength());
+        auto status = checkMessageLength(msgLen);
+        if (!status.isOK()) {
+            return Future<Message>::makeReady(std::move(status));
+        }
+
+        if (filled < msgLen) {
+            // The rest of the message did not arrive with its header, so read exactly that.
+            if (msgLen > buffer.capacity()) {
+                buffer.realloc(msgLen);
+            }
+            auto ptr = buffer.get() + filled;
+            return read(asio::buffer(ptr, msgLen - filled), baton)
+                .then([ this, buffer = std::move(buffer), msgLen ]() mutable {
+                    if (_isIngressSession) {
+                        networkCounter.hitPhysicalIn(msgLen);
+                    }
+                    return Message(std::move(buffer));
+                });
+        }
+
+        if (filled > msgLen) {
+            // The peer has already sent the start of its next message.
+            _readAheadSize = filled - msgLen;
+            _readAhead = SharedBuffer::allocate(_readAheadSize);
+            memcpy(_readAhead.get(), buffer.get() + msgLen, _readAheadSize);
+        }
+
+        if (_isIngressSession) {
+            networkCounter.hitPhysicalIn(msgLen);
+        }
+        return Future<Message>::makeReady(Message(std::move(buffer)));
+    }
+
+    bool canReadSpeculatively() const {
+#ifdef MONGO_CONFIG_SSL
+        // The first bytes from an ingress peer decide whether it gets an SSL handshake, which must
+        // be given exactly those bytes.
+        return _ranHandshake;
+#else
+        return true;
+#endif
+    }
+
+    template <typename MutableBufferSequence>
+    Future<size_t> readSome(const MutableBufferSequence& buffers, const BatonHandle& baton) {
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket) {
+            return opportunisticReadSome(*_sslSocket, buffers, baton);
+        }
+#endif
+        return opportunisticReadSome(_socket, buffers, baton);
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers, const BatonHandle& baton = nullptr) {
 #ifdef MONGO_CONFIG_SSL
@@ -409,6 +515,22 @@ private:
         return opportunisticRead(_socket, buffers, baton);
     }
 
+    /**
+     * Writes a segmented message with a single gather write rather than flattening it first.
+     */
+    Future<void> writeMessage(const Message& message, const BatonHandle& baton = nullptr) {
+        if (!message.isSegmented()) {
+            return write(asio::buffer(message.buf(), message.size()), baton);
+        }
+
+        std::vector<asio::const_buffer> buffers;
+        buffers.reserve(message.segments().size());
+        for (const auto& segment : message.segments()) {
+            buffers.emplace_back(segment.data, segment.size);
+        }
+        return write(buffers, baton);
+    }
+
     template <typename ConstBufferSequence>
     Future<void> write(const ConstBufferSequence& buffers, const BatonHandle& baton = nullptr) {
 #ifdef MONGO_CONFIG_SSL
@@ -479,6 +601,36 @@ private:
         }
     }
 
+    template <typename Stream, typename MutableBufferSequence>
+    Future<size_t> opportunisticReadSome(Stream& stream,
+                                         const MutableBufferSequence& buffers,
+                                         const BatonHandle& baton = nullptr) {
+        std::error_code ec;
+        size_t size;
+
+        if (MONGO_FAIL_POINT(transportLayerASIOshortOpportunisticReadWrite) &&
+            _blockingMode == Async) {
+            size = stream.read_some(asio::mutable_buffer(buffers.data(), 1), ec);
+        } else {
+            size = stream.read_some(buffers, ec);
+        }
+
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            if (baton && baton->networking()) {
+                return baton->networking()
+                    ->addSession(*this, NetworkingBaton::Type::In)
+                    .then([&stream, buffers, baton, this] {
+                        return opportunisticReadSome(stream, buffers, baton);
+                    });
+            }
+
+            return stream.async_read_some(buffers, UseFuture{});
+        } else {
+            return futurize(ec, size);
+        }
+    }
+
     /**
      * moreToSend checks the ssl socket after an opportunisticWrite.  If there are still bytes to
      * send, we manually send them off the underlying socket.  Then we hook that up with a future
@@ -520,14 +672,8 @@ private:
 
         if (MONGO_FAIL_POINT(transportLayerASIOshortOpportunisticReadWrite) &&
             _blockingMode == Async) {
-            asio::const_buffer localBuffer = buffers;
-
-            if (buffers.size()) {
-                localBuffer = asio::const_buffer(buffers.data(), 1);
-            }
-
-            size = asio::write(stream, localBuffer, ec);
-            if (!ec && buffers.size() > 1) {
+            size = asio::write(stream, firstByteOf(buffers), ec);
+            if (!ec && asio::buffer_size(buffers) > 1) {
                 ec = asio::error::would_block;
             }
         } else {
@@ -540,10 +686,7 @@ private:
             // asio::write is a loop internally, so some of buffers may have been read into already.
             // So we need to adjust the buffers passed into async_write to be offset by size, if
             // size is > 0.
-            ConstBufferSequence asyncBuffers(buffers);
-            if (size > 0) {
-                asyncBuffers += size;
-            }
+            auto asyncBuffers = size > 0 ? consumeBuffers(buffers, size) : buffers;
 
             if (auto more = moreToSend(stream, asyncBuffers, baton)) {
                 return std::move(*more);
@@ -707,6 +850,10 @@ private:
     bool _ranHandshake = false;
 #endif
 
+    // Bytes read past the end of the last message sourced, which begin the next one.
+    SharedBuffer _readAhead;
+    size_t _readAheadSize = 0;
+
     TransportLayerASIO* const _tl;
     bool _isIngressSession;
 };
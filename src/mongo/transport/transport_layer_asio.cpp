@@ -41,6 +41,7 @@
 
 #include "mongo/base/system_error.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/service_entry_point.h"
@@ -67,6 +68,19 @@ namespace transport {
 
 MONGO_FAIL_POINT_DEFINE(transportLayerASIOasyncConnectTimesOut);
 
+// Sessions read up to this many bytes at a time, so that a message this small usually arrives in
+// one read rather than one for its header and another for its body. 0 reads messages exactly.
+MONGO_EXPORT_SERVER_PARAMETER(transportLayerASIOSpeculativeReadBytes, int, 1024)
+    ->withValidator([](const int& value) {
+        return (value >= 0 && value <= 1024 * 1024)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream() << "transportLayerASIOSpeculativeReadBytes must be between 0 "
+                                      "and 1048576. '"
+                                   << value
+                                   << "' is an invalid setting.");
+    });
+
 class ASIOReactorTimer final : public ReactorTimer {
 public:
     explicit ASIOReactorTimer(asio::io_context& ctx)
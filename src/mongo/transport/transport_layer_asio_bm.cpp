@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Sends every message a session sources straight back to the peer, on a thread per session.
+ */
+class EchoServiceEntryPoint : public ServiceEntryPoint {
+public:
+    ~EchoServiceEntryPoint() {
+        for (auto&& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    void startSession(transport::SessionHandle session) override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _threads.emplace_back([session = std::move(session)] {
+            while (true) {
+                auto swMessage = session->sourceMessage();
+                if (!swMessage.isOK() || !session->sinkMessage(swMessage.getValue()).isOK()) {
+                    return;
+                }
+            }
+        });
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {}
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        return 0;
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+
+private:
+    stdx::mutex _mutex;
+    std::vector<stdx::thread> _threads;
+};
+
+/**
+ * Round trips a request over loopback, with both ends reading 'range(0)' bytes speculatively (0
+ * reads the header and then the body) and a request body padded to 'range(1)' bytes.
+ */
+void BM_LoopbackRoundTrip(benchmark::State& state) {
+    auto speculativeReadBytes =
+        ServerParameterSet::getGlobal()->getMap().find("transportLayerASIOSpeculativeReadBytes");
+    uassertStatusOK(speculativeReadBytes->second->setFromString(std::to_string(state.range(0))));
+
+    EchoServiceEntryPoint sep;
+    ServerGlobalParams params;
+    params.noUnixSocket = true;
+    transport::TransportLayerASIO::Options options(&params);
+    options.port = 0;
+    transport::TransportLayerASIO tla(options, &sep);
+    uassertStatusOK(tla.setup());
+    uassertStatusOK(tla.start());
+
+    auto session = uassertStatusOK(tla.connect(HostAndPort("127.0.0.1", tla.listenerPort()),
+                                               transport::kDisableSSL,
+                                               Milliseconds(10000)));
+
+    const auto request =
+        OpMsg{BSON("ping" << 1 << "padding" << std::string(state.range(1), 'x'))}.serialize();
+    for (auto keepRunning : state) {
+        uassertStatusOK(session->sinkMessage(request));
+        benchmark::DoNotOptimize(uassertStatusOK(session->sourceMessage()));
+    }
+    state.SetBytesProcessed(2 * state.iterations() * request.size());
+
+    session->end();
+    session.reset();
+    tla.shutdown();
+    uassertStatusOK(speculativeReadBytes->second->setFromString("1024"));
+}
+
+BENCHMARK(BM_LoopbackRoundTrip)
+    ->Args({0, 0})
+    ->Args({1024, 0})
+    ->Args({0, 512})
+    ->Args({1024, 512})
+    ->Args({0, 16 * 1024})
+    ->Args({1024, 16 * 1024});
+
+}  // namespace
+}  // namespace mongo
@@ -33,12 +33,14 @@
 #include "mongo/transport/transport_layer_asio.h"
 
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/sock.h"
+#include "mongo/util/scopeguard.h"
 
 #include "asio.hpp"
 
@@ -363,5 +365,81 @@ TEST(TransportLayerASIO, SwitchTimeoutModes) {
     tla->shutdown();
 }
 
+/* check that messages sent back to back, or larger than a speculative read, are sourced intact */
+class SourceMessagesSEP : public TimeoutSEP {
+public:
+    explicit SourceMessagesSEP(size_t count) : _count(count) {}
+
+    void startSession(transport::SessionHandle session) override {
+        stdx::thread([ this, session = std::move(session) ]() mutable {
+            for (size_t i = 0; i < _count; i++) {
+                auto swMessage = session->sourceMessage();
+                ASSERT_OK(swMessage.getStatus());
+                _bodies.push_back(OpMsg::parse(swMessage.getValue()).body.getOwned());
+            }
+
+            session.reset();
+            notifyComplete();
+        }).detach();
+    }
+
+    const std::vector<BSONObj>& bodies() const {
+        return _bodies;
+    }
+
+private:
+    const size_t _count;
+    std::vector<BSONObj> _bodies;
+};
+
+TEST(TransportLayerASIO, SourceMessagesAcrossSpeculativeReads) {
+    auto speculativeReadBytes =
+        ServerParameterSet::getGlobal()->getMap().find("transportLayerASIOSpeculativeReadBytes");
+    ASSERT_OK(speculativeReadBytes->second->setFromString("64"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(speculativeReadBytes->second->setFromString("1024")); });
+
+    const auto makeMessage = [](BSONObj body) {
+        Message msg = OpMsg{body}.serialize();
+        msg.header().setResponseToMsgId(0);
+        msg.header().setId(0);
+        return msg;
+    };
+    std::vector<BSONObj> bodies{BSON("ping" << 1),
+                                BSON("ping" << 2),
+                                BSON("ping" << 3),
+                                BSON("ping" << 4 << "padding" << std::string(1000, 'x'))};
+
+    SourceMessagesSEP sep(bodies.size());
+    auto tla = makeAndStartTL(&sep);
+
+    asio::io_context ctx;
+    asio::ip::tcp::socket sock(ctx);
+    std::error_code ec;
+    sock.connect({asio::ip::address_v4::loopback(), uint16_t(tla->listenerPort())}, ec);
+    ASSERT_FALSE(ec);
+
+    // The first message goes alone. The rest go in one write, so a single read may return the
+    // end of one message along with the start of the next.
+    Message first = makeMessage(bodies[0]);
+    asio::write(sock, asio::buffer(first.buf(), first.size()), ec);
+    ASSERT_FALSE(ec);
+
+    std::string rest;
+    for (size_t i = 1; i < bodies.size(); i++) {
+        Message msg = makeMessage(bodies[i]);
+        rest.append(msg.buf(), msg.size());
+    }
+    asio::write(sock, asio::buffer(rest.data(), rest.size()), ec);
+    ASSERT_FALSE(ec);
+
+    ASSERT_TRUE(sep.waitForTimeout(Milliseconds{10000}));
+    ASSERT_EQ(sep.bodies().size(), bodies.size());
+    for (size_t i = 0; i < bodies.size(); i++) {
+        ASSERT_BSONOBJ_EQ(sep.bodies()[i], bodies[i]);
+    }
+
+    tla->shutdown();
+}
+
 }  // namespace
 }  // namespace mongo
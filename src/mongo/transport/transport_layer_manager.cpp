@@ -36,6 +36,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_per_core.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_asio.h"
@@ -134,7 +135,7 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     auto sep = ctx->getServiceEntryPoint();
 
     transport::TransportLayerASIO::Options opts(config);
-    if (config->serviceExecutor == "adaptive") {
+    if (config->serviceExecutor == "adaptive" || config->serviceExecutor == "perCore") {
         opts.transportMode = transport::Mode::kAsynchronous;
     } else if (config->serviceExecutor == "synchronous") {
         opts.transportMode = transport::Mode::kSynchronous;
@@ -148,6 +149,10 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
         auto reactor = transportLayerASIO->getReactor(TransportLayer::kIngress);
         ctx->setServiceExecutor(
             stdx::make_unique<ServiceExecutorAdaptive>(ctx, std::move(reactor)));
+    } else if (config->serviceExecutor == "perCore") {
+        auto reactor = transportLayerASIO->getReactor(TransportLayer::kIngress);
+        ctx->setServiceExecutor(
+            stdx::make_unique<ServiceExecutorPerCore>(ctx, std::move(reactor)));
     } else if (config->serviceExecutor == "synchronous") {
         ctx->setServiceExecutor(stdx::make_unique<ServiceExecutorSynchronous>(ctx));
     }
@@ -42,6 +42,7 @@
 #endif
 
 #include "mongo/platform/basic.h"
+#include "mongo/platform/simd_scan.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -120,15 +121,21 @@ inline int leadingOnes(unsigned char c) {
 
 bool isValidUTF8(StringData s) {
     int left = 0;  // how many bytes are left in the current codepoint
-    for (unsigned char c : s) {
+    const char* const end = s.rawData() + s.size();
+    for (const char* it = s.rawData(); it != end; ++it) {
+        if (!left) {
+            // Skip ahead over runs of ASCII, which is all that most strings contain.
+            it = simd_scan::findNonAscii(it, end);
+            if (it == end)
+                break;
+        }
+        const unsigned char c = *it;
         const int ones = leadingOnes(c);
         if (left) {
             if (ones != 1)
                 return false;  // should be a continuation byte
             left--;
         } else {
-            if (ones == 0)
-                continue;  // ASCII byte
             if (ones == 1)
                 return false;  // unexpected continuation byte
             if (c > 0xF4)